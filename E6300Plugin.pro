@@ -1,3 +1,5 @@
 TEMPLATE = subdirs
 
-SUBDIRS += E6300TestPlugin
+SUBDIRS += E6300TestPlugin rfmu2lib rfmu2cli
+
+rfmu2cli.depends = rfmu2lib
@@ -14,45 +14,52 @@ HEADERS += \
     collapsiblegroupbox.h \
     colorpickerwidget.h \
     connectdialog.h \
+    exportworker.h \
     include/frequencyspinbox.h \
     include/qcustomplot.h \
-    include/rfmu2/rfmu2_error.h \
-    include/rfmu2/rfmu2base.h \
-    include/rfmu2/rfmu2networkanalyzer.h \
-    include/rfmu2/rfmu2signalgenerator.h \
-    include/rfmu2/rfmu2spectrumanalyzer.h \
-    include/rfmu2/rfmu2systemcontrol.h \
-    include/rfmu2/rfmu2tool.h \
     logging.h \
+    logsink.h \
+    logview.h \
     mainwindow.h \
     marker.h \
     nawidget.h \
+    portscandialog.h \
+    renderscheduler.h \
     rrsucalibdialog.h \
     sawidget.h \
-    sgstepworker.h \
+    scalarsweepdialog.h \
     sgwidget.h \
-    stepsweepdialog.h
+    statspanel.h \
+    stepsweepdialog.h \
+    sweephistorypanel.h \
+    telemetrypanel.h \
+    tracedecimator.h
 
 SOURCES += \
     collapsiblegroupbox.cpp \
     colorpickerwidget.cpp \
     connectdialog.cpp \
+    exportworker.cpp \
     include/frequencyspinbox.cpp \
     include/qcustomplot.cpp \
-    include/rfmu2/rfmu2base.cpp \
-    include/rfmu2/rfmu2networkanalyzer.cpp \
-    include/rfmu2/rfmu2signalgenerator.cpp \
-    include/rfmu2/rfmu2spectrumanalyzer.cpp \
-    include/rfmu2/rfmu2systemcontrol.cpp \
-    include/rfmu2/rfmu2tool.cpp \
+    logsink.cpp \
+    logview.cpp \
     mainwindow.cpp \
     marker.cpp \
     nawidget.cpp \
+    portscandialog.cpp \
+    renderscheduler.cpp \
     rrsucalibdialog.cpp \
     sawidget.cpp \
-    sgstepworker.cpp \
+    scalarsweepdialog.cpp \
     sgwidget.cpp \
-    stepsweepdialog.cpp
+    statspanel.cpp \
+    stepsweepdialog.cpp \
+    sweephistorypanel.cpp \
+    telemetrypanel.cpp \
+    tracedecimator.cpp
+
+include(include/rfmu2/rfmu2.pri)
 
 DISTFILES += E6300Plugin.json
 
@@ -1,7 +1,10 @@
 #include "e6300plugin.h"
 #include "mainwindow.h"
+#include "logsink.h"
 
+#include <QDateTime>
 #include <QVBoxLayout>
+#include <cmath>
 
 static char UNIQUE_HEX_CHAR[256] = "yP8)T2KJ|Ge%@}1U~jvb?m5!ow^QSi4`[dF=czYp,q>t\"H\\7NrkEBM9LCnZV*#;R&AL(s_3a:I+W/X$fX0M[>&LBA_N\"3kh'c58VzqlVNO0-W:9T=mx-#iYub.Xc7H1d#GOp3;ymDQnuCV=G&;Rjl6'1F24B9g5[PQhI7sw%zA)vW,xDKM^S0Eqrt*neEroaRUZM-i]1[J)rTGp&gA\"#>DkWxs9tHV,lY7N3_z/L8mCQ+57jf]hbI{v<&0y;4XZ";
 
@@ -20,6 +23,10 @@ E6300Plugin::E6300Plugin()
 
 E6300Plugin::~E6300Plugin()
 {
+    // The sink goes with the window, so nothing of ours outlives the plugin
+    if (LogSink *sink = LogSink::instance())
+        sink->setBatchHandler({});
+
     if (m_mainWindow) {
         if (m_mainWindow->isVisible()) {
             m_mainWindow->close();
@@ -113,6 +120,7 @@ QMainWindow* E6300Plugin::createAndGetPluginWin(const QString paraNIC, int slot,
         // m_mainWindow->setCentralWidget(myCentralWidget);
 
         m_mainWindow = new MainWindow;
+        applyLogCallback();     // the host may have set it before the window existed
 
         result = "Plugin window created successfully.";
     } else {
@@ -138,6 +146,8 @@ bool E6300Plugin::setLogCallback(E6300PluginLogCallback callback)
     return false;
 #else
     m_logCallback = callback;
+    applyLogCallback();
+
     if (m_logCallback) {
         m_logCallback("Log callback set successfully.");
         return true;
@@ -159,6 +169,25 @@ E6300InstrumentStat E6300Plugin::getInstrumentCurrentStatus()
 
     return E6300InstrumentStat::Error;
 #else
+    // Polled by the host: a copy of the I/O layer's latest snapshot, never
+    // a request to the instrument.
+    Rfmu2Tool *rfmu = tool();
+    if (!rfmu)
+        return E6300InstrumentStat::Disconnected;
+
+    const Rfmu2Status st = rfmu->status();
+    switch (st.link) {
+    case Rfmu2Status::Link::Disconnected:
+        return E6300InstrumentStat::Disconnected;
+    case Rfmu2Status::Link::Reconnecting:
+        return E6300InstrumentStat::Error;
+    case Rfmu2Status::Link::Connected:
+        break;
+    }
+    if (st.faulted)
+        return E6300InstrumentStat::Error;
+    if (st.busy || st.queued > 0)
+        return E6300InstrumentStat::Busy;
     return E6300InstrumentStat::Actionable;
 #endif
 }
@@ -183,7 +212,59 @@ QJsonObject E6300Plugin::getInstrumentInfo()
     return errInfo;
 #else
     QJsonObject info;
-    info["Test info"] = "An instrument info.";
+    Rfmu2Tool *rfmu = tool();
+    if (!rfmu) {
+        info["Error detail"] = "Plugin window not created.";
+        return info;
+    }
+
+    const Rfmu2Status st = rfmu->status();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    static const char *const linkNames[] = { "Disconnected", "Connected", "Reconnecting" };
+
+    info["Instrument"] = "RFMU2";
+    info["Link"] = linkNames[int(st.link)];
+    info["Host"] = st.hostName();
+    info["Port"] = st.port;
+    info["Busy"] = st.busy;
+    info["QueuedJobs"] = st.queued;
+    info["Faulted"] = st.faulted;
+    info["CompletedJobs"] = double(st.jobs);
+    info["ErrorCount"] = double(st.errors);
+    if (st.lastErrorCode >= 0) {
+        info["LastError"] = st.lastErrorText();
+        info["LastErrorAgeMs"] = double(now - st.lastErrorMs);
+    }
+    if (st.latencyUs >= 0) {
+        info["LatencyUs"] = double(st.latencyUs);
+        info["LastLatencyUs"] = double(st.lastLatencyUs);
+    }
+    if (!std::isnan(st.temperatureC)) {
+        info["TemperatureC"] = st.temperatureC;
+        info["TemperatureAgeMs"] = double(now - st.temperatureMs);
+    }
+    info["SnapshotAgeMs"] = double(now - st.updatedMs);
+    if (auto *win = qobject_cast<MainWindow *>(m_mainWindow.data()))
+        info["Metrics"] = win->metricsJson();
     return info;
 #endif
 }
+
+void E6300Plugin::applyLogCallback()
+{
+    // Every log line from the plugin, in batches of up to one flush interval.
+    // The sink belongs to the window; without one there is nothing to hook.
+    LogSink *sink = LogSink::instance();
+    if (!sink)
+        return;
+    const E6300PluginLogCallback callback = m_logCallback;
+    sink->setBatchHandler(callback
+        ? std::function<void(const QString &)>([callback](const QString &lines) { callback(lines); })
+        : std::function<void(const QString &)>());
+}
+
+Rfmu2Tool *E6300Plugin::tool() const
+{
+    auto *win = qobject_cast<MainWindow *>(m_mainWindow.data());
+    return win ? win->tool() : nullptr;
+}
@@ -5,9 +5,12 @@
 #include <QObject>
 #include <QMainWindow>
 #include <QJsonObject>
+#include <QPointer>
 #include "sgwidget.h"
 #include "sawidget.h"
 
+class Rfmu2Tool;
+
 class E6300Plugin : public QObject, public E6300Plugin_Interface
 {
     Q_OBJECT
@@ -30,8 +33,11 @@ public:
     QJsonObject getInstrumentInfo() override;
 
 private:
+    Rfmu2Tool *tool() const;    // null until the window exists
+    void applyLogCallback();    // hand m_logCallback to the window's log sink
+
     E6300PluginLogCallback m_logCallback = nullptr;
-    QMainWindow* m_mainWindow = nullptr;
+    QPointer<QMainWindow> m_mainWindow;     // the host may close and delete it
 };
 
 #endif // E6300PLUGIN_H
@@ -0,0 +1,21 @@
+#include "exportworker.h"
+
+void ExportWorker::writeTouchstone(const QString &path, const Rfmu2SParameters &data, bool version2)
+{
+    QString error;
+    const bool ok = Rfmu2TouchstoneWriter::writeFile(
+        path, data,
+        version2 ? Rfmu2TouchstoneWriter::Version::V2_0 : Rfmu2TouchstoneWriter::Version::V1_1,
+        &error);
+    emit exportFinished(path, ok, error);
+}
+
+void ExportWorker::writeTraceFile(const QString &path, const Rfmu2TraceFile::Contents &contents, bool compress)
+{
+    QString error;
+    const bool ok = Rfmu2TraceFile::write(
+        path, contents,
+        compress ? Rfmu2TraceFile::Encoding::DeltaPacked : Rfmu2TraceFile::Encoding::Raw,
+        &error);
+    emit exportFinished(path, ok, error);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include "include/rfmu2/rfmu2touchstone.h"
+#include "include/rfmu2/rfmu2tracefile.h"
+
+/*! Writes export files on its own thread so formatting and disk I/O never
+ *  stall acquisition or plotting. Jobs arrive as queued slot calls and are
+ *  processed in order; every job reports back through exportFinished().   */
+class ExportWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ExportWorker(QObject *parent = nullptr) : QObject(parent) {}
+
+signals:
+    void exportFinished(const QString &path, bool ok, const QString &error);
+
+public slots:
+    void writeTouchstone(const QString &path, const Rfmu2SParameters &data, bool version2);
+    void writeTraceFile(const QString &path, const Rfmu2TraceFile::Contents &contents, bool compress);
+};
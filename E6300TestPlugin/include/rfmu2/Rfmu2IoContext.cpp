@@ -1,87 +1,309 @@
 #include "Rfmu2IoContext.h"
-
-/*  ---- forward declarations for the low‑level helpers  ----
-    Real headers will be included once those classes are converted to the new
-    non‑blocking API in Steps 3‑4.                                            */
 #include "rfmu2networkanalyzer.h"
 #include "rfmu2spectrumanalyzer.h"
 #include "rfmu2signalgenerator.h"
 #include "rfmu2systemcontrol.h"
+#include "rfmu2scalaranalyzer.h"
+#include "rfmu2sweepscheduler.h"
+
+#include <QDateTime>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
 
 // ────────────────────────────────────────────────────────────────────────────
 Rfmu2IoContext::Rfmu2IoContext(QObject *parent)
     : QObject(parent)
 {
-    /* 1) Wire socket signals to self so we can forward them to the GUI. */
-    connect(&m_socket, &QTcpSocket::connected,
-            this,        &Rfmu2IoContext::onSocketConnected);
-    connect(&m_socket, &QTcpSocket::disconnected,
-            this,        &Rfmu2IoContext::onSocketDisconnected);
-    connect(&m_socket, &QTcpSocket::errorOccurred,
-            this,        &Rfmu2IoContext::onSocketError);
-
-    /* 2) Instantiate helpers – they all share the same QTcpSocket. */
-    m_na  = std::make_unique<Rfmu2NetworkAnalyzer>(&m_socket, this);
-    m_sa  = std::make_unique<Rfmu2SpectrumAnalyzer>(&m_socket, this);
-    m_sg  = std::make_unique<Rfmu2SignalGenerator>(&m_socket, this);
-    m_sys = std::make_unique<Rfmu2SystemControl>(&m_socket, this);
-
-    /* 3) Re‑emit their finished/error signals so the upper layer can listen
-          to only one object (this).  We’ll tighten the overloads later.     */
-    // Example – real signal names will be adjusted in Step 4
-    connect(m_na.get(),  &Rfmu2NetworkAnalyzer::finished,
-            this,        &Rfmu2IoContext::finished);
-    connect(m_sa.get(),  &Rfmu2SpectrumAnalyzer::finished,
-            this,        &Rfmu2IoContext::finished);
-    connect(m_sg.get(),  &Rfmu2SignalGenerator::finished,
-            this,        &Rfmu2IoContext::finished);
-    connect(m_sys.get(), &Rfmu2SystemControl::finished,
-            this,        &Rfmu2IoContext::finished);
+    /* 1) Socket and helpers are children, so moveToThread() takes them along. */
+    m_socket = new QTcpSocket(this);
+    m_na  = new Rfmu2NetworkAnalyzer(m_socket, this);
+    m_sa  = new Rfmu2SpectrumAnalyzer(m_socket, this);
+    m_sg  = new Rfmu2SignalGenerator(m_socket, this);
+    m_sys = new Rfmu2SystemControl(m_socket, this);
+    m_scalar = new Rfmu2ScalarAnalyzer(m_socket, m_sg, this);
+    m_sweeps = new Rfmu2SweepScheduler(this, m_sg);
+
+    for (Rfmu2Base *m : std::initializer_list<Rfmu2Base*>{ m_na, m_sa, m_sg, m_sys, m_scalar }) {
+        m->setLatencyStats(&m_latency);
+        m->setMetrics(&m_metrics);
+        connect(m, &Rfmu2Base::errorOccurred, this, &Rfmu2IoContext::onModuleError);
+    }
+    connect(m_sys, &Rfmu2SystemControl::telemetryRead, this, &Rfmu2IoContext::onTelemetryRead);
+
+    /* 2) Track the link state so other threads can query it without
+          touching the socket.                                             */
+    connect(m_socket, &QAbstractSocket::stateChanged,
+            this,     &Rfmu2IoContext::onSocketStateChanged);
+
+    /* 3) Reconnect backoff */
+    m_reconnectTimer = new QTimer(this);
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &Rfmu2IoContext::tryReconnect);
 }
 
 Rfmu2IoContext::~Rfmu2IoContext() = default;
 
-// ───────────────────────── façade slots ─────────────────────────────────────
-void Rfmu2IoContext::connectToHost(const QHostAddress &address, quint16 port)
+bool Rfmu2IoContext::isIoThread() const
 {
-    if (m_socket.state() != QAbstractSocket::UnconnectedState)
-        m_socket.abort();                     // cancel previous attempt
+    return QThread::currentThread() == thread();
+}
 
-    m_socket.connectToHost(address, port);
+// ───────────────────────── request queue ────────────────────────────────────
+void Rfmu2IoContext::post(Rfmu2Priority priority, Job job)
+{
+    bool schedule = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_queues[int(priority)].push_back(std::move(job));
+        schedule = !m_drainScheduled;
+        m_drainScheduled = true;
+    }
+    if (schedule)
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
 }
 
-void Rfmu2IoContext::disconnectFromHost()
+int Rfmu2IoContext::pendingJobs(Rfmu2Priority priority) const
 {
-    m_socket.disconnectFromHost();
+    QMutexLocker lock(&m_mutex);
+    return int(m_queues[int(priority)].size());
 }
 
-// Placeholder high‑level commands – will be expanded in Step 4
-void Rfmu2IoContext::performNetworkSweep()
+bool Rfmu2IoContext::takeNext(Job &job, Rfmu2Priority &priority)
 {
-    if (!m_na)
-        return;
-    /* TODO: schedule sweep parameters once non‑blocking NA API exists. */
+    QMutexLocker lock(&m_mutex);
+
+    int pick = -1;
+    for (int p = 0; p < PriorityCount; ++p) {
+        if (!m_queues[p].empty()) { pick = p; break; }
+    }
+    if (pick < 0)
+        return false;
+
+    // Starvation guard: a lower class that has been passed over often enough
+    // jumps the queue once. The lowest-numbered such class goes first.
+    for (int p = pick + 1; p < PriorityCount; ++p) {
+        if (!m_queues[p].empty() && m_bypassed[p] >= StarvationLimit) {
+            pick = p;
+            break;
+        }
+    }
+
+    for (int p = 0; p < PriorityCount; ++p) {
+        if (p == pick)
+            m_bypassed[p] = 0;
+        else if (p > pick && !m_queues[p].empty())
+            ++m_bypassed[p];
+    }
+
+    job = std::move(m_queues[pick].front());
+    m_queues[pick].pop_front();
+    priority = Rfmu2Priority(pick);
+
+    int queued = 0;
+    for (const auto &q : m_queues)
+        queued += int(q.size());
+    m_status.queued = queued;
+    return true;
 }
 
-void Rfmu2IoContext::performSpectrumScan()
+void Rfmu2IoContext::drain()
 {
-    if (!m_sa)
-        return;
-    /* TODO: schedule scan parameters once non‑blocking SA API exists.  */
+    if (m_running)
+        return; // re-entered from a nested event loop; the outer drain() reschedules
+
+    // One job per pass, so socket signals are delivered between requests.
+    Job job;
+    Rfmu2Priority priority = Rfmu2Priority::Interactive;
+    const bool ran = takeNext(job, priority);
+    if (ran) {
+        m_jobErrors = 0;
+        m_status.busy = true;
+        publishStatus();
+
+        const bool background = (priority == Rfmu2Priority::Telemetry);
+        for (Rfmu2Base *m : std::initializer_list<Rfmu2Base*>{ m_na, m_sa, m_sg, m_sys, m_scalar })
+            m->setBackground(background);
+
+        m_running = true;
+        job();
+        m_running = false;
+    }
+
+    bool more = false;
+    int queued = 0;
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const auto &q : m_queues)
+            queued += int(q.size());
+        more = queued > 0;
+        m_drainScheduled = more;
+    }
+
+    if (ran) {
+        m_status.busy    = false;
+        m_status.faulted = m_jobErrors > 0;
+        m_status.queued  = queued;
+        ++m_status.jobs;
+        m_status.latencyUs     = m_latency.smoothedFirstByteUs();
+        m_status.lastLatencyUs = m_latency.lastFirstByteUs();
+        publishStatus();
+    }
+
+    if (more)
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
 }
 
 // ────────────────────── socket signal handlers ─────────────────────────────
-void Rfmu2IoContext::onSocketConnected()
+void Rfmu2IoContext::onSocketStateChanged(QAbstractSocket::SocketState state)
 {
-    emit connected();
+    const bool connected = (state == QAbstractSocket::ConnectedState);
+
+    // Reconnect bookkeeping first, so linkLost() reaches listeners ahead of
+    // connectionStateChanged(false) and they can tell the two cases apart.
+    if (m_sessionActive) {
+        if (state == QAbstractSocket::UnconnectedState) {
+            if (!m_linkDown.exchange(true, std::memory_order_acq_rel)) {
+                m_status.link = Rfmu2Status::Link::Reconnecting;
+                m_sys->forgetRRSUSession();
+                publishStatus();
+                emit linkLost();
+            }
+            scheduleReconnect();
+        } else if (connected && isLinkDown()) {
+            restoreLink();
+        }
+    }
+
+    if (m_connected.exchange(connected, std::memory_order_acq_rel) != connected) {
+        m_status.link = connected ? Rfmu2Status::Link::Connected
+                      : isLinkDown() ? Rfmu2Status::Link::Reconnecting
+                                     : Rfmu2Status::Link::Disconnected;
+        publishStatus();
+        emit connectionStateChanged(connected);
+    }
+}
+
+// ───────────────────────── status ───────────────────────────────────────────
+void Rfmu2IoContext::onModuleError(const Rfmu2Error &error)
+{
+    ++m_jobErrors;
+    ++m_status.errors;
+    m_status.lastErrorCode = int(error.code);
+    m_status.lastErrorMs   = QDateTime::currentMSecsSinceEpoch();
+    m_status.setLastError(error.text);
+    publishStatus();
 }
 
-void Rfmu2IoContext::onSocketDisconnected()
+void Rfmu2IoContext::onTelemetryRead(const QVector<double> &values)
 {
-    emit disconnected();
+    if (values.size() < 9)
+        return;
+    m_status.temperatureC  = values[8];
+    m_status.temperatureMs = QDateTime::currentMSecsSinceEpoch();
+    publishStatus();
 }
 
-void Rfmu2IoContext::onSocketError(QAbstractSocket::SocketError e)
+void Rfmu2IoContext::publishStatus()
 {
-    emit errorOccurred(e, m_socket.errorString());
+    m_status.updatedMs = QDateTime::currentMSecsSinceEpoch();
+    m_statusBoard.publish(m_status);
+}
+
+// ───────────────────────── reconnect ────────────────────────────────────────
+void Rfmu2IoContext::beginSession(const QString &host, quint16 port)
+{
+    m_host = host;
+    m_port = port;
+    m_sessionActive = true;
+    m_reconnectAttempt = 0;
+    m_reconnectTimer->stop();
+    m_linkDown.store(false, std::memory_order_release);
+
+    for (Rfmu2Base *m : std::initializer_list<Rfmu2Base*>{ m_na, m_sa, m_sg, m_sys, m_scalar })
+        m->clearAppliedState();
+    // The protocol has no serial or firmware query, so the endpoint is the
+    // closest thing to an instrument identity the RRSU upload cache can use;
+    // that is why its entries only count when the user trusts them
+    m_sys->setInstrumentIdentity(QStringLiteral("%1:%2").arg(host).arg(port));
+
+    m_status.setHost(host);
+    m_status.port = port;
+    m_status.link = Rfmu2Status::Link::Connected;
+    m_status.faulted = false;
+    publishStatus();
+}
+
+void Rfmu2IoContext::endSession()
+{
+    m_sessionActive = false;
+    m_reconnectAttempt = 0;
+    m_reconnectTimer->stop();
+    m_linkDown.store(false, std::memory_order_release);
+
+    if (m_status.link == Rfmu2Status::Link::Reconnecting) {
+        m_status.link = Rfmu2Status::Link::Disconnected;
+        publishStatus();
+    }
+}
+
+void Rfmu2IoContext::scheduleReconnect()
+{
+    if (!m_sessionActive || m_reconnectTimer->isActive())
+        return;
+
+    const int delayMs = qMin(ReconnectMaxMs, ReconnectBaseMs << qMin(m_reconnectAttempt, 5));
+    ++m_reconnectAttempt;
+    emit reconnecting(m_reconnectAttempt, delayMs);
+    m_reconnectTimer->start(delayMs);
+}
+
+void Rfmu2IoContext::tryReconnect()
+{
+    if (!m_sessionActive || m_socket->state() != QAbstractSocket::UnconnectedState)
+        return;
+
+    // Asynchronous: success lands in onSocketStateChanged(), failure drops
+    // back to UnconnectedState and schedules the next attempt from there.
+    const int attempt = m_reconnectAttempt;
+    m_socket->connectToHost(m_host, m_port);
+
+    // An unreachable host can keep a connect pending far longer than the backoff
+    QTimer::singleShot(ConnectTimeoutMs, this, [this, attempt]() {
+        const auto state = m_socket->state();
+        if (m_sessionActive && m_reconnectAttempt == attempt
+            && (state == QAbstractSocket::HostLookupState || state == QAbstractSocket::ConnectingState))
+            m_socket->abort();
+    });
+}
+
+void Rfmu2IoContext::restoreLink()
+{
+    m_reconnectTimer->stop();
+
+    // Replay goes to the very front of the queue: whatever was queued while
+    // the link was down expects the instrument in its configured state.
+    Job replay = [this]() {
+        if (m_socket->state() != QAbstractSocket::ConnectedState)
+            return;     // dropped again; the reconnect loop carries on
+
+        bool ok = true;
+        for (Rfmu2Base *m : std::initializer_list<Rfmu2Base*>{ m_sys, m_na, m_sg })
+            ok = m->replayAppliedState() && ok;
+
+        m_reconnectAttempt = 0;
+        m_linkDown.store(false, std::memory_order_release);
+        emit linkRestored(ok);
+    };
+
+    bool schedule = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_queues[int(Rfmu2Priority::Interactive)].push_front(std::move(replay));
+        schedule = !m_drainScheduled;
+        m_drainScheduled = true;
+    }
+    if (schedule)
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
 }
@@ -2,67 +2,151 @@
 /****************************************************************************
 **  Rfmu2IoContext – lives *exclusively* in the I/O thread.
 **
-**  Owns the QTcpSocket and all four low‑level instrument helpers, exposing
-**  *slot‑only* façade methods so that the GUI thread can talk to it through
-**  queued signal/slot connections.
+**  Owns the QTcpSocket, the instrument modules and the SG sweep
+**  scheduler (all children of the context, so they move to the I/O thread
+**  with it) and runs every request that touches them. Requests are queued
+**  from any thread with post() and executed one at a time, in priority
+**  order:
+**
+**      Interactive  – user-triggered configuration, calibration, connect
+**      Streaming    – sweeps feeding the live plots
+**      Telemetry    – background housekeeping reads
+**
+**  A class that keeps being bypassed by higher-priority work is served after
+**  StarvationLimit jobs, so a busy sweep loop cannot lock out telemetry and
+**  a burst of clicks cannot stall the plots indefinitely.
+**
+**  Between beginSession() and endSession() a dropped link is re-established
+**  on its own: connection attempts back off from ReconnectBaseMs to
+**  ReconnectMaxMs, and once through, the settings each module remembers
+**  (Rfmu2Base::replayAppliedState) are sent again before any queued job.
+**
+**  Link state, queue activity, the last error, latency and the last
+**  temperature reading are published to a status board as they change;
+**  any thread can read the latest snapshot without waiting on the queue.
 ****************************************************************************/
 
+#include "rfmu2_error.h"
+#include "rfmu2latencystats.h"
+#include "rfmu2metrics.h"
+#include "rfmu2status.h"
 #include <QObject>
+#include <QMutex>
 #include <QTcpSocket>
-#include <QHostAddress>
-#include <memory>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <deque>
+#include <functional>
 
 class Rfmu2NetworkAnalyzer;
 class Rfmu2SpectrumAnalyzer;
 class Rfmu2SignalGenerator;
 class Rfmu2SystemControl;
+class Rfmu2ScalarAnalyzer;
+class Rfmu2SweepScheduler;
+class QTimer;
+
+enum class Rfmu2Priority : int {
+    Interactive = 0,
+    Streaming   = 1,
+    Telemetry   = 2
+};
 
 class Rfmu2IoContext : public QObject
 {
     Q_OBJECT
 public:
+    using Job = std::function<void()>;
+
+    static constexpr int PriorityCount   = 3;
+    static constexpr int StarvationLimit = 8;   // bypasses before a waiting class gets a turn
+    static constexpr int ReconnectBaseMs  = 250;
+    static constexpr int ReconnectMaxMs   = 8000;
+    static constexpr int ConnectTimeoutMs = 2000;
+
     explicit Rfmu2IoContext(QObject *parent = nullptr);
     ~Rfmu2IoContext() override;
 
-    // Read‑only accessors (no direct mutating calls from outside the thread)
-    Rfmu2NetworkAnalyzer *networkAnalyzer()   const { return m_na.get(); }
-    Rfmu2SpectrumAnalyzer *spectrumAnalyzer() const { return m_sa.get(); }
-    Rfmu2SignalGenerator *signalGenerator()   const { return m_sg.get(); }
-    Rfmu2SystemControl  *systemControl()      const { return m_sys.get(); }
+    // Only to be dereferenced from jobs running on the I/O thread.
+    QTcpSocket            *socket()           const { return m_socket; }
+    Rfmu2NetworkAnalyzer  *networkAnalyzer()  const { return m_na; }
+    Rfmu2SpectrumAnalyzer *spectrumAnalyzer() const { return m_sa; }
+    Rfmu2SignalGenerator  *signalGenerator()  const { return m_sg; }
+    Rfmu2SystemControl    *systemControl()    const { return m_sys; }
+    Rfmu2ScalarAnalyzer   *scalarAnalyzer()   const { return m_scalar; }
+    Rfmu2SweepScheduler   *sweepScheduler()   const { return m_sweeps; }
+
+    /* ----- thread-safe ----- */
+    void post(Rfmu2Priority priority, Job job);
+    int pendingJobs(Rfmu2Priority priority) const;
+    bool isConnected() const noexcept { return m_connected.load(std::memory_order_acquire); }
+    bool isIoThread() const;
+    bool isLinkDown() const noexcept { return m_linkDown.load(std::memory_order_acquire); }
+    Rfmu2Status status() const { return m_statusBoard.read(); }
+    // Transport counters and round-trip times; readable from any thread
+    const Rfmu2Metrics &metrics() const noexcept { return m_metrics; }
+
+    /* ----- I/O thread only ----- */
+    // Start keeping the link to host:port up. Forgets the applied state of
+    // the previous session.
+    void beginSession(const QString &host, quint16 port);
+    // A disconnect from here on is intended: no reconnect.
+    void endSession();
 
 signals:
-    /* -------- socket‑level state -------- */
-    void connected();
-    void disconnected();
-    void errorOccurred(QAbstractSocket::SocketError code, const QString &text);
-
-    /* -------- high‑level operations --------
-       Each long‑running async call will eventually emit its own “finished(…)”
-       signal from the relevant instrument helper.  We *re‑emit* them here so
-       the GUI only needs to connect to one object (Rfmu2Tool later).          */
-    void finished(const QString &tag);
-
-public slots:
-    /* ----- façade API: only *slots*, so calls from the GUI are automatically
-           queued when IoContext lives on a worker thread.                   */
-    void connectToHost(const QHostAddress &address, quint16 port);
-    void disconnectFromHost();
-
-    /* Examples of higher‑level requests.  Concrete argument lists will be
-       fleshed out in Step 4 when the instrument classes become non‑blocking. */
-    void performNetworkSweep(/* sweep parameters TBD */);
-    void performSpectrumScan(/* scan parameters TBD */);
+    /* -------- socket-level state (emitted on the I/O thread) -------- */
+    void connectionStateChanged(bool connected);
+
+    /* -------- automatic reconnect (emitted on the I/O thread) -------- */
+    void linkLost();
+    void reconnecting(int attempt, int delayMs);
+    void linkRestored(bool stateReplayed);
 
 private slots:
-    /* Internal wiring for the socket */
-    void onSocketConnected();
-    void onSocketDisconnected();
-    void onSocketError(QAbstractSocket::SocketError e);
+    void drain();
+    void onSocketStateChanged(QAbstractSocket::SocketState state);
+    void onModuleError(const Rfmu2Error &error);
+    void onTelemetryRead(const QVector<double> &values);
 
 private:
-    QTcpSocket m_socket;   ///< lives entirely in this thread
-    std::unique_ptr<Rfmu2NetworkAnalyzer>   m_na;
-    std::unique_ptr<Rfmu2SpectrumAnalyzer>  m_sa;
-    std::unique_ptr<Rfmu2SignalGenerator>   m_sg;
-    std::unique_ptr<Rfmu2SystemControl>     m_sys;
+    bool takeNext(Job &job, Rfmu2Priority &priority);
+    void scheduleReconnect();
+    void tryReconnect();
+    void restoreLink();
+    void publishStatus();
+
+    QTcpSocket            *m_socket = nullptr;   ///< lives entirely in the I/O thread
+    Rfmu2NetworkAnalyzer  *m_na     = nullptr;
+    Rfmu2SpectrumAnalyzer *m_sa     = nullptr;
+    Rfmu2SignalGenerator  *m_sg     = nullptr;
+    Rfmu2SystemControl    *m_sys    = nullptr;
+    Rfmu2ScalarAnalyzer   *m_scalar = nullptr;
+    Rfmu2SweepScheduler   *m_sweeps = nullptr;
+    Rfmu2Metrics           m_metrics;             // one link, so one set of histograms for all modules
+    Rfmu2LatencyStats      m_latency { m_metrics };  // deadlines from those histograms
+
+    mutable QMutex   m_mutex;                     // guards the queues and m_drainScheduled
+    std::deque<Job>  m_queues[PriorityCount];
+    int              m_bypassed[PriorityCount] = {};
+    bool             m_drainScheduled = false;
+
+    // Module reads spin a nested QEventLoop while waiting for a frame; a
+    // queued drain() delivered inside it must not start a second job.
+    bool             m_running = false;
+
+    std::atomic<bool> m_connected {false};
+
+    // reconnect state, I/O thread only
+    QString  m_host;
+    quint16  m_port = 0;
+    bool     m_sessionActive = false;
+    int      m_reconnectAttempt = 0;
+    QTimer  *m_reconnectTimer = nullptr;
+    std::atomic<bool> m_linkDown {false};
+
+    // status, written on the I/O thread only
+    Rfmu2Status      m_status;
+    Rfmu2StatusBoard m_statusBoard;
+    int              m_jobErrors = 0;             // errors reported by the running job
 };
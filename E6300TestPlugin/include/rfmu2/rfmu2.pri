@@ -0,0 +1,47 @@
+# Protocol layer: instrument modules, I/O thread, sequencer and file formats.
+# Needs only QtCore and QtNetwork; shared by the GUI, rfmu2lib and rfmu2cli.
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/Rfmu2IoContext.h \
+    $$PWD/rfmu2_error.h \
+    $$PWD/rfmu2base.h \
+    $$PWD/rfmu2latencystats.h \
+    $$PWD/rfmu2metrics.h \
+    $$PWD/rfmu2networkanalyzer.h \
+    $$PWD/rfmu2scalaranalyzer.h \
+    $$PWD/rfmu2sequencer.h \
+    $$PWD/rfmu2signalgenerator.h \
+    $$PWD/rfmu2spectrumanalyzer.h \
+    $$PWD/rfmu2status.h \
+    $$PWD/rfmu2sweephistory.h \
+    $$PWD/rfmu2sweepscheduler.h \
+    $$PWD/rfmu2systemcontrol.h \
+    $$PWD/rfmu2telemetrylog.h \
+    $$PWD/rfmu2telemetrypoller.h \
+    $$PWD/rfmu2tool.h \
+    $$PWD/rfmu2touchstone.h \
+    $$PWD/rfmu2trace.h \
+    $$PWD/rfmu2tracefile.h
+
+SOURCES += \
+    $$PWD/Rfmu2IoContext.cpp \
+    $$PWD/rfmu2base.cpp \
+    $$PWD/rfmu2latencystats.cpp \
+    $$PWD/rfmu2metrics.cpp \
+    $$PWD/rfmu2networkanalyzer.cpp \
+    $$PWD/rfmu2scalaranalyzer.cpp \
+    $$PWD/rfmu2sequencer.cpp \
+    $$PWD/rfmu2signalgenerator.cpp \
+    $$PWD/rfmu2spectrumanalyzer.cpp \
+    $$PWD/rfmu2status.cpp \
+    $$PWD/rfmu2sweephistory.cpp \
+    $$PWD/rfmu2sweepscheduler.cpp \
+    $$PWD/rfmu2systemcontrol.cpp \
+    $$PWD/rfmu2telemetrylog.cpp \
+    $$PWD/rfmu2telemetrypoller.cpp \
+    $$PWD/rfmu2tool.cpp \
+    $$PWD/rfmu2touchstone.cpp \
+    $$PWD/rfmu2trace.cpp \
+    $$PWD/rfmu2tracefile.cpp
@@ -13,5 +13,6 @@ enum class Rfmu2Err {
 struct Rfmu2Error {
     Rfmu2Err code {};
     QString  text;
+    bool     background = false;   // raised by a Telemetry-priority job
 };
 Q_DECLARE_METATYPE(Rfmu2Error)
@@ -1,5 +1,7 @@
 #include "rfmu2base.h"
 #include "rfmu2_error.h"
+#include "rfmu2latencystats.h"
+#include "rfmu2metrics.h"
 #include <QDebug>
 #include <QEventLoop>
 #include <QTimer>
@@ -16,7 +18,7 @@ static const int _rfmu2_error_metatype_id =
 [[nodiscard]] bool Rfmu2Base::fail(Rfmu2Err code, QStringView msg) noexcept
 {
     qWarning() << "[Rfmu2Base]" << msg;
-    emit errorOccurred(Rfmu2Error{code, msg.toString()});
+    emit errorOccurred(Rfmu2Error{code, msg.toString(), m_background});
     return false;
 }
 
@@ -28,18 +30,174 @@ Rfmu2Base::Rfmu2Base(QTcpSocket* socket, QObject* parent)
 // ---------------- send/echo helper ----------------
 bool Rfmu2Base::sendAndEcho(const QByteArray &cmd, int timeoutMs)
 {
-    if (!sendCommand(cmd))
+    QByteArray echo = transact(cmd, timeoutMs);
+    if (echo.isEmpty())
         return false; // fail() already emitted
 
-    QByteArray echo = receiveResponse(timeoutMs);
     if (echo != cmd)
         return fail(Rfmu2Err::Protocol, QStringLiteral("Unexpected echo frame"));
 
     return true;
 }
 
+// ---------------- applied-state shadow ----------------
+bool Rfmu2Base::applyState(int slot, const QByteArray &cmd)
+{
+    if (isApplied(slot, cmd))
+        return true;    // already in effect, no round trip
+
+    if (!sendAndEcho(cmd)) {
+        m_stale.insert(slot);
+        return false;
+    }
+    m_applied.insert(slot, cmd);
+    m_stale.remove(slot);
+    return true;
+}
+
+bool Rfmu2Base::applyStates(const QVector<QPair<int, QByteArray>> &settings)
+{
+    QVector<int> slotIds;
+    QVector<QByteArray> frames;
+    for (const auto &s : settings) {
+        if (s.second.isEmpty())
+            return fail(Rfmu2Err::InternalLogic, QStringLiteral("Invalid setting"));
+        if (!isApplied(s.first, s.second)) {
+            slotIds.append(s.first);
+            frames.append(s.second);
+        }
+    }
+    if (frames.isEmpty())
+        return true;
+    if (frames.size() == 1)
+        return applyState(slotIds.first(), frames.first());
+
+    // Window = everything: settings are small and executed in arrival order
+    const QVector<QByteArray> echoes = transactPipelined(frames, frames.size());
+
+    bool ok = true;
+    for (int i = 0; i < frames.size(); ++i) {
+        if (i < echoes.size() && echoes[i] == frames[i]) {
+            m_applied.insert(slotIds[i], frames[i]);
+            m_stale.remove(slotIds[i]);
+        } else {
+            m_stale.insert(slotIds[i]);
+            ok = false;
+        }
+    }
+    if (!ok && echoes.size() == frames.size())
+        return fail(Rfmu2Err::Protocol, QStringLiteral("Unexpected echo frame"));
+    return ok;  // a missing echo already failed inside transactPipelined()
+}
+
+void Rfmu2Base::invalidateAppliedState()
+{
+    for (auto it = m_applied.cbegin(); it != m_applied.cend(); ++it)
+        m_stale.insert(it.key());
+}
+
+bool Rfmu2Base::replayAppliedState()
+{
+    const QMap<int, QByteArray> applied = m_applied;
+    for (auto it = applied.cbegin(); it != applied.cend(); ++it) {
+        if (!sendAndEcho(it.value()))
+            return false;
+        m_stale.remove(it.key());
+    }
+    return true;
+}
+
+// ---------------- transact ----------------
+QByteArray Rfmu2Base::transact(const QByteArray &cmd, int timeoutMs)
+{
+    Rfmu2TraceSpan span("transact");
+    const quint32 key = Rfmu2LatencyStats::commandKey(cmd);
+    const bool adaptive = (timeoutMs < 0 && m_latency);
+    const int attempts = (adaptive && isIdempotent(cmd)) ? 1 + MaxRetries : 1;
+
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        // Also drops a late answer to an earlier attempt that has landed
+        // since; one still on its way is dropped before the next command.
+        discardStaleInput();
+        if (!sendCommand(cmd))
+            return {};  // fail() already emitted
+
+        const bool last = (attempt + 1 == attempts);
+        const int waitMs = !adaptive ? (timeoutMs < 0 ? m_timeoutMs : timeoutMs)
+                                     : (last ? m_timeoutMs : m_latency->deadlineMs(key, m_timeoutMs));
+
+        if (attempt > 0 && m_metrics)
+            m_metrics->addRetry();
+
+        qint64 firstByteNs = 0;
+        QByteArray resp = readOneFrame(waitMs, &firstByteNs);
+        if (resp.isEmpty()) {
+            // A lost attempt only counts as a timeout; its wait is not a
+            // latency sample, or every loss would raise later deadlines.
+            if (m_metrics)
+                m_metrics->addTimeout();
+            if (!last)
+                qWarning() << "[Rfmu2Base] no response within" << waitMs << "ms, retrying"
+                           << cmd.left(7).toHex(' ');
+            continue;
+        }
+
+        // Timed from the attempt that was answered
+        const qint64 totalUs = m_requestClock.nsecsElapsed() / 1000;
+        if (m_metrics)
+            m_metrics->recordResponse(key, firstByteNs / 1000, totalUs, int(resp.size()));
+        if (m_latency)
+            m_latency->record(firstByteNs / 1000, totalUs, int(resp.size()));
+        return resp;
+    }
+
+    fail(Rfmu2Err::Timeout, QStringLiteral("No response to command %1")
+                                .arg(QString::fromLatin1(cmd.mid(4, 3).toHex(' '))));
+    return {};
+}
+
+void Rfmu2Base::discardStaleInput()
+{
+    if (m_socket && m_socket->bytesAvailable() > 0)
+        appendIncoming(m_socket->readAll());
+    if (!m_incomingBuffer.isEmpty()) {
+        qWarning() << "[Rfmu2Base] discarding" << m_incomingBuffer.size() << "stale bytes";
+        if (m_metrics)
+            m_metrics->addStaleBytes(int(m_incomingBuffer.size()));
+        m_incomingBuffer.clear();
+    }
+}
+
+bool Rfmu2Base::isIdempotent(const QByteArray &cmd)
+{
+    const quint32 key = Rfmu2LatencyStats::commandKey(cmd);
+    if (key == 0)
+        return false;                           // RRSU upload and other foreign frames
+
+    const quint8 function = quint8(key >> 16);
+    switch (function) {
+    case 0x01: case 0x03:                       // SG single / two-tone settings
+    case 0x08: case 0x09:                       // SG outputs off
+    case 0x05: case 0x06: case 0x21:            // SA peak / raw / IQ reads
+    case 0x19: case 0x20:                       // clock reference, voltage read
+        return true;
+    case 0x07: {                                // NA: everything but calibration steps and sweeps
+        const quint8 mode = quint8(key >> 8);
+        const quint8 sub  = quint8(key);
+        if (mode == 0x03)                       // sweep configuration
+            return true;
+        // A measure's cost follows the configured points and ports, which
+        // the key does not see: a deadline learned on a short sweep would
+        // resend a healthy long one. It waits the full timeout instead.
+        return sub != 0x01 && sub != 0x02;
+    }
+    default:
+        return false;
+    }
+}
+
 // ---------------- sendCommand ----------------
-bool Rfmu2Base::sendCommand(const QByteArray &cmd)
+bool Rfmu2Base::sendCommand(const QByteArray &cmd, int frames)
 {
     if (cmd.isEmpty())
         return fail(Rfmu2Err::InternalLogic, QStringLiteral("Command is empty"));
@@ -53,6 +211,8 @@ bool Rfmu2Base::sendCommand(const QByteArray &cmd)
     if (!m_socket->isWritable())
         return fail(Rfmu2Err::TcpWriteFail, QStringLiteral("Socket not writable"));
 
+    Rfmu2TraceSpan span("sendCommand");
+
     const qint64 totalBytes = cmd.size();
     qint64 bytesSent = 0;
     const char *dataPtr = cmd.constData();
@@ -72,6 +232,32 @@ bool Rfmu2Base::sendCommand(const QByteArray &cmd)
         }
     }
     qDebug() << "command sent:" << cmd.toHex(' ');
+    m_requestClock.start();
+    if (m_metrics)
+        m_metrics->addCommands(frames, int(totalBytes));
+    return true;
+}
+
+bool Rfmu2Base::streamCommand(const QByteArray &frame, qint64 maxBuffered)
+{
+    if (!m_socket)
+        return fail(Rfmu2Err::InternalLogic, QStringLiteral("Socket pointer null"));
+
+    if (m_socket->state() != QAbstractSocket::ConnectedState)
+        return fail(Rfmu2Err::TcpWriteFail, QStringLiteral("Socket not connected"));
+
+    // QTcpSocket buffers the whole frame; the kernel drains it meanwhile
+    if (m_socket->write(frame) != frame.size())
+        return fail(Rfmu2Err::TcpWriteFail, QStringLiteral("write() failed"));
+
+    while (m_socket->bytesToWrite() > maxBuffered) {
+        if (!m_socket->waitForBytesWritten(m_timeoutMs))
+            return fail(Rfmu2Err::Timeout, QStringLiteral("waitForBytesWritten timeout"));
+    }
+
+    m_requestClock.start();
+    if (m_metrics)
+        m_metrics->addCommands(1, int(frame.size()));
     return true;
 }
 
@@ -83,9 +269,13 @@ QByteArray Rfmu2Base::receiveResponse(int timeoutMs)
 }
 
 // ---------------- readOneFrame ----------------
-QByteArray Rfmu2Base::readOneFrame(int timeoutMs)
+QByteArray Rfmu2Base::readOneFrame(int timeoutMs, qint64 *firstByteNs)
 {
+    Rfmu2TraceSpan span("readFrame");   // ends when the frame is complete
+    bool sawFirstByte = !m_incomingBuffer.isEmpty();
     QByteArray completeFrame;
+    if (firstByteNs)
+        *firstByteNs = m_incomingBuffer.isEmpty() ? -1 : m_requestClock.nsecsElapsed();
 
     // Maybe we already have leftover data from a previous call.
     completeFrame = tryExtractFrameFromBuffer();
@@ -102,8 +292,15 @@ QByteArray Rfmu2Base::readOneFrame(int timeoutMs)
     QMetaObject::Connection readConn = connect(m_socket, &QTcpSocket::readyRead,
                                                &loop, [&]()
                                                {
+                                                   if (firstByteNs && *firstByteNs < 0)
+                                                       *firstByteNs = m_requestClock.nsecsElapsed();
+                                                   if (!sawFirstByte) {
+                                                       sawFirstByte = true;
+                                                       Rfmu2Trace::instant("firstByte");
+                                                   }
+
                                                    // Append all newly available data
-                                                   m_incomingBuffer.append(m_socket->readAll());
+                                                   appendIncoming(m_socket->readAll());
 
                                                    // Attempt to parse a complete frame from the updated buffer
                                                    QByteArray candidate = tryExtractFrameFromBuffer();
@@ -126,6 +323,67 @@ QByteArray Rfmu2Base::readOneFrame(int timeoutMs)
     return completeFrame;
 }
 
+// ---------------- transactPipelined ----------------
+QVector<QByteArray> Rfmu2Base::transactPipelined(const QVector<QByteArray> &frames,
+                                                 int window, int timeoutMs)
+{
+    Rfmu2TraceSpan span("transactPipelined");
+    QVector<QByteArray> responses;
+    responses.reserve(frames.size());
+    window = qMax(1, window);
+    discardStaleInput();
+
+    // Round trips overlap here, so each one runs from its own frame's write
+    QElapsedTimer clock;
+    clock.start();
+    QVector<qint64> sentAtNs;
+    sentAtNs.reserve(frames.size());
+
+    int sent = 0;
+    while (responses.size() < frames.size()) {
+        // Top the window up with a single write
+        QByteArray batch;
+        const int batchStart = sent;
+        while (sent < frames.size() && sent - responses.size() < window)
+            batch.append(frames[sent++]);
+        if (!batch.isEmpty()) {
+            if (!sendCommand(batch, sent - batchStart))
+                break;  // fail() already emitted
+            sentAtNs.insert(sentAtNs.size(), sent - batchStart, clock.nsecsElapsed());
+        }
+
+        QByteArray resp = receiveResponse(timeoutMs);
+        if (resp.isEmpty()) {
+            if (m_metrics)
+                m_metrics->addTimeout();
+            fail(Rfmu2Err::Timeout,
+                 QStringLiteral("No response to pipelined frame %1").arg(responses.size()));
+            break;
+        }
+        if (m_metrics)
+            m_metrics->recordRtt(Rfmu2LatencyStats::commandKey(frames[responses.size()]),
+                                 (clock.nsecsElapsed() - sentAtNs[responses.size()]) / 1000);
+        responses.append(resp);
+    }
+
+    if (responses.size() < sent) {
+        // Answers to frames still in flight would be taken for the next request's
+        if (m_socket)
+            appendIncoming(m_socket->readAll());
+        if (m_metrics)
+            m_metrics->addStaleBytes(int(m_incomingBuffer.size()));
+        m_incomingBuffer.clear();
+    }
+    return responses;
+}
+
+void Rfmu2Base::appendIncoming(const QByteArray &bytes)
+{
+    m_incomingBuffer.append(bytes);
+    if (m_metrics)
+        m_metrics->addBytesIn(int(bytes.size()));
+}
+
 // ---------------- tryExtractFrameFromBuffer ----------------
 QByteArray Rfmu2Base::tryExtractFrameFromBuffer()
 {
@@ -145,6 +403,8 @@ QByteArray Rfmu2Base::tryExtractFrameFromBuffer()
     // to keep the buffer in sync.
     if (headerIndex > 0) {
         m_incomingBuffer.remove(0, headerIndex);
+        if (m_metrics)
+            m_metrics->addResync(headerIndex);
     }
 
     // Now the buffer starts with the header. We need at least:
@@ -217,13 +477,14 @@ QByteArray Rfmu2Base::tryExtractFrameFromBuffer()
 
     // Attempt 1-byte length parse
     QByteArray frame = parseWithLengthField(1);
-    if (!frame.isEmpty()) {
-        return frame; // success
-    }
 
     // If 1-byte parse fails, try 2-byte length parse
-    frame = parseWithLengthField(2);
+    if (frame.isEmpty())
+        frame = parseWithLengthField(2);
+
     if (!frame.isEmpty()) {
+        if (m_metrics)
+            m_metrics->addFrameParsed();
         return frame; // success
     }
 
@@ -306,6 +567,7 @@ QByteArray Rfmu2Base::int16ToBytes(int value, bool bigEndian)
 // ---------------- bytesToDoubleVector ----------------
 QVector<double> Rfmu2Base::bytesToDoubleVector(const QByteArray &bytes)
 {
+    Rfmu2TraceSpan span("decode");
     QVector<double> result;
     const int sz = bytes.size();
     if (sz % static_cast<int>(sizeof(double)) != 0) {
@@ -323,6 +585,7 @@ QVector<double> Rfmu2Base::bytesToDoubleVector(const QByteArray &bytes)
 
 QVector<double> Rfmu2Base::bytesToDoubleVector_BE(const QByteArray& bytes)
 {
+    Rfmu2TraceSpan span("decode");
     QVector<double> result;
     const int sz = bytes.size();
     if (sz % static_cast<int>(sizeof(double)) != 0) {
@@ -7,9 +7,14 @@
 #include <QString>
 #include <QTcpSocket>
 #include <QMap>
+#include <QSet>
 #include <QStringView>
 #include <QElapsedTimer>
 #include "rfmu2_error.h"
+#include "rfmu2trace.h"
+
+class Rfmu2LatencyStats;
+class Rfmu2Metrics;
 
 class Rfmu2Base : public QObject
 {
@@ -25,6 +30,7 @@ public:
     static constexpr int TAIL_SIZE         = 3;
     static constexpr quint32 FrameHeaderValue = 0xAA55AAu;
     static constexpr quint32 FrameTailValue   = 0x55AA55u;
+    static constexpr int MaxRetries           = 2;   // extra attempts for idempotent commands
 
     explicit Rfmu2Base(QTcpSocket* socket, QObject* parent = nullptr);
     ~Rfmu2Base() override = default;
@@ -32,7 +38,30 @@ public:
     // high-level helpers
     [[nodiscard]] bool sendAndEcho(const QByteArray& cmd, int timeoutMs = -1);
 
+    // Fixed timeout; with latency stats attached it is the ceiling for the
+    // adaptive deadline and the wait of the last attempt.
     void setTimeoutMs(int ms) { m_timeoutMs = ms; }
+    void setLatencyStats(Rfmu2LatencyStats *stats) { m_latency = stats; }
+    void setMetrics(Rfmu2Metrics *metrics) { m_metrics = metrics; }
+    // Errors raised meanwhile are marked background (housekeeping reads)
+    void setBackground(bool on) { m_background = on; }
+
+    // Safe to send again when the answer went missing: reads and absolute
+    // settings, not calibration steps or uploads.
+    static bool isIdempotent(const QByteArray &cmd);
+
+    // Settings that persist on the instrument are remembered per slot once
+    // acknowledged (see applyState()). After the link was re-established
+    // replayAppliedState() sends them again, lowest slot first.
+    bool replayAppliedState();
+    void clearAppliedState() { m_applied.clear(); m_stale.clear(); }
+
+    // The instrument may have changed settings on its own (e.g. a stored
+    // state was loaded): keep the values for replay, but send the next
+    // setting of every slot even if it looks unchanged.
+    void invalidateAppliedState();
+    bool isApplied(int slot, const QByteArray &cmd) const
+    { return !m_stale.contains(slot) && m_applied.value(slot) == cmd; }
 
     // Static helper functions
     static QPair<qint8,qint8> splitDoubleAtDecimal(double value);
@@ -55,13 +84,52 @@ protected:
     // unified failure helper
     [[nodiscard]] bool fail(Rfmu2Err code, QStringView msg) noexcept;
 
-    bool sendCommand(const QByteArray &frame);            // internal send
+    // internal send; `frames` is how many commands are in the write
+    bool sendCommand(const QByteArray &frame, int frames = 1);
+
+    // Bulk variant for frames the device does not answer: no per-frame log,
+    // and it only blocks while more than `maxBuffered` bytes are still
+    // waiting in the socket, so consecutive frames keep the link busy.
+    bool streamCommand(const QByteArray &frame, qint64 maxBuffered);
     QByteArray receiveResponse(int timeoutMs = -1);
 
-    QByteArray readOneFrame(int timeoutMs);
+    // Send one command and wait for its response. Without an explicit
+    // timeout the deadline comes from the latency stats; an idempotent
+    // command that gets no answer in time is sent again (up to MaxRetries),
+    // the last attempt waiting the full fixed timeout. A late answer to an
+    // earlier attempt is not waited for; it is dropped as stale input.
+    QByteArray transact(const QByteArray &cmd, int timeoutMs = -1);
+
+    // Drop whatever is buffered or waiting on the socket: in strict
+    // request/response order nothing may arrive before we have asked.
+    void discardStaleInput();
+
+    QByteArray readOneFrame(int timeoutMs, qint64 *firstByteNs = nullptr);
+
+    // sendAndEcho() unless cmd is already in effect for slot; on success
+    // cmd becomes the shadow of slot, on failure the slot is unknown.
+    bool applyState(int slot, const QByteArray &cmd);
+
+    // Several settings at once: the ones not already in effect go out in a
+    // single pipelined write and are acknowledged together.
+    bool applyStates(const QVector<QPair<int, QByteArray>> &settings);
+
+    // Request/response with up to `window` frames outstanding: the next
+    // frames go out while earlier responses are still on the wire. Returns
+    // one response per frame, in order; truncated at the first frame that
+    // gets no answer, after which unread input is dropped.
+    QVector<QByteArray> transactPipelined(const QVector<QByteArray> &frames,
+                                          int window, int timeoutMs = -1);
     QTcpSocket* m_socket = nullptr;
     int m_timeoutMs      = 5000;
+    Rfmu2LatencyStats *m_latency = nullptr;  // shared by all modules on the socket
+    Rfmu2Metrics      *m_metrics = nullptr;  // likewise
+    bool m_background = false;
+    QElapsedTimer m_requestClock;            // restarted when a command has been written
+    QMap<int, QByteArray> m_applied;         // last acknowledged setting per slot
+    QSet<int> m_stale;                       // slots whose device value is unknown
 
     QByteArray m_incomingBuffer; // persistent buffer for partial data
+    void appendIncoming(const QByteArray &bytes);   // counts the bytes in
     QByteArray tryExtractFrameFromBuffer();
 };
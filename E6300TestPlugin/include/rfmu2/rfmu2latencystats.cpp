@@ -0,0 +1,63 @@
+#include "rfmu2latencystats.h"
+#include "rfmu2base.h"
+#include "rfmu2metrics.h"
+#include <cmath>
+
+static constexpr int    kRateMinBytes    = 4096;   // smaller frames say nothing about throughput
+static constexpr double kRateAlpha       = 0.2;
+static constexpr double kLatencyAlpha    = 0.1;
+
+quint32 Rfmu2LatencyStats::commandKey(const QByteArray &frame)
+{
+    // header(3) length(1) function(1) ...
+    if (frame.size() < 7 || frame.left(3) != Rfmu2Base::int24ToBytes(Rfmu2Base::FrameHeaderValue))
+        return 0;
+
+    const quint8 function = quint8(frame[4]);
+    quint32 key = quint32(function) << 16 | 0x01000000u;
+    if (function == 0x07)                                   // NA: mode + sub-function
+        key |= quint32(quint8(frame[5])) << 8 | quint8(frame[6]);
+    return key;
+}
+
+void Rfmu2LatencyStats::record(qint64 firstByteUs, qint64 totalUs, int responseBytes)
+{
+    m_lastFirstByteUs = firstByteUs;
+    m_smoothedFirstByteUs = (m_smoothedFirstByteUs < 0.0)
+        ? double(firstByteUs)
+        : (1.0 - kLatencyAlpha) * m_smoothedFirstByteUs + kLatencyAlpha * double(firstByteUs);
+
+    const qint64 transferUs = totalUs - firstByteUs;
+    if (responseBytes >= kRateMinBytes && transferUs > 0) {
+        const double rate = double(responseBytes) / double(transferUs);
+        m_bytesPerUs = (m_bytesPerUs == 0.0) ? rate
+                                             : (1.0 - kRateAlpha) * m_bytesPerUs + kRateAlpha * rate;
+    }
+}
+
+int Rfmu2LatencyStats::samples(quint32 key) const
+{
+    const auto times = m_metrics.commandTimes(key);
+    return times ? int(times->firstByte.count()) : 0;
+}
+
+qint64 Rfmu2LatencyStats::quantileUs(quint32 key, double q) const
+{
+    const auto times = m_metrics.commandTimes(key);
+    return times ? times->firstByte.quantileUs(q) : -1;
+}
+
+int Rfmu2LatencyStats::deadlineMs(quint32 key, int ceilingMs) const
+{
+    const auto times = m_metrics.commandTimes(key);
+    if (!times || times->firstByte.count() < quint64(MinSamples))
+        return ceilingMs;
+
+    const double firstByteUs = double(times->firstByte.quantileUs(Quantile)) * Factor;
+    const int maxBytes = times->maxBytes.load(std::memory_order_relaxed);
+    // Without a rate estimate yet the histogram alone has to cover transfer
+    const double transferUs = (m_bytesPerUs > 0.0) ? Factor * maxBytes / m_bytesPerUs : 0.0;
+
+    const int ms = int(std::ceil((firstByteUs + transferUs) / 1000.0)) + SlackMs;
+    return qBound(qMin(MinDeadlineMs, ceilingMs), ms, ceilingMs);
+}
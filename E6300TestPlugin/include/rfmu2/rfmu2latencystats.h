@@ -0,0 +1,52 @@
+#pragma once
+#include <QByteArray>
+#include <QtGlobal>
+
+class Rfmu2Metrics;
+
+/*---------------------------------------------------------------------------
+ * Rfmu2LatencyStats – receive deadlines derived from what the instrument
+ * actually does instead of one fixed timeout per module.
+ *
+ * Commands are told apart by commandKey(): the function byte, plus mode and
+ * sub-function for the NA (0x07) family whose members differ wildly in cost.
+ * The per-command times live in Rfmu2Metrics; the deadline comes from the
+ * time-to-first-byte histogram there. Transfer time is estimated separately
+ * from the largest response seen for the key and the link rate measured
+ * here, so a big NA trace does not inflate the deadline of a short echo.
+ *
+ * Not thread-safe; owned by the I/O context and used on the I/O thread only.
+ *---------------------------------------------------------------------------*/
+class Rfmu2LatencyStats
+{
+public:
+    static constexpr int    MinSamples     = 20;      // below this the fixed timeout applies
+    static constexpr double Quantile       = 0.999;
+    static constexpr double Factor         = 3.0;
+    static constexpr int    SlackMs        = 20;      // scheduling noise on either side
+    static constexpr int    MinDeadlineMs  = 50;
+
+    explicit Rfmu2LatencyStats(const Rfmu2Metrics &metrics) : m_metrics(metrics) {}
+
+    // 0 for frames that are not regular command frames (no adaptive deadline)
+    static quint32 commandKey(const QByteArray &frame);
+
+    // Link rate and overall latency; the per-command times go to the metrics
+    void record(qint64 firstByteUs, qint64 totalUs, int responseBytes);
+
+    // Adaptive receive deadline for key, never above ceilingMs
+    int deadlineMs(quint32 key, int ceilingMs) const;
+
+    int    samples(quint32 key) const;
+    qint64 quantileUs(quint32 key, double q) const;   // time to first byte; -1 if no data
+
+    // Over all commands: the latest and a smoothed time-to-first-byte; -1 if no data
+    qint64 lastFirstByteUs() const     { return m_lastFirstByteUs; }
+    qint64 smoothedFirstByteUs() const { return m_smoothedFirstByteUs < 0 ? -1 : qint64(m_smoothedFirstByteUs); }
+
+private:
+    const Rfmu2Metrics &m_metrics;
+    double m_bytesPerUs = 0.0;    // EWMA over responses large enough to time
+    qint64 m_lastFirstByteUs = -1;
+    double m_smoothedFirstByteUs = -1.0;
+};
@@ -0,0 +1,209 @@
+#include "rfmu2metrics.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+static constexpr int kBucketsPerOctave = 4;
+
+// ---------------- histogram ----------------
+int Rfmu2Histogram::bucketFor(qint64 us)
+{
+    if (us <= 1)
+        return 0;
+    const int b = int(std::ceil(kBucketsPerOctave * std::log2(double(us))));
+    return qBound(0, b, Buckets - 1);
+}
+
+qint64 Rfmu2Histogram::bucketUpperUs(int bucket)
+{
+    return qint64(std::ceil(std::exp2(double(bucket) / kBucketsPerOctave)));
+}
+
+void Rfmu2Histogram::record(qint64 us)
+{
+    us = qMax<qint64>(0, us);
+    m_counts[bucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumUs.fetch_add(quint64(us), std::memory_order_relaxed);
+
+    qint64 seen = m_maxUs.load(std::memory_order_relaxed);
+    while (us > seen && !m_maxUs.compare_exchange_weak(seen, us, std::memory_order_relaxed)) {}
+}
+
+quint64 Rfmu2Histogram::snapshot(std::array<quint64, Buckets> &counts) const
+{
+    quint64 total = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    return total;
+}
+
+qint64 Rfmu2Histogram::quantileOf(const std::array<quint64, Buckets> &counts, quint64 total,
+                                  double q, qint64 maxUs)
+{
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(q * double(total))));
+    quint64 seen = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank)
+            return qMin(bucketUpperUs(i), maxUs);
+    }
+    return maxUs;
+}
+
+qint64 Rfmu2Histogram::quantileUs(double q) const
+{
+    std::array<quint64, Buckets> counts;
+    const quint64 total = snapshot(counts);
+    if (total == 0)
+        return -1;
+    return quantileOf(counts, total, q, m_maxUs.load(std::memory_order_relaxed));
+}
+
+Rfmu2Histogram::Summary Rfmu2Histogram::summary() const
+{
+    std::array<quint64, Buckets> counts;
+    const quint64 total = snapshot(counts);
+
+    Summary s;
+    s.count = total;
+    if (total == 0)
+        return s;
+    s.meanUs = double(m_sumUs.load(std::memory_order_relaxed)) / double(m_count.load(std::memory_order_relaxed));
+    s.maxUs  = m_maxUs.load(std::memory_order_relaxed);
+    s.p50Us  = quantileOf(counts, total, 0.50, s.maxUs);
+    s.p90Us  = quantileOf(counts, total, 0.90, s.maxUs);
+    s.p99Us  = quantileOf(counts, total, 0.99, s.maxUs);
+    return s;
+}
+
+QJsonObject Rfmu2Histogram::Summary::toJson() const
+{
+    return QJsonObject {
+        { "count",  double(count) },
+        { "meanUs", std::round(meanUs) },
+        { "p50Us",  double(p50Us) },
+        { "p90Us",  double(p90Us) },
+        { "p99Us",  double(p99Us) },
+        { "maxUs",  double(maxUs) },
+    };
+}
+
+// ---------------- metrics ----------------
+Rfmu2Metrics::Rfmu2Metrics()
+    : m_startMs(QDateTime::currentMSecsSinceEpoch())
+{
+}
+
+std::shared_ptr<Rfmu2Metrics::CommandTimes> Rfmu2Metrics::slotFor(quint32 key)
+{
+    QMutexLocker lock(&m_mutex);
+    auto &slot = m_commandTimes[key];
+    if (!slot)
+        slot = std::make_shared<CommandTimes>();
+    return slot;
+}
+
+void Rfmu2Metrics::recordRtt(quint32 key, qint64 us)
+{
+    if (key == 0)
+        return;
+    slotFor(key)->rtt.record(us);
+}
+
+void Rfmu2Metrics::recordResponse(quint32 key, qint64 firstByteUs, qint64 totalUs, int responseBytes)
+{
+    if (key == 0)
+        return;
+
+    const std::shared_ptr<CommandTimes> t = slotFor(key);
+    t->rtt.record(totalUs);
+    t->firstByte.record(firstByteUs);
+    int seen = t->maxBytes.load(std::memory_order_relaxed);
+    while (responseBytes > seen
+           && !t->maxBytes.compare_exchange_weak(seen, responseBytes, std::memory_order_relaxed)) {}
+}
+
+std::shared_ptr<const Rfmu2Metrics::CommandTimes> Rfmu2Metrics::commandTimes(quint32 key) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_commandTimes.value(key);
+}
+
+Rfmu2Metrics::Counters Rfmu2Metrics::counters() const
+{
+    Counters c;
+    c.commands     = m_commands.load(std::memory_order_relaxed);
+    c.bytesOut     = m_bytesOut.load(std::memory_order_relaxed);
+    c.bytesIn      = m_bytesIn.load(std::memory_order_relaxed);
+    c.framesParsed = m_framesParsed.load(std::memory_order_relaxed);
+    c.resyncs      = m_resyncs.load(std::memory_order_relaxed);
+    c.resyncBytes  = m_resyncBytes.load(std::memory_order_relaxed);
+    c.staleBytes   = m_staleBytes.load(std::memory_order_relaxed);
+    c.timeouts     = m_timeouts.load(std::memory_order_relaxed);
+    c.retries      = m_retries.load(std::memory_order_relaxed);
+    c.uptimeMs     = QDateTime::currentMSecsSinceEpoch() - m_startMs;
+    return c;
+}
+
+QVector<Rfmu2Metrics::CommandStats> Rfmu2Metrics::commandStats() const
+{
+    QVector<QPair<quint32, std::shared_ptr<CommandTimes>>> table;
+    {
+        QMutexLocker lock(&m_mutex);
+        table.reserve(m_commandTimes.size());
+        for (auto it = m_commandTimes.cbegin(); it != m_commandTimes.cend(); ++it)
+            table.append({ it.key(), it.value() });
+    }
+    std::sort(table.begin(), table.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    QVector<CommandStats> out;
+    out.reserve(table.size());
+    for (const auto &entry : table)
+        out.append({ entry.first, commandName(entry.first), entry.second->rtt.summary(),
+                     entry.second->firstByte.summary() });
+    return out;
+}
+
+QString Rfmu2Metrics::commandName(quint32 key)
+{
+    const quint8 function = quint8(key >> 16);
+    QString name = QStringLiteral("%1").arg(function, 2, 16, QLatin1Char('0'));
+    if (function == 0x07)
+        name += QStringLiteral(".%1.%2").arg(quint8(key >> 8), 2, 16, QLatin1Char('0'))
+                                        .arg(quint8(key), 2, 16, QLatin1Char('0'));
+    return name.toUpper();
+}
+
+QJsonObject Rfmu2Metrics::toJson() const
+{
+    const Counters c = counters();
+    const double seconds = qMax<qint64>(1, c.uptimeMs) / 1000.0;
+
+    QJsonObject rtt, firstByte;
+    for (const CommandStats &s : commandStats()) {
+        rtt.insert(s.name, s.rtt.toJson());
+        if (s.firstByte.count)
+            firstByte.insert(s.name, s.firstByte.toJson());
+    }
+
+    return QJsonObject {
+        { "uptimeMs",                   double(c.uptimeMs) },
+        { "commands",                   double(c.commands) },
+        { "avgCommandsPerSecLifetime",  std::round(c.commands / seconds * 10.0) / 10.0 },
+        { "bytesOut",                   double(c.bytesOut) },
+        { "bytesIn",                    double(c.bytesIn) },
+        { "framesParsed",               double(c.framesParsed) },
+        { "resyncs",                    double(c.resyncs) },
+        { "resyncBytes",                double(c.resyncBytes) },
+        { "staleBytes",                 double(c.staleBytes) },
+        { "timeouts",                   double(c.timeouts) },
+        { "retries",                    double(c.retries) },
+        { "rtt",                        rtt },
+        { "firstByte",                  firstByte },
+    };
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <memory>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2Histogram – lock-free duration histogram, shared by the metrics
+ * surface and the adaptive receive deadlines.
+ *
+ * Log-scale buckets, 4 per octave from 1 µs (~19 % resolution) up to
+ * ~2 min. record() is a handful of relaxed atomic adds, so any thread may
+ * record and any thread may read; a reader racing a writer can see one
+ * sample in the count but not yet in its bucket, which is fine for display.
+ *---------------------------------------------------------------------------*/
+class Rfmu2Histogram
+{
+public:
+    static constexpr int Buckets = 108;
+
+    struct Summary {
+        quint64 count  = 0;
+        double  meanUs = 0.0;
+        qint64  p50Us  = 0;
+        qint64  p90Us  = 0;
+        qint64  p99Us  = 0;
+        qint64  maxUs  = 0;
+
+        QJsonObject toJson() const;
+    };
+
+    void record(qint64 us);
+    Summary summary() const;
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+
+    // Bucket upper bound (capped at the largest sample); -1 if empty
+    qint64 quantileUs(double q) const;
+
+private:
+    static int    bucketFor(qint64 us);
+    static qint64 bucketUpperUs(int bucket);
+    quint64 snapshot(std::array<quint64, Buckets> &counts) const;
+    static qint64 quantileOf(const std::array<quint64, Buckets> &counts, quint64 total,
+                             double q, qint64 maxUs);
+
+    std::array<std::atomic<quint64>, Buckets> m_counts {};
+    std::atomic<quint64> m_count {0};
+    std::atomic<quint64> m_sumUs {0};
+    std::atomic<qint64>  m_maxUs {0};
+};
+
+/*---------------------------------------------------------------------------
+ * Rfmu2Metrics – transport counters and per-command round-trip times of one
+ * instrument link.
+ *
+ * Written by the modules on the I/O thread, readable from any thread: the
+ * counters are atomics, and the per-command table takes a mutex that is
+ * only contended while someone is reading it.
+ *
+ * Commands are keyed by Rfmu2LatencyStats::commandKey(): the function byte,
+ * plus mode and sub-function for the NA family. The per-command table is
+ * the only record of response times; Rfmu2LatencyStats derives its receive
+ * deadlines from the same histograms the stats panel shows.
+ *---------------------------------------------------------------------------*/
+class Rfmu2Metrics
+{
+public:
+    struct Counters {
+        quint64 commands     = 0;   // frames sent
+        quint64 bytesOut     = 0;
+        quint64 bytesIn      = 0;
+        quint64 framesParsed = 0;
+        quint64 resyncs      = 0;   // times the parser skipped to the next header
+        quint64 resyncBytes  = 0;   // bytes skipped doing so
+        quint64 staleBytes   = 0;   // unsolicited input dropped before a request
+        quint64 timeouts     = 0;   // requests that got no answer in time
+        quint64 retries      = 0;
+        qint64  uptimeMs     = 0;   // since the metrics were created
+    };
+
+    struct CommandTimes {
+        Rfmu2Histogram   rtt;           // request sent to complete answer
+        Rfmu2Histogram   firstByte;     // request sent to first byte; single requests only
+        std::atomic<int> maxBytes {0};  // largest answer seen
+    };
+
+    struct CommandStats {
+        quint32 key = 0;
+        QString name;               // e.g. "21" or "07.03.01"
+        Rfmu2Histogram::Summary rtt;
+        Rfmu2Histogram::Summary firstByte;
+    };
+
+    Rfmu2Metrics();
+
+    /* ----- I/O thread ----- */
+    void addCommands(int frames, int bytes)
+    {
+        m_commands.fetch_add(quint64(frames), std::memory_order_relaxed);
+        m_bytesOut.fetch_add(quint64(bytes), std::memory_order_relaxed);
+    }
+    void addBytesIn(int bytes)   { m_bytesIn.fetch_add(quint64(bytes), std::memory_order_relaxed); }
+    void addFrameParsed()        { m_framesParsed.fetch_add(1, std::memory_order_relaxed); }
+    void addResync(int skipped)
+    {
+        m_resyncs.fetch_add(1, std::memory_order_relaxed);
+        m_resyncBytes.fetch_add(quint64(skipped), std::memory_order_relaxed);
+    }
+    void addStaleBytes(int bytes) { m_staleBytes.fetch_add(quint64(bytes), std::memory_order_relaxed); }
+    void addTimeout()             { m_timeouts.fetch_add(1, std::memory_order_relaxed); }
+    void addRetry()               { m_retries.fetch_add(1, std::memory_order_relaxed); }
+    void recordRtt(quint32 key, qint64 us);         // pipelined: no first-byte time
+    void recordResponse(quint32 key, qint64 firstByteUs, qint64 totalUs, int responseBytes);
+
+    /* ----- any thread ----- */
+    Counters counters() const;
+    std::shared_ptr<const CommandTimes> commandTimes(quint32 key) const;   // null if never seen
+    QVector<CommandStats> commandStats() const;     // sorted by key
+    QJsonObject toJson() const;     // totals since start; windowed rates are the reader's job
+
+    static QString commandName(quint32 key);
+
+private:
+    std::shared_ptr<CommandTimes> slotFor(quint32 key);
+
+    std::atomic<quint64> m_commands {0};
+    std::atomic<quint64> m_bytesOut {0};
+    std::atomic<quint64> m_bytesIn {0};
+    std::atomic<quint64> m_framesParsed {0};
+    std::atomic<quint64> m_resyncs {0};
+    std::atomic<quint64> m_resyncBytes {0};
+    std::atomic<quint64> m_staleBytes {0};
+    std::atomic<quint64> m_timeouts {0};
+    std::atomic<quint64> m_retries {0};
+    qint64               m_startMs = 0;
+
+    mutable QMutex m_mutex;         // guards the table, not the histograms in it
+    QHash<quint32, std::shared_ptr<CommandTimes>> m_commandTimes;
+};
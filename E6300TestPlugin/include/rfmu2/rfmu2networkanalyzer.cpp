@@ -11,9 +11,9 @@ Rfmu2NetworkAnalyzer::Rfmu2NetworkAnalyzer(QTcpSocket *sock, QObject *parent)
 }
 
 /*--------------------------------------------------------------------
- *  sweep configuration helpers
+ *  sweep configuration encoders
  *------------------------------------------------------------------*/
-bool Rfmu2NetworkAnalyzer::configureFrequencySweep(int startKHz, int stopKHz)
+QByteArray Rfmu2NetworkAnalyzer::encodeFrequencySweep(int startKHz, int stopKHz)
 {
     QByteArray cmd;
     cmd.append(int24ToBytes(FrameHeaderValue))
@@ -25,10 +25,10 @@ bool Rfmu2NetworkAnalyzer::configureFrequencySweep(int startKHz, int stopKHz)
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));               // length byte
-    return sendAndEcho(cmd);
+    return cmd;
 }
 
-bool Rfmu2NetworkAnalyzer::configurePowerSweep(double startDb, double stopDb)
+QByteArray Rfmu2NetworkAnalyzer::encodePowerSweep(double startDb, double stopDb)
 {
     auto s = splitDoubleAtDecimal(startDb);
     auto e = splitDoubleAtDecimal(stopDb);
@@ -43,16 +43,15 @@ bool Rfmu2NetworkAnalyzer::configurePowerSweep(double startDb, double stopDb)
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return cmd;
 }
 
-bool Rfmu2NetworkAnalyzer::configurePointsAndPorts(int points,
-                                                   const QString &p1,
-                                                   const QString &p2)
+QByteArray Rfmu2NetworkAnalyzer::encodePointsAndPorts(int points,
+                                                      const QString &p1,
+                                                      const QString &p2)
 {
     if (points <= 0 || points > 401)
-        return fail(Rfmu2Err::InternalLogic,
-                    QStringLiteral("Invalid sweep-point count"));
+        return {};
 
     QByteArray cmd;
     cmd.append(int24ToBytes(FrameHeaderValue))
@@ -65,27 +64,66 @@ bool Rfmu2NetworkAnalyzer::configurePointsAndPorts(int points,
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return cmd;
+}
+
+/*--------------------------------------------------------------------
+ *  sweep configuration helpers
+ *------------------------------------------------------------------*/
+bool Rfmu2NetworkAnalyzer::configureSweep(const SweepConfig &c)
+{
+    if (c.points <= 0 || c.points > 401)
+        return fail(Rfmu2Err::InternalLogic,
+                    QStringLiteral("Invalid sweep-point count"));
+
+    return applyStates({
+        { SlotFrequencySweep, encodeFrequencySweep(c.startKHz, c.stopKHz) },
+        { SlotPowerSweep,     encodePowerSweep(c.startDb, c.stopDb) },
+        { SlotPointsAndPorts, encodePointsAndPorts(c.points, c.port1, c.port2) },
+    });
+}
+
+bool Rfmu2NetworkAnalyzer::configureFrequencySweep(int startKHz, int stopKHz)
+{
+    return applyState(SlotFrequencySweep, encodeFrequencySweep(startKHz, stopKHz));
+}
+
+bool Rfmu2NetworkAnalyzer::configurePowerSweep(double startDb, double stopDb)
+{
+    return applyState(SlotPowerSweep, encodePowerSweep(startDb, stopDb));
+}
+
+bool Rfmu2NetworkAnalyzer::configurePointsAndPorts(int points,
+                                                   const QString &p1,
+                                                   const QString &p2)
+{
+    if (points <= 0 || points > 401)
+        return fail(Rfmu2Err::InternalLogic,
+                    QStringLiteral("Invalid sweep-point count"));
+
+    return applyState(SlotPointsAndPorts, encodePointsAndPorts(points, p1, p2));
 }
 
 /*--------------------------------------------------------------------
  *  measurement helpers
  *------------------------------------------------------------------*/
-QVector<double> Rfmu2NetworkAnalyzer::measureSinglePort(ResultType type)
+QByteArray Rfmu2NetworkAnalyzer::encodeMeasure(bool dualPort, ResultType type)
 {
+    Rfmu2TraceSpan span("encode");
     QByteArray cmd;
     cmd.append(int24ToBytes(FrameHeaderValue))
-        .append(char(0x07)).append(char(0x02)).append(char(0x02))
+        .append(char(0x07)).append(dualPort ? char(0x01) : char(0x02)).append(char(0x02))
         .append(char(0x00))
         .append(static_cast<char>(type))
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));
+    return cmd;
+}
 
-    if (!sendCommand(cmd))
-        return {};
-
-    QByteArray resp = receiveResponse();
+QVector<double> Rfmu2NetworkAnalyzer::measureSinglePort(ResultType type)
+{
+    QByteArray resp = transact(encodeMeasure(false, type));
     if (resp.isEmpty())
         return {};                             // fail() already fired inside
 
@@ -98,19 +136,7 @@ QVector<double> Rfmu2NetworkAnalyzer::measureSinglePort(ResultType type)
 
 QVector<double> Rfmu2NetworkAnalyzer::measureDualPort(ResultType type)
 {
-    QByteArray cmd;
-    cmd.append(int24ToBytes(FrameHeaderValue))
-        .append(char(0x07)).append(char(0x01)).append(char(0x02))
-        .append(char(0x00))
-        .append(static_cast<char>(type))
-        .append(int24ToBytes(FrameTailValue));
-
-    cmd.insert(3, char(cmd.size() + 1));
-
-    if (!sendCommand(cmd))
-        return {};
-
-    QByteArray resp = receiveResponse();
+    QByteArray resp = transact(encodeMeasure(true, type));
     if (resp.isEmpty())
         return {};
 
@@ -122,6 +148,112 @@ QVector<double> Rfmu2NetworkAnalyzer::measureDualPort(ResultType type)
     return bytesToDoubleVector(payload);
 }
 
+/*--------------------------------------------------------------------
+ *  measurement layout: per point, per S-parameter, one word (LogAmp,
+ *  Phase) or two (Complex: I,Q; LogAmpPhase: amp,phase)
+ *------------------------------------------------------------------*/
+bool Rfmu2NetworkAnalyzer::splitMeasurement(ResultType type, bool dualPort, const QVector<double> &raw,
+                                            int points, QVector<QVector<double>> &ampOrI,
+                                            QVector<QVector<double>> &phaseOrQ)
+{
+    const int params  = dualPort ? 4 : 1;
+    const int words   = (type == ResultType::LogAmp || type == ResultType::Phase) ? 1 : 2;
+    const int stride  = params * words;
+    if (points <= 0 || raw.size() != stride * points)
+        return false;
+
+    ampOrI.fill(QVector<double>(points, 0.0), params);
+    phaseOrQ.fill(QVector<double>(points, 0.0), params);
+    for (int p = 0; p < params; ++p) {
+        double *a = ampOrI[p].data();
+        double *q = phaseOrQ[p].data();
+        for (int i = 0; i < points; ++i) {
+            const int k = i * stride + p * words;
+            if (type == ResultType::Phase) {
+                q[i] = raw[k];
+            } else {
+                a[i] = raw[k];
+                if (words == 2)
+                    q[i] = raw[k + 1];
+            }
+        }
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------
+ *  port scan
+ *------------------------------------------------------------------*/
+QVector<QVector<double>> Rfmu2NetworkAnalyzer::scanPorts(const PortScan &scan)
+{
+    if (scan.points <= 0 || scan.points > 401) {
+        fail(Rfmu2Err::InternalLogic, QStringLiteral("Invalid sweep-point count"));
+        return {};
+    }
+    const bool ownSweep = scan.startKHz != 0 || scan.stopKHz != 0;
+    if (ownSweep && (scan.startKHz <= 0 || scan.stopKHz <= scan.startKHz)) {
+        fail(Rfmu2Err::InternalLogic, QStringLiteral("Invalid scan frequency range"));
+        return {};
+    }
+
+    // The scan's own frequency sweep if it has one, then per port:
+    // points/ports setup and the measurement
+    const QByteArray measure = encodeMeasure(scan.dualPort, scan.type);
+    QVector<QByteArray> frames;
+    frames.reserve(2 * scan.ports.size() + 3);
+    if (ownSweep)
+        frames.append(encodeFrequencySweep(scan.startKHz, scan.stopKHz));
+    const int first = frames.size();
+    for (const QString &port : scan.ports) {
+        frames.append(encodePointsAndPorts(scan.points, port, scan.port2));
+        frames.append(measure);
+    }
+
+    // Leave the sweep as the rest of the application configured it
+    const int firstRestore = frames.size();
+    QVector<int> restoreSlots;
+    for (int slot : { SlotPointsAndPorts, SlotFrequencySweep }) {
+        if (slot == SlotFrequencySweep && !ownSweep)
+            continue;
+        if (m_applied.contains(slot) && !m_stale.contains(slot)) {
+            frames.append(m_applied.value(slot));
+            restoreSlots.append(slot);
+        }
+    }
+
+    const QVector<QByteArray> responses = transactPipelined(frames, scan.window);
+
+    QVector<QVector<double>> traces;
+    traces.reserve(scan.ports.size());
+    const bool sweepSet = !ownSweep || (!responses.isEmpty() && responses.first() == frames.first());
+    if (!responses.isEmpty() && !sweepSet)
+        fail(Rfmu2Err::Protocol, QStringLiteral("Unexpected echo frame for the scan sweep"));
+    for (int k = first; sweepSet && k + 1 < responses.size() && traces.size() < scan.ports.size(); k += 2) {
+        const QString &port = scan.ports[traces.size()];
+        if (responses[k] != frames[k]) {
+            fail(Rfmu2Err::Protocol, QStringLiteral("Unexpected echo frame for %1").arg(port));
+            break;
+        }
+        const QByteArray payload = extractPayloadFromPackage(responses[k + 1], 2);
+        if (payload.isEmpty()) {
+            fail(Rfmu2Err::Protocol, QStringLiteral("empty payload for %1").arg(port));
+            break;
+        }
+        traces.append(bytesToDoubleVector(payload));
+    }
+
+    // The device holds whatever the scan left in a slot that was not put back
+    if (ownSweep)
+        m_stale.insert(SlotFrequencySweep);
+    m_stale.insert(SlotPointsAndPorts);
+    for (int r = 0; r < restoreSlots.size(); ++r) {
+        const int k = firstRestore + r;
+        if (k < responses.size() && responses[k] == frames[k])
+            m_stale.remove(restoreSlots[r]);
+    }
+    return traces;
+}
+
 /*--------------------------------------------------------------------
  *  common calibration helper  (mode: 0x02 = single-port, 0x01 = dual-port)
  *------------------------------------------------------------------*/
@@ -170,10 +302,9 @@ SinglePortCaliData Rfmu2NetworkAnalyzer::loadSinglePortCalibrationState(int n, b
     cmd.insert(3, char(cmd.size() + 1));
 
     SinglePortCaliData res {};
-    if (!sendCommand(cmd))
-        return res;
-
-    QByteArray resp = receiveResponse();
+    // Loading a stored state may change the sweep settings behind our back
+    invalidateAppliedState();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty()) return res;
 
     QByteArray pl = extractPayloadFromPackage(resp, 1);
@@ -217,10 +348,9 @@ DualPortCaliData Rfmu2NetworkAnalyzer::loadDualPortCalibrationState(int n, bool*
     cmd.insert(3, char(cmd.size() + 1));
 
     DualPortCaliData res {};
-    if (!sendCommand(cmd))
-        return res;
-
-    QByteArray resp = receiveResponse();
+    // Loading a stored state may change the sweep settings behind our back
+    invalidateAppliedState();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty()) return res;
 
     QByteArray pl = extractPayloadFromPackage(resp, 1);
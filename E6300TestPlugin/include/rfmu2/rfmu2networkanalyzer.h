@@ -1,6 +1,7 @@
 #pragma once
 #include "rfmu2base.h"
 #include <QTcpSocket>
+#include <QStringList>
 #include <QVector>
 
 struct SinglePortCaliData {
@@ -28,6 +29,9 @@ class Rfmu2NetworkAnalyzer : public Rfmu2Base
 {
     Q_OBJECT
 public:
+    // applied-state slots, in replay order
+    enum StateSlot { SlotFrequencySweep, SlotPowerSweep, SlotPointsAndPorts };
+
     enum class ResultType : unsigned char {
         Complex      = 0x01,
         LogAmp       = 0x02,
@@ -41,7 +45,19 @@ public:
     Rfmu2NetworkAnalyzer(const Rfmu2NetworkAnalyzer&)            = delete;
     Rfmu2NetworkAnalyzer& operator=(const Rfmu2NetworkAnalyzer&) = delete;
 
-    /* sweep configuration */
+    /* sweep configuration – a setting already in effect is not sent again */
+    struct SweepConfig {
+        int     startKHz = 0;
+        int     stopKHz  = 0;
+        double  startDb  = 0.0;
+        double  stopDb   = 0.0;
+        int     points   = 0;
+        QString port1;
+        QString port2;
+    };
+    // All three settings in one exchange; only the changed ones go out
+    bool configureSweep(const SweepConfig &config);
+
     bool configureFrequencySweep(int startKHz, int stopKHz);
     bool configurePowerSweep(double startDb, double stopDb);
     bool configurePointsAndPorts(int points,
@@ -52,6 +68,14 @@ public:
     QVector<double> measureSinglePort(ResultType retType = ResultType::LogAmp);
     QVector<double> measureDualPort  (ResultType retType = ResultType::LogAmp);
 
+    // Splits one measurement into per-point series: one S-parameter for
+    // single-port (S11), four for dual-port (S11, S21, S12, S22), each as
+    // amplitude-or-I and phase-or-Q. A part the type does not carry is
+    // zero. False if raw does not hold `points` points of that type.
+    static bool splitMeasurement(ResultType type, bool dualPort, const QVector<double> &raw,
+                                 int points, QVector<QVector<double>> &ampOrI,
+                                 QVector<QVector<double>> &phaseOrQ);
+
     /* single-port calibration */
     bool calibrateSinglePortOpen();
     bool calibrateSinglePortShort();
@@ -75,6 +99,27 @@ public:
     DualPortCaliData loadDualPortCalibrationState(int stateNumber,
                                                   bool *ok = nullptr);
 
+    /* one measurement per port, the next port's setup pipelined behind the
+       running sweep; port settings are put back afterwards */
+    struct PortScan {
+        QStringList ports;                   // each one in turn as port 1
+        QString     port2;                   // fixed second port (dual-port types)
+        int         startKHz = 0;            // frequency sweep of the scan;
+        int         stopKHz  = 0;            // both 0: keep the configured one
+        int         points   = 201;
+        bool        dualPort = false;
+        ResultType  type     = ResultType::LogAmp;
+        int         window   = 2;            // frames in flight
+    };
+    // One trace per port; shorter list if the scan broke off
+    QVector<QVector<double>> scanPorts(const PortScan &scan);
+
+    /* frame encoders – empty on invalid input */
+    static QByteArray encodeFrequencySweep(int startKHz, int stopKHz);
+    static QByteArray encodePowerSweep(double startDb, double stopDb);
+    static QByteArray encodePointsAndPorts(int points, const QString &port1, const QString &port2);
+    static QByteArray encodeMeasure(bool dualPort, ResultType type);
+
 private:
     /* parsing helpers */
     SinglePortCaliData parseSinglePortCaliData(const QByteArray &payload,
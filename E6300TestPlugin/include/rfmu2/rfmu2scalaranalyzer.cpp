@@ -0,0 +1,53 @@
+#include "rfmu2scalaranalyzer.h"
+#include "rfmu2signalgenerator.h"
+#include "rfmu2spectrumanalyzer.h"
+#include <QDebug>
+
+Rfmu2ScalarAnalyzer::Rfmu2ScalarAnalyzer(QTcpSocket *s, Rfmu2SignalGenerator *sg, QObject *p)
+    : Rfmu2Base(s, p),
+    m_sg(sg)
+{
+    m_timeoutMs = 5'000;   // per response, as for single SA peak reads
+}
+
+QVector<double> Rfmu2ScalarAnalyzer::measureResponse(const Setup &setup)
+{
+    const int n = setup.freqsKHz.size();
+
+    // SG configure, SA peak request – alternating, encoded before anything is sent
+    QVector<QByteArray> frames;
+    frames.reserve(2 * n);
+    for (int f : setup.freqsKHz) {
+        const QByteArray sg = Rfmu2SignalGenerator::encodeSingleChannel(f, setup.sourceLevelDbm,
+                                                                        setup.sourcePort);
+        if (sg.isEmpty()) {
+            fail(Rfmu2Err::InternalLogic, QStringLiteral("Frequency must be >0"));
+            return {};
+        }
+        frames.append(sg);
+        frames.append(Rfmu2SpectrumAnalyzer::encodePeakRequest(f, setup.receiveLevelDbm,
+                                                               setup.receiveChannel,
+                                                               setup.receivePort));
+    }
+
+    // From here the SG output is whatever point the sweep reached
+    if (m_sg)
+        m_sg->invalidateAppliedState();
+    const QVector<QByteArray> responses = transactPipelined(frames, setup.window);
+
+    QVector<double> power;
+    power.reserve(n);
+    for (int k = 0; k + 1 < responses.size(); k += 2) {
+        if (responses[k] != frames[k]) {
+            fail(Rfmu2Err::Protocol, QStringLiteral("Unexpected echo frame at point %1").arg(k / 2));
+            break;
+        }
+        const QVector<double> peak = bytesToDoubleVector(extractPayloadFromPackage(responses[k + 1], 1));
+        if (peak.isEmpty()) {
+            fail(Rfmu2Err::Protocol, QStringLiteral("Peak payload empty at point %1").arg(k / 2));
+            break;
+        }
+        power.append(peak.first());
+    }
+    return power;
+}
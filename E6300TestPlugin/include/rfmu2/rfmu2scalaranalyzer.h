@@ -0,0 +1,49 @@
+#pragma once
+#include "rfmu2base.h"
+#include <QTcpSocket>
+#include <QVector>
+
+class Rfmu2SignalGenerator;
+
+/*---------------------------------------------------------------------------
+ * Rfmu2ScalarAnalyzer – stimulus/response sweep: the signal generator is
+ * stepped through a frequency list and the spectrum analyzer takes a peak
+ * reading at each point.
+ *
+ * Per point two frames go out, SG configure then SA peak request. They are
+ * sent through transactPipelined(), so with a window of 2 the configure for
+ * point k+1 is already on the wire while the reading for point k comes back.
+ * The instrument executes frames in arrival order, so the stimulus never
+ * changes under a running measurement; the window only hides round trips.
+ *
+ * The SG frames bypass Rfmu2SignalGenerator, so its output shadow is marked
+ * stale for each sweep: the next SG setting is sent even if it matches the
+ * pre-sweep one.
+ *---------------------------------------------------------------------------*/
+class Rfmu2ScalarAnalyzer : public Rfmu2Base
+{
+    Q_OBJECT
+public:
+    struct Setup {
+        QVector<int> freqsKHz;          // stimulus and receive frequency per point
+        double  sourceLevelDbm = -10.0;
+        QString sourcePort;
+        double  receiveLevelDbm = 0.0;  // SA level setting
+        int     receiveChannel = 1;
+        QString receivePort;
+        int     window = 2;             // frames in flight; 1 = strictly sequential
+    };
+
+    Rfmu2ScalarAnalyzer(QTcpSocket *socket, Rfmu2SignalGenerator *sg, QObject *parent = nullptr);
+    ~Rfmu2ScalarAnalyzer() override = default;
+
+    Rfmu2ScalarAnalyzer(const Rfmu2ScalarAnalyzer&)            = delete;
+    Rfmu2ScalarAnalyzer& operator=(const Rfmu2ScalarAnalyzer&) = delete;
+
+    // Received peak power (dBm) per point. Shorter than setup.freqsKHz if
+    // the sweep broke off; errorOccurred() says why.
+    QVector<double> measureResponse(const Setup &setup);
+
+private:
+    Rfmu2SignalGenerator *m_sg;     // shares the socket; not owned
+};
@@ -0,0 +1,664 @@
+#include "rfmu2sequencer.h"
+#include "rfmu2tool.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QRegularExpression>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static const int _rfmu2_sequencesummary_metatype_id =
+    qRegisterMetaType<Rfmu2SequenceSummary>("Rfmu2SequenceSummary");
+
+using Op = Rfmu2TestPlan::Op;
+
+// ---------------- names ----------------
+static const QHash<QString, Op> &opTable()
+{
+    static const QHash<QString, Op> table {
+        { "clock",        Op::Clock       },
+        { "sg.single",    Op::SgSingle    },
+        { "sg.off",       Op::SgOff       },
+        { "na.configure", Op::NaConfigure },
+        { "na.cal",       Op::NaCalibrate },
+        { "na.measure",   Op::NaMeasure   },
+        { "na.scan",      Op::NaScan      },
+        { "sa.peak",      Op::SaPeak      },
+        { "sa.raw",       Op::SaRaw       },
+        { "sa.scan",      Op::SaScan      },
+        { "voltages",     Op::Voltages    },
+        { "delay",        Op::Delay       },
+    };
+    return table;
+}
+
+QString Rfmu2TestPlan::opName(Op op)
+{
+    return opTable().key(op);
+}
+
+using CalStep = bool (Rfmu2NetworkAnalyzer::*)();
+
+static const QHash<QString, CalStep> &calTable()
+{
+    using NA = Rfmu2NetworkAnalyzer;
+    static const QHash<QString, CalStep> table {
+        { "single.open",   &NA::calibrateSinglePortOpen     },
+        { "single.short",  &NA::calibrateSinglePortShort    },
+        { "single.load",   &NA::calibrateSinglePortLoad     },
+        { "single.finish", &NA::finishSinglePortCalibration },
+        { "dual.open1",    &NA::calibrateDualPortOpen1      },
+        { "dual.short1",   &NA::calibrateDualPortShort1     },
+        { "dual.load1",    &NA::calibrateDualPortLoad1      },
+        { "dual.through1", &NA::calibrateDualPortThrough1   },
+        { "dual.open2",    &NA::calibrateDualPortOpen2      },
+        { "dual.short2",   &NA::calibrateDualPortShort2     },
+        { "dual.load2",    &NA::calibrateDualPortLoad2      },
+        { "dual.through2", &NA::calibrateDualPortThrough2   },
+        { "dual.finish",   &NA::finishDualPortCalibration   },
+    };
+    return table;
+}
+
+static Rfmu2NetworkAnalyzer::ResultType resultType(const QString &name)
+{
+    using RT = Rfmu2NetworkAnalyzer::ResultType;
+    if (name == QLatin1String("Complex"))     return RT::Complex;
+    if (name == QLatin1String("Phase"))       return RT::Phase;
+    if (name == QLatin1String("LogAmpPhase")) return RT::LogAmpPhase;
+    return RT::LogAmp;
+}
+
+// ---------------- limits ----------------
+bool Rfmu2TestPlan::Limits::check(const QVector<double> &values, double *measured) const
+{
+    QVector<double> sel;
+    for (int i = qMax(0, offset); i < values.size(); i += qMax(1, stride))
+        sel.append(values[i]);
+
+    if (sel.isEmpty()) {
+        if (measured) *measured = std::nan("");
+        return false;
+    }
+
+    auto inside = [this](double v) { return v >= min && v <= max; };
+
+    double m = 0.0;
+    switch (reduce) {
+    case Max:  m = *std::max_element(sel.cbegin(), sel.cend()); break;
+    case Min:  m = *std::min_element(sel.cbegin(), sel.cend()); break;
+    case Mean: m = std::accumulate(sel.cbegin(), sel.cend(), 0.0) / sel.size(); break;
+    case All: {
+        auto bad = std::find_if_not(sel.cbegin(), sel.cend(), inside);
+        m = (bad != sel.cend()) ? *bad : *std::max_element(sel.cbegin(), sel.cend());
+        break;
+    }
+    }
+    if (measured) *measured = m;
+    return inside(m);
+}
+
+// ---------------- plan parsing ----------------
+namespace {
+
+using Vars = QHash<QString, QString>;
+
+QJsonValue substitute(const QJsonValue &v, const Vars &vars)
+{
+    static const QRegularExpression token(QStringLiteral("\\$([A-Za-z_][A-Za-z0-9_]*)"));
+
+    if (v.isString()) {
+        const QString in = v.toString();
+        QString out;
+        qsizetype last = 0;
+        auto it = token.globalMatch(in);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch m = it.next();
+            out += in.mid(last, m.capturedStart() - last);
+            out += vars.value(m.captured(1), m.captured(0));    // unknown: left as is
+            last = m.capturedEnd();
+        }
+        out += in.mid(last);
+        return out;
+    }
+    if (v.isArray()) {
+        QJsonArray a;
+        for (const QJsonValue &e : v.toArray())
+            a.append(substitute(e, vars));
+        return a;
+    }
+    if (v.isObject()) {
+        QJsonObject o;
+        const QJsonObject in = v.toObject();
+        for (auto it = in.begin(); it != in.end(); ++it) {
+            if (it.key() == QLatin1String("steps"))
+                o.insert(it.key(), it.value());     // nested bodies bind their own variables
+            else
+                o.insert(it.key(), substitute(it.value(), vars));
+        }
+        return o;
+    }
+    return v;
+}
+
+struct Expander
+{
+    QHash<QString, QStringList>      portLists;
+    QVector<Rfmu2TestPlan::Step>    *out = nullptr;
+    QString                          error;
+
+    bool resolvePorts(const QJsonValue &v, const QString &path, QStringList *ports)
+    {
+        if (v.isString()) {
+            if (!portLists.contains(v.toString())) {
+                error = QStringLiteral("%1.ports: unknown port list '%2'").arg(path, v.toString());
+                return false;
+            }
+            *ports = portLists.value(v.toString());
+            return true;
+        }
+        ports->clear();
+        for (const QJsonValue &p : v.toArray())
+            ports->append(p.toString());
+        if (ports->isEmpty()) {
+            error = QStringLiteral("%1.ports: no ports").arg(path);
+            return false;
+        }
+        return true;
+    }
+
+    bool require(const QJsonObject &o, std::initializer_list<const char*> keys, const QString &path)
+    {
+        for (const char *k : keys) {
+            if (!o.contains(QLatin1String(k))) {
+                error = QStringLiteral("%1: missing '%2'").arg(path, QLatin1String(k));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool expand(const QJsonArray &steps, const Vars &vars, const QString &path)
+    {
+        for (int i = 0; i < steps.size(); ++i) {
+            const QString here = QStringLiteral("%1[%2]").arg(path).arg(i);
+            const QJsonObject obj = substitute(steps[i], vars).toObject();
+            const QString op = obj.value(QLatin1String("op")).toString();
+
+            if (op == QLatin1String("loop")) {
+                const int count = obj.value(QLatin1String("count")).toInt(-1);
+                if (count < 0) {
+                    error = QStringLiteral("%1: loop needs a non-negative 'count'").arg(here);
+                    return false;
+                }
+                const QString var = obj.value(QLatin1String("var")).toString(QStringLiteral("iter"));
+                Vars inner = vars;
+                for (int n = 0; n < count; ++n) {
+                    inner.insert(var, QString::number(n));
+                    if (!expand(obj.value(QLatin1String("steps")).toArray(), inner, here + ".steps"))
+                        return false;
+                }
+                continue;
+            }
+
+            if (op == QLatin1String("forPorts")) {
+                QStringList ports;
+                if (!resolvePorts(obj.value(QLatin1String("ports")), here, &ports))
+                    return false;
+                const QString var = obj.value(QLatin1String("var")).toString(QStringLiteral("port"));
+                Vars inner = vars;
+                for (const QString &port : ports) {
+                    inner.insert(var, port);
+                    if (!expand(obj.value(QLatin1String("steps")).toArray(), inner, here + ".steps"))
+                        return false;
+                }
+                continue;
+            }
+
+            if (!opTable().contains(op)) {
+                error = QStringLiteral("%1.op: unknown operation '%2'").arg(here, op);
+                return false;
+            }
+
+            Rfmu2TestPlan::Step s;
+            s.op   = opTable().value(op);
+            s.args = obj;
+            s.id   = obj.value(QLatin1String("id")).toString(QStringLiteral("%1#%2").arg(op).arg(out->size()));
+            s.abortOnFail = obj.value(QLatin1String("abortOnFail")).toBool(false);
+
+            // Named port lists become arrays, so jobs only ever see arrays
+            if (obj.contains(QLatin1String("ports"))) {
+                QStringList ports;
+                if (!resolvePorts(obj.value(QLatin1String("ports")), here, &ports))
+                    return false;
+                s.args.insert(QStringLiteral("ports"), QJsonArray::fromStringList(ports));
+            }
+
+            bool ok = true;
+            switch (s.op) {
+            case Op::SgSingle:    ok = require(obj, {"freqKHz", "level", "port"}, here); break;
+            case Op::NaConfigure: ok = require(obj, {"startKHz", "stopKHz", "startDb", "stopDb",
+                                                     "points", "port1"}, here); break;
+            case Op::NaScan:      ok = require(obj, {"ports", "points"}, here); break;
+            case Op::SaPeak:
+            case Op::SaRaw:       ok = require(obj, {"freqKHz", "level", "port"}, here); break;
+            case Op::SaScan:      ok = require(obj, {"freqKHz", "level", "ports"}, here); break;
+            case Op::Delay:       ok = require(obj, {"ms"}, here); break;
+            case Op::NaCalibrate:
+                if (!calTable().contains(obj.value(QLatin1String("step")).toString())) {
+                    error = QStringLiteral("%1.step: unknown calibration step").arg(here);
+                    ok = false;
+                }
+                break;
+            default: break;
+            }
+            if (!ok)
+                return false;
+
+            const QJsonObject lim = obj.value(QLatin1String("limits")).toObject();
+            if (!lim.isEmpty()) {
+                auto &L = s.limits;
+                L.enabled = true;
+                L.min     = lim.value(QLatin1String("min")).toDouble(L.min);
+                L.max     = lim.value(QLatin1String("max")).toDouble(L.max);
+                L.offset  = lim.value(QLatin1String("offset")).toInt(0);
+                L.stride  = lim.value(QLatin1String("stride")).toInt(1);
+                const QString reduce = lim.value(QLatin1String("reduce")).toString(QStringLiteral("all"));
+                L.reduce = reduce == QLatin1String("max")  ? Rfmu2TestPlan::Limits::Max
+                         : reduce == QLatin1String("min")  ? Rfmu2TestPlan::Limits::Min
+                         : reduce == QLatin1String("mean") ? Rfmu2TestPlan::Limits::Mean
+                                                           : Rfmu2TestPlan::Limits::All;
+            }
+
+            if (out->size() >= Rfmu2TestPlan::MaxSteps) {
+                error = QStringLiteral("plan expands to more than %1 steps").arg(Rfmu2TestPlan::MaxSteps);
+                return false;
+            }
+            out->append(s);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+Rfmu2TestPlan Rfmu2TestPlan::fromJson(const QByteArray &json, QString *error)
+{
+    Rfmu2TestPlan plan;
+
+    QJsonParseError perr;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &perr);
+    if (!doc.isObject()) {
+        if (error) *error = perr.error != QJsonParseError::NoError
+                                ? perr.errorString() : QStringLiteral("plan is not a JSON object");
+        return plan;
+    }
+
+    const QJsonObject root = doc.object();
+    plan.name = root.value(QLatin1String("name")).toString();
+
+    Expander ex;
+    ex.out = &plan.steps;
+    const QJsonObject lists = root.value(QLatin1String("portLists")).toObject();
+    for (auto it = lists.begin(); it != lists.end(); ++it) {
+        QStringList ports;
+        for (const QJsonValue &p : it.value().toArray())
+            ports.append(p.toString());
+        ex.portLists.insert(it.key(), ports);
+    }
+
+    if (!ex.expand(root.value(QLatin1String("steps")).toArray(), {}, QStringLiteral("steps"))) {
+        plan.steps.clear();
+        if (error) *error = ex.error;
+        return plan;
+    }
+    if (plan.steps.isEmpty() && error)
+        *error = QStringLiteral("plan has no steps");
+    return plan;
+}
+
+Rfmu2TestPlan Rfmu2TestPlan::fromFile(const QString &path, QString *error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = f.errorString();
+        return {};
+    }
+    return fromJson(f.readAll(), error);
+}
+
+// ---------------- sequencer ----------------
+Rfmu2Sequencer::Rfmu2Sequencer(Rfmu2Tool *tool, QObject *parent)
+    : QObject(parent), m_tool(tool)
+{
+    connect(m_tool, &Rfmu2Tool::errorOccurred, this, [this](const Rfmu2Error &e) {
+        if (m_running)
+            m_lastInstrumentError = e.text;
+    });
+}
+
+bool Rfmu2Sequencer::start(const Rfmu2TestPlan &plan, const QString &resultsPath)
+{
+    if (m_running) {
+        m_errorString = tr("A test plan is already running");
+        return false;
+    }
+
+    m_results.setFileName(resultsPath);
+    if (!m_results.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        m_errorString = m_results.errorString();
+        return false;
+    }
+
+    m_plan     = plan;
+    m_summary  = Rfmu2SequenceSummary();
+    m_summary.plan = plan.name;
+    m_next     = 0;
+    m_inFlight = 0;
+    m_stopping = false;
+    m_barrier  = false;
+    m_delaying = false;
+    m_lastInstrumentError.clear();
+    m_running  = true;
+    ++m_generation;
+
+    writeLine({ { "plan", plan.name },
+                { "steps", int(plan.steps.size()) },
+                { "started", QDateTime::currentDateTime().toString(Qt::ISODateWithMs) } });
+
+    m_clock.start();
+    pump();
+    return true;
+}
+
+void Rfmu2Sequencer::stop()
+{
+    if (!m_running || m_stopping)
+        return;
+    m_stopping = true;
+    m_summary.aborted = true;
+    m_summary.error = tr("Stopped");
+    if (m_inFlight == 0)
+        finish();       // also drops a pending delay
+}
+
+int Rfmu2Sequencer::batchLength(int first) const
+{
+    const auto &steps = m_plan.steps;
+    const Op op = steps[first].op;
+    if ((op != Op::SaPeak && op != Op::SaRaw) || steps[first].abortOnFail)
+        return 1;
+
+    int n = 1;
+    while (first + n < steps.size() && n < MaxBatch
+           && steps[first + n].op == op && !steps[first + n].abortOnFail)
+        ++n;
+    return n;
+}
+
+void Rfmu2Sequencer::pump()
+{
+    if (!m_running)
+        return;
+
+    const auto &steps = m_plan.steps;
+    while (!m_stopping && !m_barrier && !m_delaying
+           && m_inFlight < MaxInFlight && m_next < steps.size())
+    {
+        const Rfmu2TestPlan::Step &step = steps[m_next];
+
+        if (step.op == Op::Delay) {
+            if (m_inFlight > 0)
+                return;     // settle after what is already running
+            m_delaying = true;
+            const quint32 generation = m_generation;
+            const int index = m_next++;
+            QTimer::singleShot(step.args.value(QLatin1String("ms")).toInt(), this, [this, generation, index]() {
+                if (generation != m_generation)
+                    return;
+                m_delaying = false;
+                ++m_summary.steps;
+                ++m_summary.passed;
+                emit stepFinished(index, int(m_plan.steps.size()), true);
+                pump();
+            });
+            return;
+        }
+
+        const int first = m_next;
+        const int count = batchLength(first);
+        m_next += count;
+        ++m_inFlight;
+        m_barrier = steps[first + count - 1].abortOnFail;
+
+        const quint32 generation = m_generation;
+        m_tool->submit(Rfmu2Priority::Interactive, makeJob(first, count), this,
+                       [this, generation, first, count](const Batch &batch) {
+                           if (generation != m_generation)
+                               return;
+                           --m_inFlight;
+                           if (m_inFlight == 0)
+                               m_barrier = false;
+                           onBatchDone(first, count, batch);
+                           pump();
+                       });
+    }
+
+    if (m_inFlight == 0 && !m_delaying && (m_stopping || m_next >= steps.size()))
+        finish();
+}
+
+std::function<Rfmu2Sequencer::Batch()> Rfmu2Sequencer::makeJob(int first, int count) const
+{
+    const QVector<Rfmu2TestPlan::Step> steps = m_plan.steps.mid(first, count);
+    auto sa  = m_tool->spectrumAnalyzer();
+    auto na  = m_tool->networkAnalyzer();
+    auto sg  = m_tool->signalGenerator();
+    auto sys = m_tool->systemControl();
+
+    // Runs on the I/O thread
+    return [steps, sa, na, sg, sys]() -> Batch {
+        Batch out;
+        auto num  = [](const QJsonObject &a, const char *k, double d = 0.0) { return a.value(QLatin1String(k)).toDouble(d); };
+        auto str  = [](const QJsonObject &a, const char *k) { return a.value(QLatin1String(k)).toString(); };
+        auto list = [](const QJsonObject &a) {
+            QStringList l;
+            for (const QJsonValue &v : a.value(QLatin1String("ports")).toArray()) l.append(v.toString());
+            return l;
+        };
+
+        const Op op = steps.first().op;
+        if (op == Op::SaPeak || op == Op::SaRaw) {
+            const bool raw = (op == Op::SaRaw);
+            QVector<QByteArray> frames;
+            for (const auto &s : steps) {
+                const int f = qRound(num(s.args, "freqKHz"));
+                const int rx = qRound(num(s.args, "receive", 1));
+                frames.append(raw ? Rfmu2SpectrumAnalyzer::encodeRawRequest(f, num(s.args, "level"), rx, str(s.args, "port"))
+                                  : Rfmu2SpectrumAnalyzer::encodePeakRequest(f, num(s.args, "level"), rx, str(s.args, "port")));
+            }
+            const QVector<QVector<double>> results = sa->measureBatch(frames, raw, 2);
+            for (int i = 0; i < steps.size(); ++i) {
+                Outcome o;
+                o.ok = i < results.size();
+                if (o.ok) {
+                    o.labels = { str(steps[i].args, "port") };
+                    o.traces = { results[i] };
+                }
+                out.append(o);
+            }
+            return out;
+        }
+
+        const QJsonObject &a = steps.first().args;
+        Outcome o;
+        auto single = [&o](const QString &label, const QVector<double> &v) {
+            o.ok = !v.isEmpty();
+            if (o.ok) { o.labels = { label }; o.traces = { v }; }
+        };
+
+        switch (op) {
+        case Op::Clock:
+            o.ok = sys->setReferenceClockMode(a.value(QLatin1String("internal")).toBool(true));
+            break;
+        case Op::SgSingle:
+            o.ok = sg->configureSingleChannel(qRound(num(a, "freqKHz")), num(a, "level"), str(a, "port"));
+            break;
+        case Op::SgOff:
+            o.ok = sg->stopAllOutputs();
+            break;
+        case Op::NaConfigure: {
+            Rfmu2NetworkAnalyzer::SweepConfig c;
+            c.startKHz = qRound(num(a, "startKHz"));
+            c.stopKHz  = qRound(num(a, "stopKHz"));
+            c.startDb  = num(a, "startDb");
+            c.stopDb   = num(a, "stopDb");
+            c.points   = qRound(num(a, "points"));
+            c.port1    = str(a, "port1");
+            c.port2    = str(a, "port2");
+            o.ok = na->configureSweep(c);
+            break;
+        }
+        case Op::NaCalibrate:
+            o.ok = (na->*calTable().value(str(a, "step")))();
+            break;
+        case Op::NaMeasure: {
+            const auto type = resultType(str(a, "type"));
+            const bool dual = a.value(QLatin1String("dual")).toBool(false);
+            single(QString(), dual ? na->measureDualPort(type) : na->measureSinglePort(type));
+            break;
+        }
+        case Op::NaScan: {
+            Rfmu2NetworkAnalyzer::PortScan scan;
+            scan.ports    = list(a);
+            scan.port2    = str(a, "port2");
+            scan.points   = qRound(num(a, "points"));
+            scan.dualPort = a.value(QLatin1String("dual")).toBool(false);
+            scan.type     = resultType(str(a, "type"));
+            o.traces = na->scanPorts(scan);
+            o.labels = scan.ports.mid(0, o.traces.size());
+            o.ok = o.traces.size() == scan.ports.size();
+            break;
+        }
+        case Op::SaScan: {
+            const QStringList ports = list(a);
+            o.traces = sa->scanPorts(qRound(num(a, "freqKHz")), num(a, "level"),
+                                     qRound(num(a, "receive", 1)), ports);
+            o.labels = ports.mid(0, o.traces.size());
+            o.ok = o.traces.size() == ports.size();
+            break;
+        }
+        case Op::Voltages:
+            single(QStringLiteral("V1..V8,T"), sys->readVoltagesAndTemperature());
+            break;
+        default:
+            break;
+        }
+        out.append(o);
+        return out;
+    };
+}
+
+void Rfmu2Sequencer::onBatchDone(int first, int count, const Batch &batch)
+{
+    for (int i = 0; i < count; ++i) {
+        const int index = first + i;
+        const Rfmu2TestPlan::Step &step = m_plan.steps[index];
+        const Outcome o = i < batch.size() ? batch[i] : Outcome();
+        const bool keep = step.args.value(QLatin1String("keep")).toBool(false);
+
+        bool pass = o.ok;
+        QJsonArray traces;
+        for (int t = 0; t < o.traces.size(); ++t) {
+            const QVector<double> &v = o.traces[t];
+            QJsonObject trace { { "label", o.labels.value(t) }, { "n", int(v.size()) } };
+            if (!v.isEmpty()) {
+                trace.insert("min",  *std::min_element(v.cbegin(), v.cend()));
+                trace.insert("max",  *std::max_element(v.cbegin(), v.cend()));
+                trace.insert("mean", std::accumulate(v.cbegin(), v.cend(), 0.0) / v.size());
+            }
+            if (step.limits.enabled) {
+                double measured = 0.0;
+                const bool ok = step.limits.check(v, &measured);
+                trace.insert("measured", measured);
+                trace.insert("pass", ok);
+                pass = pass && ok;
+            }
+            if (keep) {
+                QJsonArray values;
+                for (double d : v) values.append(d);
+                trace.insert("values", values);
+            }
+            traces.append(trace);
+        }
+
+        ++m_summary.steps;
+        if (!o.ok)       ++m_summary.errors;
+        else if (pass)   ++m_summary.passed;
+        else             ++m_summary.failed;
+
+        writeRecord(index, step, o, pass, traces);
+        emit stepFinished(index, int(m_plan.steps.size()), pass);
+
+        if (!pass && step.abortOnFail && !m_stopping) {
+            m_stopping = true;
+            m_summary.aborted = true;
+            m_summary.error = tr("Step '%1' failed").arg(step.id);
+        }
+    }
+}
+
+void Rfmu2Sequencer::writeRecord(int index, const Rfmu2TestPlan::Step &step, const Outcome &outcome,
+                                 bool pass, const QJsonArray &traces)
+{
+    QJsonObject rec {
+        { "i",    index },
+        { "id",   step.id },
+        { "op",   Rfmu2TestPlan::opName(step.op) },
+        { "ok",   outcome.ok },
+        { "pass", pass },
+        { "ms",   m_clock.elapsed() },
+    };
+    if (!outcome.ok) {
+        rec.insert("error", m_lastInstrumentError.isEmpty() ? QStringLiteral("no valid response")
+                                                            : m_lastInstrumentError);
+        m_lastInstrumentError.clear();
+    }
+    // Last temperature the instrument reported (telemetry poller, manual read)
+    const Rfmu2Status st = m_tool->status();
+    if (!std::isnan(st.temperatureC)) {
+        rec.insert("tempC", std::round(st.temperatureC * 100.0) / 100.0);
+        rec.insert("tempAgeMs", double(QDateTime::currentMSecsSinceEpoch() - st.temperatureMs));
+    }
+    if (!traces.isEmpty())
+        rec.insert("traces", traces);
+    writeLine(rec);
+}
+
+void Rfmu2Sequencer::writeLine(const QJsonObject &obj)
+{
+    m_results.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    m_results.write("\n", 1);
+}
+
+void Rfmu2Sequencer::finish()
+{
+    m_summary.elapsedMs = m_clock.elapsed();
+    writeLine({ { "summary", QJsonObject {
+                    { "steps",   m_summary.steps },
+                    { "passed",  m_summary.passed },
+                    { "failed",  m_summary.failed },
+                    { "errors",  m_summary.errors },
+                    { "aborted", m_summary.aborted },
+                    { "error",   m_summary.error },
+                    { "ms",      m_summary.elapsedMs } } } });
+    m_results.close();
+
+    m_running = false;
+    ++m_generation;     // late completions and a pending delay are ignored
+    emit finished(m_summary);
+}
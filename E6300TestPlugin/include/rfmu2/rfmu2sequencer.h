@@ -0,0 +1,167 @@
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <limits>
+
+class Rfmu2Tool;
+
+/*---------------------------------------------------------------------------
+ * Rfmu2TestPlan – a declarative measurement recipe, read from JSON:
+ *
+ *   { "name": "rx-check",
+ *     "portLists": { "rx": ["01A", "01B", "01C"] },
+ *     "steps": [
+ *       { "op": "clock", "internal": true },
+ *       { "op": "forPorts", "ports": "rx", "var": "port", "steps": [
+ *           { "op": "sa.peak", "id": "peak@$port", "freqKHz": 2400000,
+ *             "level": 0, "receive": 1, "port": "$port",
+ *             "limits": { "min": -30, "max": 5, "reduce": "max" } } ] },
+ *       { "op": "loop", "count": 3, "steps": [ { "op": "na.measure", "type": "LogAmp" } ] }
+ *     ] }
+ *
+ * Operations: clock, sg.single, sg.off, na.configure, na.cal, na.measure,
+ * na.scan, sa.peak, sa.raw, sa.scan, voltages, delay; plus loop and
+ * forPorts, which are expanded when the plan is read ("$var" in any string
+ * is replaced by the loop counter or the port). "ports" takes an array or
+ * the name of a port list.
+ *
+ * A step with "limits" passes if every value – or the one value picked by
+ * "reduce" (max/min/mean) – lies within [min, max]; "offset"/"stride"
+ * select one component of interleaved data first. "abortOnFail": true
+ * ends the run when the step fails.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2TestPlan
+{
+    static constexpr int MaxSteps = 1'000'000;   // after expansion
+
+    enum class Op {
+        Clock, SgSingle, SgOff,
+        NaConfigure, NaCalibrate, NaMeasure, NaScan,
+        SaPeak, SaRaw, SaScan,
+        Voltages, Delay
+    };
+
+    struct Limits {
+        enum Reduce { All, Max, Min, Mean };
+
+        bool   enabled = false;
+        double min     = -std::numeric_limits<double>::infinity();
+        double max     =  std::numeric_limits<double>::infinity();
+        Reduce reduce  = All;
+        int    offset  = 0;
+        int    stride  = 1;
+
+        // measured: the reduced value; for All the first value outside
+        // the limits, or the largest one if there is none
+        bool check(const QVector<double> &values, double *measured) const;
+    };
+
+    struct Step {
+        Op          op = Op::Delay;
+        QString     id;
+        QJsonObject args;               // after loop/port substitution
+        Limits      limits;
+        bool        abortOnFail = false;
+    };
+
+    QString       name;
+    QVector<Step> steps;
+
+    static Rfmu2TestPlan fromJson(const QByteArray &json, QString *error = nullptr);
+    static Rfmu2TestPlan fromFile(const QString &path, QString *error = nullptr);
+
+    static QString opName(Op op);
+};
+
+/*---------------------------------------------------------------------------
+ * Rfmu2SequenceSummary – outcome of one run of a plan.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2SequenceSummary
+{
+    QString plan;
+    int     steps   = 0;        // executed
+    int     passed  = 0;
+    int     failed  = 0;        // measured, outside limits
+    int     errors  = 0;        // no valid answer from the instrument
+    qint64  elapsedMs = 0;
+    bool    aborted = false;
+    QString error;
+
+    bool allPassed() const { return !aborted && failed == 0 && errors == 0; }
+};
+
+Q_DECLARE_METATYPE(Rfmu2SequenceSummary)
+
+/*---------------------------------------------------------------------------
+ * Rfmu2Sequencer – runs a test plan against an Rfmu2Tool without any UI.
+ *
+ * Steps become jobs on the tool's I/O queue (Interactive priority). Up to
+ * MaxInFlight jobs are queued ahead, so the instrument goes straight from
+ * one step to the next while the previous result is checked and written
+ * here. Consecutive sa.peak / sa.raw steps are independent of each other
+ * and go out as one pipelined batch of up to MaxBatch requests. A step
+ * with abortOnFail, and any delay, waits for everything before it.
+ *
+ * Results are written as JSON lines: a header, one record per step, and a
+ * summary.
+ *---------------------------------------------------------------------------*/
+class Rfmu2Sequencer : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int MaxInFlight = 2;
+    static constexpr int MaxBatch    = 32;
+
+    explicit Rfmu2Sequencer(Rfmu2Tool *tool, QObject *parent = nullptr);
+
+    // false if a run is active or the results file cannot be opened
+    bool start(const Rfmu2TestPlan &plan, const QString &resultsPath);
+    void stop();            // after the jobs already queued
+    bool isRunning() const { return m_running; }
+    QString errorString() const { return m_errorString; }
+
+signals:
+    void stepFinished(int index, int count, bool pass);
+    void finished(const Rfmu2SequenceSummary &summary);
+
+private:
+    struct Outcome {
+        bool ok = false;
+        QStringList labels;                 // one per trace
+        QVector<QVector<double>> traces;
+    };
+    using Batch = QVector<Outcome>;
+
+    void pump();
+    int  batchLength(int first) const;
+    std::function<Batch()> makeJob(int first, int count) const;
+    void onBatchDone(int first, int count, const Batch &batch);
+    void writeRecord(int index, const Rfmu2TestPlan::Step &step, const Outcome &outcome,
+                     bool pass, const QJsonArray &traces);
+    void writeLine(const QJsonObject &obj);
+    void finish();
+
+    Rfmu2Tool      *m_tool;
+    Rfmu2TestPlan   m_plan;
+    QFile           m_results;
+    QElapsedTimer   m_clock;
+    Rfmu2SequenceSummary m_summary;
+    QString         m_errorString;
+    QString         m_lastInstrumentError;  // attached to the next failed step
+
+    int     m_next     = 0;         // first step not yet submitted
+    int     m_inFlight = 0;         // jobs queued on the I/O thread
+    bool    m_running  = false;
+    bool    m_stopping = false;
+    bool    m_barrier  = false;     // an abortOnFail step is outstanding
+    bool    m_delaying = false;
+    quint32 m_generation = 0;
+};
@@ -13,13 +13,12 @@ static inline auto levelParts(double db)
     return Rfmu2Base::splitDoubleAtDecimal(db);
 }
 
-bool Rfmu2SignalGenerator::configureSingleChannel(int freqKHz,
-                                                  double levelDbm,
-                                                  const QString &rfPort)
+QByteArray Rfmu2SignalGenerator::encodeSingleChannel(int freqKHz,
+                                                     double levelDbm,
+                                                     const QString &rfPort)
 {
     if (freqKHz <= 0)
-        return fail(Rfmu2Err::InternalLogic,
-                    QStringLiteral("Frequency must be >0"));
+        return QByteArray();
 
     auto parts = levelParts(levelDbm);
     QByteArray cmd;
@@ -32,16 +31,15 @@ bool Rfmu2SignalGenerator::configureSingleChannel(int freqKHz,
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return cmd;
 }
 
-bool Rfmu2SignalGenerator::configureTwoChannels(int f1KHz, double l1Dbm,
-                                                int f2KHz, double l2Dbm,
-                                                const QString &rfPort)
+QByteArray Rfmu2SignalGenerator::encodeTwoChannels(int f1KHz, double l1Dbm,
+                                                   int f2KHz, double l2Dbm,
+                                                   const QString &rfPort)
 {
     if (f1KHz <= 0 || f2KHz <= 0)
-        return fail(Rfmu2Err::InternalLogic,
-                    QStringLiteral("Frequencies must be >0"));
+        return QByteArray();
 
     auto p1 = levelParts(l1Dbm);
     auto p2 = levelParts(l2Dbm);
@@ -59,7 +57,29 @@ bool Rfmu2SignalGenerator::configureTwoChannels(int f1KHz, double l1Dbm,
         .append(int24ToBytes(FrameTailValue));
 
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return cmd;
+}
+
+bool Rfmu2SignalGenerator::configureSingleChannel(int freqKHz,
+                                                  double levelDbm,
+                                                  const QString &rfPort)
+{
+    if (freqKHz <= 0)
+        return fail(Rfmu2Err::InternalLogic,
+                    QStringLiteral("Frequency must be >0"));
+
+    return applyOutput(encodeSingleChannel(freqKHz, levelDbm, rfPort));
+}
+
+bool Rfmu2SignalGenerator::configureTwoChannels(int f1KHz, double l1Dbm,
+                                                int f2KHz, double l2Dbm,
+                                                const QString &rfPort)
+{
+    if (f1KHz <= 0 || f2KHz <= 0)
+        return fail(Rfmu2Err::InternalLogic,
+                    QStringLiteral("Frequencies must be >0"));
+
+    return applyOutput(encodeTwoChannels(f1KHz, l1Dbm, f2KHz, l2Dbm, rfPort));
 }
 
 bool Rfmu2SignalGenerator::stopAllOutputs()
@@ -69,7 +89,7 @@ bool Rfmu2SignalGenerator::stopAllOutputs()
         .append(char(0x08))
         .append(int24ToBytes(FrameTailValue));
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return applyOutput(cmd);
 }
 
 bool Rfmu2SignalGenerator::stopSingleOutput()
@@ -79,5 +99,5 @@ bool Rfmu2SignalGenerator::stopSingleOutput()
         .append(char(0x09))
         .append(int24ToBytes(FrameTailValue));
     cmd.insert(3, char(cmd.size() + 1));
-    return sendAndEcho(cmd);
+    return applyOutput(cmd);
 }
@@ -12,6 +12,9 @@ public:
     Rfmu2SignalGenerator(const Rfmu2SignalGenerator&)            = delete;
     Rfmu2SignalGenerator& operator=(const Rfmu2SignalGenerator&) = delete;
 
+    // applied-state slot: one output configuration at a time
+    enum StateSlot { SlotOutput };
+
     /* channel configuration */
     bool configureSingleChannel(int freqKHz, double levelDbm, const QString &rfPort);
     bool configureTwoChannels(int f1KHz, double l1Dbm,
@@ -21,4 +24,13 @@ public:
     /* control */
     bool stopAllOutputs();
     bool stopSingleOutput();
+
+    // Send a frame from one of the encoders below and keep it as the output state
+    bool applyOutput(const QByteArray &frame) { return applyState(SlotOutput, frame); }
+
+    /* frame encoders – empty on invalid input; send with sendAndEcho() */
+    static QByteArray encodeSingleChannel(int freqKHz, double levelDbm, const QString &rfPort);
+    static QByteArray encodeTwoChannels(int f1KHz, double l1Dbm,
+                                        int f2KHz, double l2Dbm,
+                                        const QString &rfPort);
 };
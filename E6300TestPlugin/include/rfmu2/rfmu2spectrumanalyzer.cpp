@@ -20,6 +20,7 @@ static QByteArray buildSaCmd(quint8 opcode,
                              int recvCh, quint8 measMode,
                              int rfPortChannel)
 {
+    Rfmu2TraceSpan span("encode");
     QByteArray cmd;
     cmd.append(Rfmu2Base::int24ToBytes(Rfmu2Base::FrameHeaderValue))
         .append(char(opcode))
@@ -45,8 +46,7 @@ QVector<double> Rfmu2SpectrumAnalyzer::measurePeakData(int freqKHz, double lvl,
     auto lv = lvlParts(lvl);
     QByteArray cmd = buildSaCmd(0x05, freqKHz, lv, 0, 0x01, channelForRfPort(rfPath));
 
-    if (!sendCommand(cmd)) return {};
-    QByteArray resp = receiveResponse();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())   return {};
 
     QByteArray payload = extractPayloadFromPackage(resp, 1);
@@ -57,14 +57,19 @@ QVector<double> Rfmu2SpectrumAnalyzer::measurePeakData(int freqKHz, double lvl,
     return bytesToDoubleVector(payload);
 }
 
+QByteArray Rfmu2SpectrumAnalyzer::encodePeakRequest(int freqKHz, double lvl,
+                                                    int recvCh,
+                                                    const QString &rfPath)
+{
+    return buildSaCmd(0x21, freqKHz, lvlParts(lvl), recvCh, 0x01, channelForRfPort(rfPath));
+}
+
 QVector<double> Rfmu2SpectrumAnalyzer::measurePeakData(int freqKHz, double lvl,
                                                        int recvCh,
                                                        const QString &rfPath)
 {
-    auto lv = lvlParts(lvl);
-    QByteArray cmd = buildSaCmd(0x21, freqKHz, lv, recvCh, 0x01, channelForRfPort(rfPath));
-    if (!sendCommand(cmd)) return {};
-    QByteArray resp = receiveResponse();
+    QByteArray cmd = encodePeakRequest(freqKHz, lvl, recvCh, rfPath);
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())   return {};
     QByteArray payload = extractPayloadFromPackage(resp, 1);
     if (payload.isEmpty()) {
@@ -80,8 +85,7 @@ QVector<double> Rfmu2SpectrumAnalyzer::measureRawData(int freqKHz, double lvl,
 {
     auto lv = lvlParts(lvl);
     QByteArray cmd = buildSaCmd(0x05, freqKHz, lv, 0, 0x02, channelForRfPort(rfPath));
-    if (!sendCommand(cmd)) return {};
-    QByteArray resp = receiveResponse();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())   return {};
     QByteArray payload = extractPayloadFromPackage(resp, 2);
     if (payload.isEmpty()) {
@@ -91,14 +95,19 @@ QVector<double> Rfmu2SpectrumAnalyzer::measureRawData(int freqKHz, double lvl,
     return bytesToDoubleVector(payload);
 }
 
+QByteArray Rfmu2SpectrumAnalyzer::encodeRawRequest(int freqKHz, double lvl,
+                                                   int recvCh,
+                                                   const QString &rfPath)
+{
+    return buildSaCmd(0x21, freqKHz, lvlParts(lvl), recvCh, 0x02, channelForRfPort(rfPath));
+}
+
 QVector<double> Rfmu2SpectrumAnalyzer::measureRawData(int freqKHz, double lvl,
                                                       int recvCh,
                                                       const QString &rfPath)
 {
-    auto lv = lvlParts(lvl);
-    QByteArray cmd = buildSaCmd(0x21, freqKHz, lv, recvCh, 0x02, channelForRfPort(rfPath));
-    if (!sendCommand(cmd)) return {};
-    QByteArray resp = receiveResponse();
+    QByteArray cmd = encodeRawRequest(freqKHz, lvl, recvCh, rfPath);
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())   return {};
     QByteArray payload = extractPayloadFromPackage(resp, 2);
     if (payload.isEmpty()) {
@@ -108,6 +117,38 @@ QVector<double> Rfmu2SpectrumAnalyzer::measureRawData(int freqKHz, double lvl,
     return bytesToDoubleVector(payload);
 }
 
+/* ---------------- port scan ---------------- */
+QVector<QVector<double>> Rfmu2SpectrumAnalyzer::scanPorts(int freqKHz, double lvl,
+                                                         int recvCh,
+                                                         const QStringList &rfPaths,
+                                                         int window)
+{
+    QVector<QByteArray> frames;
+    frames.reserve(rfPaths.size());
+    for (const QString &path : rfPaths)
+        frames.append(encodeRawRequest(freqKHz, lvl, recvCh, path));
+
+    return measureBatch(frames, true, window);
+}
+
+QVector<QVector<double>> Rfmu2SpectrumAnalyzer::measureBatch(const QVector<QByteArray> &requests,
+                                                            bool raw, int window)
+{
+    const QVector<QByteArray> responses = transactPipelined(requests, window);
+
+    QVector<QVector<double>> results;
+    results.reserve(responses.size());
+    for (int k = 0; k < responses.size(); ++k) {
+        const QByteArray payload = extractPayloadFromPackage(responses[k], raw ? 2 : 1);
+        if (payload.isEmpty()) {
+            fail(Rfmu2Err::Protocol, QStringLiteral("Payload empty for request %1").arg(k));
+            break;
+        }
+        results.append(bytesToDoubleVector(payload));
+    }
+    return results;
+}
+
 /* ---------------- IQ data ---------------- */
 QVector<Rfmu2Base::IQ> Rfmu2SpectrumAnalyzer::measureIqData(int freqKHz,
                                                             double lvl,
@@ -126,8 +167,7 @@ QVector<Rfmu2Base::IQ> Rfmu2SpectrumAnalyzer::measureIqData(int freqKHz,
         .append(int24ToBytes(FrameTailValue));
     cmd.insert(3, char(cmd.size() + 1));
 
-    if (!sendCommand(cmd)) return {};
-    QByteArray resp = receiveResponse();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())   return {};
 
     QByteArray payload = extractPayloadFromPackage(resp, 2);
@@ -1,6 +1,7 @@
 #pragma once
 #include "rfmu2base.h"
 #include <QTcpSocket>
+#include <QStringList>
 #include <QVector>
 
 class Rfmu2SpectrumAnalyzer : public Rfmu2Base
@@ -25,4 +26,20 @@ public:
 
     /* IQ stream (I,Q pairs) */
     QVector<IQ> measureIqData(int freqKHz, double levelDbm, const QString &rfPath);
+
+    /* the same raw measurement on each port in turn, requests pipelined
+       `window` deep; one trace per port, shorter list if the scan broke off */
+    QVector<QVector<double>> scanPorts(int freqKHz, double levelDbm, int receiveChannel,
+                                       const QStringList &rfPaths, int window = 2);
+
+    /* pre-encoded requests of one kind (all peak or all raw), pipelined
+       `window` deep; one result per request, shorter if it broke off */
+    QVector<QVector<double>> measureBatch(const QVector<QByteArray> &requests, bool raw,
+                                          int window = 2);
+
+    /* frame encoders for the receiver-channel requests (opcode 0x21) */
+    static QByteArray encodePeakRequest(int freqKHz, double levelDbm,
+                                        int receiveChannel, const QString &rfPath);
+    static QByteArray encodeRawRequest(int freqKHz, double levelDbm,
+                                       int receiveChannel, const QString &rfPath);
 };
@@ -0,0 +1,58 @@
+#include "rfmu2status.h"
+#include <cstring>
+
+void Rfmu2Status::copyText(const QString &text, char *dst, int capacity)
+{
+    QByteArray utf8 = text.toUtf8();
+    int n = qMin(int(utf8.size()), capacity - 1);
+    while (n > 0 && n < utf8.size() && (quint8(utf8[n]) & 0xC0) == 0x80)
+        --n;    // do not cut a multi-byte sequence in half
+    std::memcpy(dst, utf8.constData(), size_t(n));
+    std::memset(dst + n, 0, size_t(capacity - n));
+}
+
+// ---------------- board ----------------
+Rfmu2StatusBoard::Rfmu2StatusBoard()
+{
+    quint64 buf[Words] = {};
+    const Rfmu2Status initial;
+    std::memcpy(buf, &initial, sizeof(Rfmu2Status));
+    for (size_t i = 0; i < Words; ++i)
+        m_words[i].store(buf[i], std::memory_order_relaxed);
+}
+
+void Rfmu2StatusBoard::publish(const Rfmu2Status &status)
+{
+    quint64 buf[Words] = {};
+    std::memcpy(buf, &status, sizeof(Rfmu2Status));
+
+    const quint32 seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < Words; ++i)
+        m_words[i].store(buf[i], std::memory_order_relaxed);
+
+    m_seq.store(seq + 2, std::memory_order_release);
+}
+
+Rfmu2Status Rfmu2StatusBoard::read() const
+{
+    quint64 buf[Words];
+    for (;;) {
+        const quint32 before = m_seq.load(std::memory_order_acquire);
+        if (before & 1u)
+            continue;       // a publish is in progress; it is a short copy
+
+        for (size_t i = 0; i < Words; ++i)
+            buf[i] = m_words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    Rfmu2Status status;
+    std::memcpy(&status, buf, sizeof(Rfmu2Status));
+    return status;
+}
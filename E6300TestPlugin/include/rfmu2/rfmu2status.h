@@ -0,0 +1,73 @@
+#pragma once
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2Status – what the I/O layer last knew about the instrument and link.
+ *
+ * Plain data with fixed-size text fields, so a snapshot can be copied word
+ * by word without allocating.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2Status
+{
+    enum class Link : quint8 { Disconnected, Connected, Reconnecting };
+
+    static constexpr int HostBytes  = 64;   // incl. terminating zero
+    static constexpr int ErrorBytes = 192;
+
+    Link    link          = Link::Disconnected;
+    bool    busy          = false;      // a job is running on the I/O thread
+    bool    faulted       = false;      // the last finished job reported an error
+    quint16 port          = 0;
+    qint32  queued        = 0;          // jobs waiting, all priorities
+    qint32  lastErrorCode = -1;         // Rfmu2Err, -1 if none yet
+    qint64  updatedMs     = 0;          // ms since epoch
+    qint64  lastErrorMs   = 0;
+    qint64  latencyUs     = -1;         // smoothed time to first response byte
+    qint64  lastLatencyUs = -1;
+    double  temperatureC  = std::numeric_limits<double>::quiet_NaN();
+    qint64  temperatureMs = 0;          // when it was read; 0 if never
+    quint64 jobs          = 0;          // finished since the context was created
+    quint64 errors        = 0;
+    char    host[HostBytes]       = {};
+    char    lastError[ErrorBytes] = {}; // UTF-8, truncated
+
+    QString hostName() const        { return QString::fromUtf8(host); }
+    QString lastErrorText() const   { return QString::fromUtf8(lastError); }
+    void setHost(const QString &text)      { copyText(text, host, HostBytes); }
+    void setLastError(const QString &text) { copyText(text, lastError, ErrorBytes); }
+
+private:
+    static void copyText(const QString &text, char *dst, int capacity);
+};
+
+static_assert(std::is_trivially_copyable<Rfmu2Status>::value,
+              "Rfmu2Status is copied word by word");
+
+/*---------------------------------------------------------------------------
+ * Rfmu2StatusBoard – single-writer, many-reader publication of Rfmu2Status.
+ *
+ * A sequence lock: the writer (the I/O thread) makes the counter odd, stores
+ * the snapshot and makes it even again; a reader copies the snapshot between
+ * two reads of the counter and retries if they differ or were odd. Readers
+ * never block the writer or each other, and a read is a fixed-size copy.
+ * The snapshot is kept in atomic words, so the racing copy is well defined.
+ *---------------------------------------------------------------------------*/
+class Rfmu2StatusBoard
+{
+public:
+    Rfmu2StatusBoard();
+
+    Rfmu2Status read() const;               // any thread
+    void publish(const Rfmu2Status &status); // one writing thread only
+
+private:
+    static constexpr size_t Words = (sizeof(Rfmu2Status) + 7) / 8;
+
+    std::atomic<quint32>                 m_seq {0};
+    std::array<std::atomic<quint64>, Words> m_words;
+};
@@ -0,0 +1,265 @@
+#include "rfmu2sweephistory.h"
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+#include <limits>
+
+// ---------------- on-disk layout ----------------
+struct Rfmu2SweepHistory::FileHeader {
+    char    magic[8];          // "RFMUSWH1"
+    quint32 version;
+    quint32 slotStride;
+    quint32 capacity;
+    quint32 maxChannels;
+    quint32 maxPoints;
+    quint32 reserved;
+    quint64 nextSequence;      // sequence number the next append receives
+    char    padding[24];
+};
+
+struct Rfmu2SweepHistory::SlotHeader {
+    quint64 sequence;          // 0 = never written
+    qint64  timestampMs;
+    qint64  steadyMs;
+    quint32 channels;
+    quint32 points;
+    quint32 configSize;
+    quint32 reserved;
+    char    config[ConfigBytes];
+};
+
+static constexpr char    kMagic[8]   = {'R','F','M','U','S','W','H','1'};
+static constexpr quint32 kVersion    = 2;   // 2: key vector and steady stamp per sweep
+static constexpr qint64  kHeaderSize = 64;
+
+// ---------------- open / close ----------------
+Rfmu2SweepHistory::~Rfmu2SweepHistory()
+{
+    close();
+}
+
+bool Rfmu2SweepHistory::fail(const QString &msg)
+{
+    m_error = msg;
+    return false;
+}
+
+bool Rfmu2SweepHistory::open(const QString &path, int capacity, int maxChannels, int maxPoints)
+{
+    static_assert(sizeof(FileHeader) == kHeaderSize, "history header must stay 64 bytes");
+    static_assert(sizeof(SlotHeader) % sizeof(double) == 0, "sweep values must stay 8-byte aligned");
+
+    close();
+
+    if (capacity <= 0 || maxChannels <= 0 || maxPoints <= 0)
+        return fail(QStringLiteral("Invalid history geometry"));
+
+    const quint32 stride = quint32(sizeof(SlotHeader) + size_t(1 + maxChannels) * maxPoints * sizeof(double));
+    const qint64 fileSize = kHeaderSize + qint64(stride) * capacity;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite))
+        return fail(m_file.errorString());
+
+    // Reuse an existing ring only if it was laid out the same way.
+    bool reuse = false;
+    FileHeader existing {};
+    if (m_file.size() == fileSize && m_file.read(reinterpret_cast<char*>(&existing), kHeaderSize) == kHeaderSize) {
+        reuse = std::memcmp(existing.magic, kMagic, sizeof kMagic) == 0
+                && existing.version == kVersion
+                && existing.slotStride == stride
+                && existing.capacity == quint32(capacity)
+                && existing.maxChannels == quint32(maxChannels)
+                && existing.maxPoints == quint32(maxPoints);
+    }
+
+    if (!reuse && (!m_file.resize(0) || !m_file.resize(fileSize))) {
+        const QString err = m_file.errorString();
+        m_file.close();
+        return fail(err);
+    }
+
+    m_map = m_file.map(0, fileSize);
+    if (!m_map) {
+        const QString err = m_file.errorString();
+        m_file.close();
+        return fail(err);
+    }
+    m_header = reinterpret_cast<FileHeader*>(m_map);
+
+    if (!reuse) {
+        std::memset(m_map, 0, size_t(fileSize));
+        std::memcpy(m_header->magic, kMagic, sizeof kMagic);
+        m_header->version      = kVersion;
+        m_header->slotStride   = stride;
+        m_header->capacity     = quint32(capacity);
+        m_header->maxChannels  = quint32(maxChannels);
+        m_header->maxPoints    = quint32(maxPoints);
+        m_header->nextSequence = 1;
+    }
+
+    m_sessionClock.invalidate();
+    m_error.clear();
+    return true;
+}
+
+void Rfmu2SweepHistory::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_header = nullptr;
+    }
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+// ---------------- geometry ----------------
+int Rfmu2SweepHistory::capacity() const noexcept
+{
+    return m_header ? int(m_header->capacity) : 0;
+}
+
+int Rfmu2SweepHistory::size() const noexcept
+{
+    if (!m_header)
+        return 0;
+    return int(qMin<quint64>(m_header->nextSequence - 1, m_header->capacity));
+}
+
+quint64 Rfmu2SweepHistory::firstSequence() const noexcept
+{
+    return m_header->nextSequence - quint64(size());
+}
+
+uchar *Rfmu2SweepHistory::slotFor(quint64 sequence) const noexcept
+{
+    const quint64 slot = (sequence - 1) % m_header->capacity;
+    return m_map + kHeaderSize + slot * m_header->slotStride;
+}
+
+// ---------------- write ----------------
+bool Rfmu2SweepHistory::append(qint64 timestampMs, const QByteArray &config,
+                               const QVector<double> &keys,
+                               const QVector<QVector<double>> &channels)
+{
+    if (!m_header)
+        return fail(QStringLiteral("History not open"));
+    if (channels.isEmpty() || channels.size() > int(m_header->maxChannels))
+        return fail(QStringLiteral("Unsupported channel count %1").arg(channels.size()));
+
+    const int points = keys.size();
+    if (points > int(m_header->maxPoints))
+        return fail(QStringLiteral("Sweep has %1 points, history holds %2")
+                        .arg(points).arg(m_header->maxPoints));
+    for (const QVector<double> &channel : channels) {
+        if (channel.size() != points)
+            return fail(QStringLiteral("Channel has %1 points, key axis %2")
+                            .arg(channel.size()).arg(points));
+    }
+
+    // Steady stamp: a monotonic clock within the session, started from the
+    // wall clock but never below what an earlier session recorded.
+    const qint64 lastSteady = size() > 0 ? steadyAt(size() - 1) : std::numeric_limits<qint64>::min();
+    if (!m_sessionClock.isValid()) {
+        m_sessionStartMs = qMax(timestampMs, lastSteady);
+        m_sessionClock.start();
+    }
+    const qint64 steadyMs = qMax(lastSteady, m_sessionStartMs + m_sessionClock.elapsed());
+
+    const quint64 seq = m_header->nextSequence;
+    uchar *slot = slotFor(seq);
+    auto *hdr = reinterpret_cast<SlotHeader*>(slot);
+    auto *values = reinterpret_cast<double*>(slot + sizeof(SlotHeader));
+
+    // Invalidate first, fill, then publish the sequence number last.
+    hdr->sequence = 0;
+    hdr->timestampMs = timestampMs;
+    hdr->steadyMs = steadyMs;
+    hdr->channels = quint32(channels.size());
+    hdr->points = quint32(points);
+    hdr->configSize = quint32(qMin<int>(int(config.size()), ConfigBytes));
+    std::memcpy(hdr->config, config.constData(), hdr->configSize);
+
+    std::memcpy(values, keys.constData(), size_t(points) * sizeof(double));
+    for (int c = 0; c < channels.size(); ++c)
+        std::memcpy(values + size_t(1 + c) * points, channels[c].constData(), size_t(points) * sizeof(double));
+
+    hdr->sequence = seq;
+    m_header->nextSequence = seq + 1;
+    return true;
+}
+
+void Rfmu2SweepHistory::clear()
+{
+    if (!m_header)
+        return;
+    m_header->nextSequence = 1;
+}
+
+// ---------------- read ----------------
+bool Rfmu2SweepHistory::sweepAt(int index, Sweep &out) const
+{
+    if (!m_header || index < 0 || index >= size())
+        return false;
+
+    const quint64 seq = firstSequence() + quint64(index);
+    const uchar *slot = slotFor(seq);
+    const auto *hdr = reinterpret_cast<const SlotHeader*>(slot);
+    if (hdr->sequence != seq)
+        return false;
+
+    const auto *values = reinterpret_cast<const double*>(slot + sizeof(SlotHeader));
+    out.sequence = seq;
+    out.timestampMs = hdr->timestampMs;
+    out.steadyMs = hdr->steadyMs;
+    out.config = QByteArray(hdr->config, int(hdr->configSize));
+    out.keys = QVector<double>(values, values + hdr->points);
+    out.channels.resize(int(hdr->channels));
+    for (int c = 0; c < int(hdr->channels); ++c) {
+        const double *src = values + size_t(1 + c) * hdr->points;
+        out.channels[c] = QVector<double>(src, src + hdr->points);
+    }
+    return true;
+}
+
+qint64 Rfmu2SweepHistory::timestampAt(int index) const
+{
+    if (!m_header || index < 0 || index >= size())
+        return -1;
+    return reinterpret_cast<const SlotHeader*>(slotFor(firstSequence() + quint64(index)))->timestampMs;
+}
+
+qint64 Rfmu2SweepHistory::steadyAt(int index) const
+{
+    if (!m_header || index < 0 || index >= size())
+        return -1;
+    return reinterpret_cast<const SlotHeader*>(slotFor(firstSequence() + quint64(index)))->steadyMs;
+}
+
+int Rfmu2SweepHistory::indexAtTime(qint64 steadyMs) const
+{
+    const int n = size();
+    if (n == 0 || steadyMs < steadyAt(0))
+        return -1;
+
+    int lo = 0;
+    int hi = n - 1;
+    if (steadyMs >= steadyAt(hi))
+        return hi;
+
+    // Invariant: ts(lo) <= t < ts(hi). Probe where t would sit if the sweeps
+    // between lo and hi were evenly spaced in time.
+    while (hi - lo > 1) {
+        const qint64 tLo = steadyAt(lo);
+        const qint64 tHi = steadyAt(hi);
+        int probe = lo + int(double(steadyMs - tLo) / double(tHi - tLo) * (hi - lo));
+        probe = qBound(lo + 1, probe, hi - 1);
+        if (steadyAt(probe) <= steadyMs)
+            lo = probe;
+        else
+            hi = probe;
+    }
+    return lo;
+}
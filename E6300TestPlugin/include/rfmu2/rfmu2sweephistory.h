@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2SweepHistory – fixed-size ring of past sweeps in a memory-mapped file.
+ *
+ * Every slot has the same stride (slot header + (1 + maxChannels) ×
+ * maxPoints doubles: the key axis, then the channels), so recording is a
+ * memcpy into the mapping and lookup by sweep index is plain arithmetic.
+ *
+ * Each sweep carries two stamps. The wall-clock one is for display only;
+ * the steady one follows a monotonic clock within a session and starts at
+ * the wall clock (but never below the last sweep) when a session begins.
+ * Steady stamps never decrease, which lets indexAtTime() use interpolation
+ * search: constant time for a steady sweep rate, and it degrades gracefully
+ * when the rate varies. A wall-clock step cannot break the ordering.
+ *
+ * The file survives restarts; reopening it with the same geometry keeps the
+ * recorded sweeps, while different geometry starts a fresh ring.
+ *---------------------------------------------------------------------------*/
+class Rfmu2SweepHistory
+{
+public:
+    static constexpr int ConfigBytes = 192;   // per-sweep instrument settings (UTF-8)
+
+    struct Sweep {
+        quint64 sequence = 0;                 // 1-based, increases forever
+        qint64  timestampMs = 0;              // wall clock, ms since epoch; display only
+        qint64  steadyMs = 0;                 // never decreases; see above
+        QByteArray config;
+        QVector<double> keys;                 // key axis (Hz or dB), one per point
+        QVector<QVector<double>> channels;    // one array per recorded quantity
+    };
+
+    Rfmu2SweepHistory() = default;
+    ~Rfmu2SweepHistory();
+
+    Rfmu2SweepHistory(const Rfmu2SweepHistory&)            = delete;
+    Rfmu2SweepHistory& operator=(const Rfmu2SweepHistory&) = delete;
+
+    bool open(const QString &path, int capacity, int maxChannels, int maxPoints);
+    void close();
+    bool isOpen() const noexcept { return m_map != nullptr; }
+    QString errorString() const { return m_error; }
+
+    // Every channel must have as many points as keys
+    bool append(qint64 timestampMs, const QByteArray &config,
+                const QVector<double> &keys,
+                const QVector<QVector<double>> &channels);
+    void clear();
+
+    int capacity() const noexcept;
+    int size() const noexcept;                // retained sweeps, oldest = index 0
+
+    bool sweepAt(int index, Sweep &out) const;
+    qint64 timestampAt(int index) const;      // wall clock
+    qint64 steadyAt(int index) const;
+    int indexAtTime(qint64 steadyMs) const;   // latest sweep at or before, -1 if none
+
+private:
+    struct FileHeader;
+    struct SlotHeader;
+
+    quint64 firstSequence() const noexcept;
+    uchar *slotFor(quint64 sequence) const noexcept;
+    bool fail(const QString &msg);
+
+    QFile m_file;
+    QElapsedTimer m_sessionClock;             // started by the first append after open()
+    qint64 m_sessionStartMs = 0;              // steady stamp at that append
+    uchar *m_map = nullptr;
+    FileHeader *m_header = nullptr;
+    QString m_error;
+};
@@ -0,0 +1,183 @@
+#include "rfmu2sweepscheduler.h"
+#include "rfmu2signalgenerator.h"
+#include "Rfmu2IoContext.h"
+
+#include <QThread>
+#include <QTimer>
+
+static const int _rfmu2_sweepplan_metatype_id =
+    qRegisterMetaType<Rfmu2SweepPlan>("Rfmu2SweepPlan");
+static const int _rfmu2_sweepreport_metatype_id =
+    qRegisterMetaType<Rfmu2SweepReport>("Rfmu2SweepReport");
+
+// ---------------- plan ----------------
+Rfmu2SweepPlan Rfmu2SweepPlan::linear(double startFreqHz, double stopFreqHz,
+                                      double startLvlDbm, double stopLvlDbm,
+                                      int points, int intervalMs,
+                                      const QString &rfPort)
+{
+    Rfmu2SweepPlan plan;
+    plan.rfPort = rfPort;
+    if (points < 1)
+        return plan;
+
+    const double span = points > 1 ? double(points - 1) : 1.0;
+    const double fStepHz = (stopFreqHz - startFreqHz) / span;
+    const double lStep   = (stopLvlDbm - startLvlDbm) / span;
+
+    plan.steps.resize(points);
+    for (int i = 0; i < points; ++i) {
+        Step &s = plan.steps[i];
+        s.freqKHz  = static_cast<int>(qRound64((startFreqHz + i * fStepHz) / 1'000.0));
+        s.levelDbm = startLvlDbm + i * lStep;
+        s.dwellMs  = intervalMs;
+    }
+    return plan;
+}
+
+// ---------------- report ----------------
+qint64 Rfmu2SweepReport::maxLateUs() const
+{
+    qint64 worst = 0;
+    for (const Step &s : steps)
+        worst = qMax(worst, s.achievedUs - s.requestedUs);
+    return worst;
+}
+
+qint64 Rfmu2SweepReport::meanAbsErrorUs() const
+{
+    if (steps.isEmpty())
+        return 0;
+    qint64 sum = 0;
+    for (const Step &s : steps)
+        sum += qAbs(s.achievedUs - s.requestedUs);
+    return sum / steps.size();
+}
+
+// ---------------- scheduler ----------------
+Rfmu2SweepScheduler::Rfmu2SweepScheduler(Rfmu2IoContext *io, Rfmu2SignalGenerator *sg)
+    : QObject(io), m_io(io), m_sg(sg)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &Rfmu2SweepScheduler::postStep);
+}
+
+void Rfmu2SweepScheduler::start(const Rfmu2SweepPlan &plan)
+{
+    QMetaObject::invokeMethod(this, [this, plan]() { begin(plan); }, Qt::QueuedConnection);
+}
+
+void Rfmu2SweepScheduler::stop()
+{
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_active)
+            finish(false, tr("Stopped"));
+    }, Qt::QueuedConnection);
+}
+
+void Rfmu2SweepScheduler::begin(const Rfmu2SweepPlan &plan)
+{
+    if (m_active)
+        finish(false, tr("Superseded by a new sweep"));
+
+    m_report = Rfmu2SweepReport();
+    m_report.plannedSteps = plan.steps.size();
+
+    // Encode everything up front; nothing is built between deadlines.
+    m_frames.clear();
+    m_deadlinesNs.clear();
+    m_frames.reserve(plan.steps.size());
+    m_deadlinesNs.reserve(plan.steps.size());
+
+    qint64 dueNs = 0;
+    for (const Rfmu2SweepPlan::Step &s : plan.steps) {
+        const QByteArray frame = Rfmu2SignalGenerator::encodeSingleChannel(s.freqKHz, s.levelDbm, plan.rfPort);
+        if (frame.isEmpty()) {
+            m_report.error = tr("Step %1 has an invalid frequency").arg(m_frames.size());
+            emit sweepFinished(m_report);
+            return;
+        }
+        m_frames.append(frame);
+        m_deadlinesNs.append(dueNs);
+        dueNs += qint64(qMax(0, s.dwellMs)) * 1'000'000;
+    }
+
+    if (m_frames.isEmpty()) {
+        m_report.completed = true;
+        emit sweepFinished(m_report);
+        return;
+    }
+
+    m_active = true;
+    m_next   = 0;
+    ++m_generation;
+    m_clock.start();
+    armNext();
+}
+
+void Rfmu2SweepScheduler::armNext()
+{
+    if (m_next >= m_frames.size()) {
+        finish(true, QString());
+        return;
+    }
+
+    const qint64 remainingUs = (m_deadlinesNs[m_next] - m_clock.nsecsElapsed()) / 1'000;
+    const qint64 wakeMs = (remainingUs - SpinMarginUs) / 1'000;
+    if (wakeMs <= 0)
+        postStep();
+    else
+        m_timer->start(int(wakeMs));
+}
+
+void Rfmu2SweepScheduler::postStep()
+{
+    const quint32 generation = m_generation;
+    m_io->post(Rfmu2Priority::Interactive, [this, generation]() { runStep(generation); });
+}
+
+void Rfmu2SweepScheduler::runStep(quint32 generation)
+{
+    if (!m_active || generation != m_generation)
+        return;
+
+    const int index = m_next;
+    const qint64 deadlineNs = m_deadlinesNs[index];
+    while (m_clock.nsecsElapsed() < deadlineNs)
+        QThread::yieldCurrentThread();
+
+    Rfmu2SweepReport::Step timing;
+    timing.requestedUs = deadlineNs / 1'000;
+    timing.achievedUs  = m_clock.nsecsElapsed() / 1'000;
+
+    const QByteArray frame = m_frames[index];   // stop() may clear m_frames during the echo wait
+    const bool ok = m_sg->applyOutput(frame);
+    if (generation != m_generation)
+        return;     // stopped while waiting for the echo
+
+    timing.ok = ok;
+    m_report.steps.append(timing);
+    emit stepApplied(index, m_frames.size(), timing.achievedUs - timing.requestedUs);
+
+    ++m_next;
+    if (!ok) {
+        finish(false, tr("Step %1 was not acknowledged").arg(index));
+        return;
+    }
+    armNext();
+}
+
+void Rfmu2SweepScheduler::finish(bool completed, const QString &error)
+{
+    m_timer->stop();
+    m_active = false;
+    ++m_generation;
+    m_frames.clear();
+    m_deadlinesNs.clear();
+
+    m_report.completed = completed;
+    m_report.error     = error;
+    emit sweepFinished(m_report);
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+class QTimer;
+class Rfmu2IoContext;
+class Rfmu2SignalGenerator;
+
+/*---------------------------------------------------------------------------
+ * Rfmu2SweepPlan – the steps of a signal-generator step sweep.
+ *
+ * Step i is applied dwellMs of step i-1 after step i-1 was due (not after it
+ * was actually sent), so deadlines are fixed relative to the start of the
+ * sweep and a late step never shifts the ones behind it.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2SweepPlan
+{
+    struct Step {
+        int    freqKHz  = 0;
+        double levelDbm = 0.0;
+        int    dwellMs  = 0;        // until the next step is due
+    };
+
+    QString       rfPort;
+    QVector<Step> steps;
+
+    // Frequency or level ramp with a fixed interval
+    static Rfmu2SweepPlan linear(double startFreqHz, double stopFreqHz,
+                                 double startLvlDbm, double stopLvlDbm,
+                                 int points, int intervalMs,
+                                 const QString &rfPort);
+};
+
+/*---------------------------------------------------------------------------
+ * Rfmu2SweepReport – requested vs. achieved timing of every step that was
+ * attempted. Times are in microseconds from the start of the sweep.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2SweepReport
+{
+    struct Step {
+        qint64 requestedUs = 0;
+        qint64 achievedUs  = 0;     // when the frame was handed to the socket
+        bool   ok          = false; // echo received
+    };
+
+    QVector<Step> steps;
+    int     plannedSteps = 0;
+    bool    completed    = false;
+    QString error;
+
+    qint64 maxLateUs() const;
+    qint64 meanAbsErrorUs() const;
+};
+
+Q_DECLARE_METATYPE(Rfmu2SweepPlan)
+Q_DECLARE_METATYPE(Rfmu2SweepReport)
+
+/*---------------------------------------------------------------------------
+ * Rfmu2SweepScheduler – runs a sweep plan on the I/O thread.
+ *
+ * All frames are encoded before the first step. Each step is then posted to
+ * the I/O queue at Interactive priority by a precise timer that wakes
+ * SpinMarginUs ahead of the deadline; the job spins out the remainder on the
+ * monotonic clock, so the frame leaves as close to its deadline as the
+ * queue allows. A step that is not echoed ends the sweep.
+ *---------------------------------------------------------------------------*/
+class Rfmu2SweepScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int SpinMarginUs = 1500;
+
+    // Lives on the I/O thread: create it as a child of the context.
+    Rfmu2SweepScheduler(Rfmu2IoContext *io, Rfmu2SignalGenerator *sg);
+
+    /* thread-safe – both are carried out on the I/O thread */
+    void start(const Rfmu2SweepPlan &plan);
+    void stop();
+
+signals:
+    void stepApplied(int index, int count, qint64 lateUs);
+    void sweepFinished(const Rfmu2SweepReport &report);
+
+private:
+    void begin(const Rfmu2SweepPlan &plan);
+    void armNext();
+    void postStep();
+    void runStep(quint32 generation);
+    void finish(bool completed, const QString &error);
+
+    Rfmu2IoContext       *m_io;
+    Rfmu2SignalGenerator *m_sg;
+    QTimer               *m_timer = nullptr;
+
+    QElapsedTimer        m_clock;          // monotonic, started at step 0
+    QVector<QByteArray>  m_frames;         // pre-encoded, one per step
+    QVector<qint64>      m_deadlinesNs;
+    int                  m_next = 0;
+    bool                 m_active = false;
+    quint32              m_generation = 0; // stale timer/queue entries compare unequal
+    Rfmu2SweepReport     m_report;
+};
@@ -1,6 +1,9 @@
 #include "rfmu2systemcontrol.h"
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QSettings>
 #include <QtEndian>
+#include <cstring>
 
 namespace {
 constexpr quint32 kHdr = 0x5A5A5A;          // 3-byte frame header
@@ -16,6 +19,8 @@ Rfmu2SystemControl::Rfmu2SystemControl(QTcpSocket *s, QObject *p)
     m_timeoutMs = 5'000;    // quick housekeeping commands
 }
 
+Rfmu2SystemControl::~Rfmu2SystemControl() = default;
+
 /*-----------------------------------------------------------
  * Reference clock (function 0x19, mode byte)
  *----------------------------------------------------------*/
@@ -29,7 +34,7 @@ bool Rfmu2SystemControl::setReferenceClockMode(bool useInternal)
         .append(int24ToBytes(FrameTailValue));
     cmd.insert(3, char(cmd.size() + 1));
 
-    return sendAndEcho(cmd);
+    return applyState(SlotReferenceClock, cmd);
 }
 
 /*-----------------------------------------------------------
@@ -43,10 +48,7 @@ QVector<double> Rfmu2SystemControl::readVoltagesAndTemperature()
         .append(int24ToBytes(FrameTailValue));
     cmd.insert(3, char(cmd.size() + 1));
 
-    if (!sendCommand(cmd))
-        return {};
-
-    QByteArray resp = receiveResponse();
+    QByteArray resp = transact(cmd);
     if (resp.isEmpty())
         return {};
 
@@ -63,17 +65,20 @@ QVector<double> Rfmu2SystemControl::readVoltagesAndTemperature()
         return {};
     }
     vals.resize(9); // trim any extra data
+    emit telemetryRead(vals);
     return vals; // [V1..V8, Temp]
 }
 
 /*-----------------------------------------------------------
  * RRSU-TX calibration upload  (function 0x01)
+ *
+ * Head (0x0A) and tail (0x0C) frames are acknowledged; middle
+ * frames (0x0B) are not, so they are streamed back to back.
+ * Frames are encoded one at a time into a reused buffer.
  *----------------------------------------------------------*/
-bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QString &channelStr)
+bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QString &channelStr,
+                                             const Rfmu2UploadControl &control)
 {
-    qDebug() << "[RRSU] === upload start === size" << data.size()
-    << "bytes  chan" << channelStr;
-
     /* -------------- sanity --------------------------------- */
     if (data.isEmpty() || data.size() > 0xFFFF) {
         qDebug() << "[RRSU] blob out of range" << data.size();
@@ -90,87 +95,94 @@ bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QStri
     }
     const quint8 channel = quint8(ch);
 
+    /* -------------- unchanged table ------------------------ */
+    // The frames carry no offset (head gives the total, the device checks
+    // the whole table on the tail), so a changed table always goes out in
+    // full; only an identical one can be skipped.
+    const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    const bool known = m_rrsuSession.value(channel) == hash
+                       || (control.trustEarlierSessions
+                           && m_rrsuCached.value(m_identity).value(channel) == hash);
+    if (!control.force && known) {
+        qDebug() << "[RRSU] chan" << channelStr << "already has this table - upload skipped";
+        if (control.skipped)
+            *control.skipped = true;
+        return true;
+    }
+    // Unknown until the upload is acknowledged; a NACK on the head or tail
+    // means the device holds something else, so no entry may survive it
+    rememberRRSUCalibration(channel, {});
+
     /* -------------- constants ------------------------------ */
-    constexpr int    kMaxPayload   = 1000;
-    constexpr quint8 kFuncCode     = kFuncCalibration;   // 0x01
-
-    /* ========================================================
-     * 1. Build *all* packets first (len / remain placeholders)
-     * ====================================================== */
-    struct Packet { QByteArray bytes; };
-    QList<Packet> pkts;
-
-    auto makeFrame = [&](quint8 type, const QByteArray &payload) {
-        QByteArray frame;
-        frame.append(int24ToBytes(kHdr)); // header (3)
-        frame.append("\0\0", 2); // length placeholder (2)
-        frame.append(char(kFuncCode))
-            .append(char(type))
-            .append("\0\0", 2) // remain placeholder (2)
-            .append(char(channel))
-            .append(payload)
-            .append(int24ToBytes(kTlr)); // tail (3)
-        const quint16 len = quint16(frame.size());
-        qToBigEndian(len, frame.data() + 3); // patch length
-        return frame;
-    };
+    constexpr int    kMaxPayload = 1000;
+    constexpr int    kOverhead   = 13;          // hdr 3, len 2, func, type, remain 2, chan, tail 3
+    constexpr qint64 kWindow     = 16 * 1024;   // unsent bytes allowed in the socket
+    constexpr quint8 kFuncCode   = kFuncCalibration;   // 0x01
 
-    int off = 0;
-    while (off < data.size()) {
-        const int  chunk = std::min(kMaxPayload, data.size() - off);
-        const bool first = (off == 0);
-        const bool last  = (off + chunk == data.size());
-        const quint8 typ = first ? 0x0A : (last ? 0x0C : 0x0B);
-        pkts.append({ makeFrame(typ, data.mid(off, chunk)) });
-        off += chunk;
-    }
+    const int    frames = (data.size() + kMaxPayload - 1) / kMaxPayload;
+    const qint64 total  = qint64(frames) * kOverhead + data.size();
 
-    if (pkts.isEmpty()) {
-        qDebug() << "[RRSU] internal error - no packets";
-        fail(Rfmu2Err::InternalLogic, QStringLiteral("no packets generated"));
-        return false;
-    }
+    qDebug() << "[RRSU] === upload start === size" << data.size()
+             << "bytes  chan" << channelStr << " frames" << frames << " wire bytes" << total;
 
-    /* ========================================================
-     * 2. Patch remain field for every packet
-     * ====================================================== */
-    qsizetype bytesRemainingAll = 0;
-    for (const auto &p : pkts) bytesRemainingAll += p.bytes.size();
-
-    qsizetype bytesProcessed = 0;
-    for (auto &p : pkts) {
-        const bool isTail = (p.bytes[6] == char(0x0C));   // type at index 6
-        quint16 remainVal = isTail ? quint16(p.bytes.size())
-                                   : quint16(bytesRemainingAll - bytesProcessed);
-        p.bytes[7] = char(remainVal >> 8);
-        p.bytes[8] = char(remainVal & 0xFF);
-        bytesProcessed += p.bytes.size();
-    }
+    Rfmu2TraceSpan span("rrsuUpload");
 
-    qDebug() << "[RRSU] prepared" << pkts.size() << "frames, total bytes"
-             << bytesRemainingAll;
+    const QByteArray hdr = int24ToBytes(kHdr);
+    const QByteArray tlr = int24ToBytes(kTlr);
+    QByteArray frame;
+    frame.reserve(kMaxPayload + kOverhead);     // reserved: truncate() keeps the buffer
 
-    /* ========================================================
-     * 3. Send packets - ACK for head & tail only
-     * ====================================================== */
-    for (int i = 0; i < pkts.size(); ++i) {
-        const Packet &pkt = pkts[i];
-        const quint8  typeByte = quint8(pkt.bytes[6]);
-        const quint16 remain   = quint16(quint8(pkt.bytes[7]) << 8 | quint8(pkt.bytes[8]));
+    // Encode frame i into `frame`; `sent` is the wire bytes before it.
+    auto encode = [&](int i, qint64 sent) -> quint8 {
+        const int    off   = i * kMaxPayload;
+        const int    chunk = std::min(kMaxPayload, data.size() - off);
+        const bool   first = (i == 0);
+        const bool   last  = (i == frames - 1);
+        const quint8 type  = first ? 0x0A : (last ? 0x0C : 0x0B);
+        const quint16 len    = quint16(chunk + kOverhead);
+        const quint16 remain = (type == 0x0C) ? len : quint16(total - sent);
 
-        qDebug() << "[RRSU] TX" << i << "type" << QString("0x%1").arg(typeByte,2,16,QChar('0'))
-                 << "len" << pkt.bytes.size() << "remain" << remain;
-        qDebug().noquote() << "RAW" << pkt.bytes.toHex(' ');
+        frame.truncate(0);
+        frame.append(hdr)                               // header (3)
+            .append(char(len >> 8)).append(char(len & 0xFF))
+            .append(char(kFuncCode))
+            .append(char(type))
+            .append(char(remain >> 8)).append(char(remain & 0xFF))
+            .append(char(channel))
+            .append(data.constData() + off, chunk)
+            .append(tlr);                               // tail (3)
+        return type;
+    };
 
-        if (!sendCommand(pkt.bytes)) {
-            qDebug() << "[RRSU] sendCommand failed at frame" << i;
+    /* -------------- send - ACK for head & tail only -------- */
+    qint64 sent = 0;
+    for (int i = 0; i < frames; ++i) {
+        if (control.cancel && control.cancel->load(std::memory_order_relaxed)) {
+            qDebug() << "[RRSU] cancelled after" << i << "of" << frames << "frames";
             return false;
         }
 
+        const quint8 typeByte = encode(i, sent);
+
         if (typeByte == 0x0B) { // middle - no ACK expected
+            if (!streamCommand(frame, kWindow)) {
+                qDebug() << "[RRSU] stream write failed at frame" << i;
+                return false;
+            }
+            sent += frame.size();
+            if (control.progress)
+                control.progress(sent, total);
             continue;
         }
 
+        qDebug() << "[RRSU] TX" << i << "type" << QString("0x%1").arg(typeByte,2,16,QChar('0'))
+                 << "len" << frame.size();
+
+        if (!sendCommand(frame)) {
+            qDebug() << "[RRSU] sendCommand failed at frame" << i;
+            return false;
+        }
+
         QByteArray ack = receiveResponse();
         qDebug() << "[RRSU] ACK size" << ack.size();
         if (ack.isEmpty()) {
@@ -179,7 +191,8 @@ bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QStri
         }
 
         // framing quick-check
-        if (ack.left(3) != int24ToBytes(rHdr) ||
+        if (ack.size() < 9 ||
+            ack.left(3) != int24ToBytes(rHdr) ||
             ack.right(3) != int24ToBytes(rTlr) ||
             ack[4] != char(kFuncCode))
         {
@@ -190,7 +203,7 @@ bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QStri
 
         if (typeByte == 0x0A) {
             const quint16 echoedLen = qFromBigEndian<quint16>(ack.constData() + 5);
-            const quint16 ourTotal  = quint16(bytesRemainingAll);
+            const quint16 ourTotal  = quint16(total);
             qDebug() << "[RRSU] head-ACK length dev:" << echoedLen << " ours:" << ourTotal;
             if (echoedLen != ourTotal) {
                 fail(Rfmu2Err::Protocol,
@@ -207,8 +220,140 @@ bool Rfmu2SystemControl::sendRRSUCalibration(const QByteArray &data, const QStri
                 return false;
             }
         }
+
+        sent += frame.size();
+        if (control.progress)
+            control.progress(sent, total);
     }
 
+    rememberRRSUCalibration(channel, hash);
     qDebug() << "[RRSU] === upload done (OK) ===";
     return true;
 }
+
+/*-----------------------------------------------------------
+ * RRSU upload cache
+ *
+ * INI file, one group per instrument identity, one key per
+ * channel holding the hex SHA-1 of its acknowledged table.
+ * Written through on every change, so a crash mid-upload
+ * still leaves the channel forgotten.
+ *----------------------------------------------------------*/
+void Rfmu2SystemControl::setInstrumentIdentity(const QString &identity)
+{
+    m_identity = identity;
+    m_rrsuSession.clear();
+}
+
+void Rfmu2SystemControl::setRRSUCalibrationCache(const QString &path)
+{
+    m_rrsuCache = std::make_unique<QSettings>(path, QSettings::IniFormat);
+    m_rrsuCached.clear();
+
+    const QStringList instruments = m_rrsuCache->childGroups();
+    for (const QString &identity : instruments) {
+        m_rrsuCache->beginGroup(identity);
+        const QStringList keys = m_rrsuCache->childKeys();
+        for (const QString &key : keys) {
+            bool ok = false;
+            const uint channel = key.toUInt(&ok);
+            const QByteArray hash = QByteArray::fromHex(m_rrsuCache->value(key).toByteArray());
+            if (ok && channel <= 0x0F && hash.size() == 20)
+                m_rrsuCached[identity].insert(quint8(channel), hash);
+        }
+        m_rrsuCache->endGroup();
+    }
+}
+
+void Rfmu2SystemControl::rememberRRSUCalibration(quint8 channel, const QByteArray &hash)
+{
+    for (ChannelHashes *known : { &m_rrsuSession, &m_rrsuCached[m_identity] }) {
+        if (hash.isEmpty())
+            known->remove(channel);
+        else
+            known->insert(channel, hash);
+    }
+
+    if (!m_rrsuCache || m_identity.isEmpty())
+        return;
+    m_rrsuCache->beginGroup(m_identity);
+    if (hash.isEmpty())
+        m_rrsuCache->remove(QString::number(channel));
+    else
+        m_rrsuCache->setValue(QString::number(channel), hash.toHex());
+    m_rrsuCache->endGroup();
+    m_rrsuCache->sync();
+}
+
+/*-----------------------------------------------------------
+ * RRSU calibration CSV  ->  upload blob
+ *
+ * Works on the raw bytes: one memchr per line and field, no
+ * QString conversion. Blank lines are skipped, columns past
+ * the second are ignored.
+ *----------------------------------------------------------*/
+bool Rfmu2SystemControl::parseRRSUCalibrationCsv(const QByteArray &csv, QByteArray &blob, QString *error)
+{
+    auto isBlank = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    auto toDouble = [&](const char *b, const char *e, bool *ok) {
+        while (b < e && isBlank(*b))     ++b;
+        while (e > b && isBlank(e[-1]))  --e;
+        if (b == e) { *ok = false; return 0.0; }
+        return QByteArray::fromRawData(b, int(e - b)).toDouble(ok);   // C locale
+    };
+    auto setError = [error](int line, const QString &what) {
+        if (error)
+            *error = QStringLiteral("line %1: %2").arg(line).arg(what);
+        return false;
+    };
+
+    blob.clear();
+    blob.reserve(2 * int(csv.count('\n') + 1));
+
+    const char *p   = csv.constData();
+    const char *end = p + csv.size();
+    if (csv.startsWith("\xEF\xBB\xBF"))     // UTF-8 BOM
+        p += 3;
+
+    for (int line = 1; p < end; ++line) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+        if (!eol)
+            eol = end;
+
+        const char *q = p;
+        while (q < eol && isBlank(*q))
+            ++q;
+        if (q == eol) {                     // empty line
+            p = eol + 1;
+            continue;
+        }
+
+        const char *comma = static_cast<const char *>(memchr(p, ',', size_t(eol - p)));
+        if (!comma)
+            return setError(line, QStringLiteral("expected frequency,attenuation"));
+        const char *fieldEnd = static_cast<const char *>(memchr(comma + 1, ',', size_t(eol - comma - 1)));
+        if (!fieldEnd)
+            fieldEnd = eol;
+
+        bool freqOk = false, attOk = false;
+        toDouble(p, comma, &freqOk);        // unused, but must parse
+        const double attenuation = toDouble(comma + 1, fieldEnd, &attOk);
+        if (!freqOk || !attOk)
+            return setError(line, QStringLiteral("not a number"));
+
+        if (blob.size() + 2 > 0xFFFF)
+            return setError(line, QStringLiteral("too many rows for one upload"));
+
+        const QPair<qint8, qint8> split = splitDoubleAtDecimal(attenuation);
+        blob.append(toByte(split.first));
+        blob.append(toByte(split.second));
+        p = eol + 1;
+    }
+
+    if (blob.isEmpty()) {
+        if (error)
+            *error = QStringLiteral("no calibration rows");
+        return false;
+    }
+    return true;
+}
@@ -1,19 +1,72 @@
 #pragma once
 #include "rfmu2base.h"
+#include <QHash>
 #include <QTcpSocket>
 #include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QSettings;
+
+// Progress and cancel for long uploads. Both are used on the I/O thread:
+// progress(sent, total) after every frame, in bytes on the wire; cancel is
+// polled between frames.
+struct Rfmu2UploadControl {
+    std::function<void(qint64 sent, qint64 total)> progress;
+    const std::atomic<bool> *cancel = nullptr;
+    bool  force   = false;      // send even if the channel already has this table
+    bool  trustEarlierSessions = false;   // also skip on a table recorded before this session
+    bool *skipped = nullptr;    // set to true when the upload was skipped as unchanged
+};
 
 class Rfmu2SystemControl : public Rfmu2Base
 {
     Q_OBJECT
 public:
     explicit Rfmu2SystemControl(QTcpSocket *socket, QObject *parent = nullptr);
-    ~Rfmu2SystemControl() override = default;
+    ~Rfmu2SystemControl() override;
 
     Rfmu2SystemControl(const Rfmu2SystemControl&)            = delete;
     Rfmu2SystemControl& operator=(const Rfmu2SystemControl&) = delete;
 
+    // applied-state slots, in replay order
+    enum StateSlot { SlotReferenceClock };
+
     bool setReferenceClockMode(bool useInternal);        // true = internal
     QVector<double> readVoltagesAndTemperature();        // 8V + 1T
-    bool sendRRSUCalibration(const QByteArray &data, const QString &channel);
+
+    // Returns false on failure or when cancelled; a cancel stops before the
+    // tail frame and is not reported through errorOccurred().
+    bool sendRRSUCalibration(const QByteArray &data, const QString &channel,
+                             const Rfmu2UploadControl &control = {});
+
+    // "frequency,attenuation" rows -> upload blob (two bytes per row).
+    // Fails at the first malformed row, which `error` names.
+    static bool parseRRSUCalibrationCsv(const QByteArray &csv, QByteArray &blob,
+                                        QString *error = nullptr);
+
+    // The last table each RRSU channel acknowledged in this session is
+    // remembered as a content hash, and an identical upload is skipped. A
+    // failed or cancelled upload forgets the channel. With a cache file the
+    // hashes are also kept per instrument across sessions, but those only
+    // skip an upload when the caller trusts them: the identity is just the
+    // endpoint, and a swapped or power-cycled unit behind it looks the same.
+    void setRRSUCalibrationCache(const QString &path);
+    // Selects whose cached hashes apply and starts a new session
+    void setInstrumentIdentity(const QString &identity);
+    // The unit may have restarted or been swapped while the link was down
+    void forgetRRSUSession() { m_rrsuSession.clear(); }
+
+signals:
+    void telemetryRead(const QVector<double> &values);   // every successful readVoltagesAndTemperature()
+
+private:
+    void rememberRRSUCalibration(quint8 channel, const QByteArray &hash);  // empty: forget
+
+    using ChannelHashes = QHash<quint8, QByteArray>;     // channel -> SHA-1 of the acknowledged blob
+    ChannelHashes                 m_rrsuSession;         // acknowledged since the link came up
+    QHash<QString, ChannelHashes> m_rrsuCached;          // by instrument identity, all sessions
+    QString                       m_identity;
+    std::unique_ptr<QSettings>    m_rrsuCache;
 };
@@ -0,0 +1,293 @@
+#include "rfmu2telemetrylog.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr quint32 FileMagic   = 0x314C5452;   // "RTL1"
+constexpr quint32 FileVersion = 1;
+
+struct FileHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 channels;
+    quint32 resolutionMs;
+};
+
+constexpr qint64 TierResolutionMs[] = { 0, 60 * 1000, 15 * 60 * 1000 };
+constexpr int    TierCapacity[]     = { Rfmu2TelemetryLog::RawCapacity,
+                                        Rfmu2TelemetryLog::MinuteCapacity,
+                                        Rfmu2TelemetryLog::QuarterCapacity };
+
+int recordBytes(int channels)
+{
+    return int(sizeof(qint64) + sizeof(quint32)) + 3 * channels * int(sizeof(float));
+}
+} // namespace
+
+Rfmu2TelemetryLog::Rfmu2TelemetryLog(int channels)
+{
+    reset(qMax(1, channels));
+}
+
+Rfmu2TelemetryLog::~Rfmu2TelemetryLog()
+{
+    close();
+}
+
+void Rfmu2TelemetryLog::reset(int channels)
+{
+    m_channels = channels;
+    for (int t = 0; t < TierCount; ++t) {
+        Ring &r = m_tiers[t];
+        r.resolutionMs = TierResolutionMs[t];
+        r.capacity = TierCapacity[t];
+        r.first = 0;
+        r.size  = 0;
+        r.startMs.fill(0, r.capacity);
+        r.count.fill(0, r.capacity);
+        r.values.fill(0.0f, r.capacity * 3 * channels);
+        m_open[t] = Bucket();
+    }
+    m_latestMs = 0;
+    m_latest.clear();
+}
+
+// ---------------- rings ----------------
+void Rfmu2TelemetryLog::Ring::push(qint64 ms, quint32 n, const float *v, int channels)
+{
+    int s;
+    if (size < capacity) {
+        s = slot(size);
+        ++size;
+    } else {
+        s = first;                              // overwrite the oldest
+        first = (first + 1) % capacity;
+    }
+    startMs[s] = ms;
+    count[s]   = n;
+    std::memcpy(values.data() + s * 3 * channels, v, size_t(3 * channels) * sizeof(float));
+}
+
+void Rfmu2TelemetryLog::accumulate(Bucket &b, quint32 n, const float *v)
+{
+    if (b.count == 0) {
+        b.min.fill(std::numeric_limits<double>::infinity(), m_channels);
+        b.sum.fill(0.0, m_channels);
+        b.max.fill(-std::numeric_limits<double>::infinity(), m_channels);
+    }
+    for (int ch = 0; ch < m_channels; ++ch) {
+        b.min[ch]  = qMin(b.min[ch], double(v[ch]));
+        b.sum[ch] += double(v[m_channels + ch]) * n;
+        b.max[ch]  = qMax(b.max[ch], double(v[2 * m_channels + ch]));
+    }
+    b.count += n;
+}
+
+void Rfmu2TelemetryLog::closeBucket(Tier tier)
+{
+    Bucket &b = m_open[tier];
+    if (b.startMs >= 0 && b.count > 0) {
+        QVector<float> v(3 * m_channels);
+        for (int ch = 0; ch < m_channels; ++ch) {
+            v[ch]                  = float(b.min[ch]);
+            v[m_channels + ch]     = float(b.sum[ch] / b.count);
+            v[2 * m_channels + ch] = float(b.max[ch]);
+        }
+        m_tiers[tier].push(b.startMs, b.count, v.constData(), m_channels);
+        if (tier == Minute && m_file.isOpen())
+            writeRecord(b.startMs, b.count, v.constData());
+    }
+    b = Bucket();
+}
+
+void Rfmu2TelemetryLog::append(qint64 ms, const QVector<double> &values)
+{
+    if (values.size() < m_channels)
+        return;
+
+    QVector<float> v(3 * m_channels);
+    for (int ch = 0; ch < m_channels; ++ch)
+        v[ch] = v[m_channels + ch] = v[2 * m_channels + ch] = float(values[ch]);
+
+    m_tiers[Raw].push(ms, 1, v.constData(), m_channels);
+    for (Tier tier : { Minute, Quarter }) {
+        const qint64 start = ms - ms % m_tiers[tier].resolutionMs;
+        if (m_open[tier].startMs != start) {
+            closeBucket(tier);
+            m_open[tier].startMs = start;
+        }
+        accumulate(m_open[tier], 1, v.constData());
+    }
+
+    m_latestMs = ms;
+    m_latest = values.mid(0, m_channels);
+}
+
+void Rfmu2TelemetryLog::clear()
+{
+    reset(m_channels);
+    if (m_file.isOpen()) {
+        const FileHeader h { FileMagic, FileVersion, quint32(m_channels), quint32(TierResolutionMs[Minute]) };
+        m_file.resize(0);
+        m_file.seek(0);
+        m_file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        m_file.flush();
+    }
+}
+
+// ---------------- queries ----------------
+QVector<Rfmu2TelemetryLog::Point> Rfmu2TelemetryLog::series(Tier tier, int channel,
+                                                           qint64 fromMs, qint64 toMs) const
+{
+    QVector<Point> out;
+    if (channel < 0 || channel >= m_channels)
+        return out;
+
+    const Ring &r = m_tiers[tier];
+    out.reserve(r.size + 1);
+    for (int i = 0; i < r.size; ++i) {
+        const int s = r.slot(i);
+        const qint64 ms = r.startMs[s];
+        if (ms + r.resolutionMs < fromMs || ms > toMs)
+            continue;
+        const float *v = r.values.constData() + s * 3 * m_channels;
+        out.append({ ms, r.count[s], v[channel], v[m_channels + channel], v[2 * m_channels + channel] });
+    }
+
+    // The interval still being filled, so the newest minutes show up at once
+    const Bucket &b = m_open[tier];
+    if (tier != Raw && b.startMs >= 0 && b.count > 0 && b.startMs <= toMs)
+        out.append({ b.startMs, b.count, float(b.min[channel]),
+                     float(b.sum[channel] / b.count), float(b.max[channel]) });
+    return out;
+}
+
+QVector<Rfmu2TelemetryLog::Point> Rfmu2TelemetryLog::series(int channel, qint64 fromMs, qint64 toMs) const
+{
+    auto oldest = [this](int t) {
+        const Ring &r = m_tiers[t];
+        if (r.size > 0)
+            return r.startMs[r.slot(0)];
+        return m_open[t].startMs >= 0 ? m_open[t].startMs : std::numeric_limits<qint64>::max();
+    };
+
+    // Finest tier reaching back far enough, else the one reaching furthest
+    int best = Raw;
+    for (int t = Raw; t < TierCount; ++t) {
+        if (oldest(t) <= fromMs)
+            return series(Tier(t), channel, fromMs, toMs);
+        if (oldest(t) < oldest(best))
+            best = t;
+    }
+    return series(Tier(best), channel, fromMs, toMs);
+}
+
+// ---------------- file ----------------
+bool Rfmu2TelemetryLog::fail(const QString &msg)
+{
+    m_error = msg;
+    if (m_file.isOpen())
+        m_file.close();
+    return false;
+}
+
+bool Rfmu2TelemetryLog::open(const QString &path)
+{
+    close();
+    reset(m_channels);
+    m_error.clear();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite))
+        return fail(m_file.errorString());
+    return load();
+}
+
+void Rfmu2TelemetryLog::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool Rfmu2TelemetryLog::writeRecord(qint64 ms, quint32 n, const float *v)
+{
+    QByteArray rec(recordBytes(m_channels), Qt::Uninitialized);
+    char *p = rec.data();
+    std::memcpy(p, &ms, sizeof(ms));
+    std::memcpy(p + sizeof(ms), &n, sizeof(n));
+    std::memcpy(p + sizeof(ms) + sizeof(n), v, size_t(3 * m_channels) * sizeof(float));
+
+    if (m_file.write(rec) != rec.size() || !m_file.flush())
+        return fail(m_file.errorString());
+    return true;
+}
+
+bool Rfmu2TelemetryLog::load()
+{
+    const QByteArray data = m_file.readAll();
+    const int recBytes = recordBytes(m_channels);
+
+    FileHeader h {};
+    bool valid = data.size() >= int(sizeof(h));
+    if (valid) {
+        std::memcpy(&h, data.constData(), sizeof(h));
+        valid = h.magic == FileMagic && h.version == FileVersion
+                && h.channels == quint32(m_channels)
+                && h.resolutionMs == quint32(TierResolutionMs[Minute]);
+    }
+
+    int records = valid ? int((data.size() - int(sizeof(h))) / recBytes) : 0;
+    const char *base = data.constData() + sizeof(h);
+    auto recordMs = [&](int i) {
+        qint64 ms;
+        std::memcpy(&ms, base + qint64(i) * recBytes, sizeof(ms));
+        return ms;
+    };
+
+    // Only what the quarter tier can hold is worth keeping
+    int firstKept = 0;
+    if (records > 0) {
+        const qint64 horizon = recordMs(records - 1)
+                               - qint64(QuarterCapacity) * TierResolutionMs[Quarter];
+        while (firstKept < records && recordMs(firstKept) < horizon)
+            ++firstKept;
+    }
+
+    for (int i = firstKept; i < records; ++i) {
+        const char *p = base + qint64(i) * recBytes;
+        qint64 ms;
+        quint32 n;
+        std::memcpy(&ms, p, sizeof(ms));
+        std::memcpy(&n, p + sizeof(ms), sizeof(n));
+        QVector<float> values(3 * m_channels);              // the record may be unaligned
+        std::memcpy(values.data(), p + sizeof(ms) + sizeof(n), size_t(values.size()) * sizeof(float));
+
+        m_tiers[Minute].push(ms, n, values.constData(), m_channels);
+        const qint64 quarter = ms - ms % TierResolutionMs[Quarter];
+        if (m_open[Quarter].startMs != quarter) {
+            closeBucket(Quarter);
+            m_open[Quarter].startMs = quarter;
+        }
+        accumulate(m_open[Quarter], n, values.constData());
+    }
+
+    // Rewrite when the header is foreign, history was trimmed or the last
+    // record was cut short (crash mid-write); otherwise just append.
+    const qint64 exactSize = qint64(sizeof(h)) + qint64(records) * recBytes;
+    if (!valid || firstKept > 0 || data.size() != exactSize) {
+        QByteArray kept;
+        h = { FileMagic, FileVersion, quint32(m_channels), quint32(TierResolutionMs[Minute]) };
+        kept.append(reinterpret_cast<const char *>(&h), sizeof(h));
+        if (valid)
+            kept.append(base + qint64(firstKept) * recBytes, (records - firstKept) * recBytes);
+        if (!m_file.resize(0) || !m_file.seek(0) || m_file.write(kept) != kept.size() || !m_file.flush())
+            return fail(m_file.errorString());
+    } else {
+        m_file.seek(m_file.size());
+    }
+    return true;
+}
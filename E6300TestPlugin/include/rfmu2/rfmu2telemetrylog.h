@@ -0,0 +1,103 @@
+#pragma once
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2TelemetryLog – time series of the supply voltages and temperature.
+ *
+ * Three tiers of fixed-size rings, each point holding min / mean / max of
+ * every channel over its interval:
+ *
+ *      raw       every sample              RawCapacity points
+ *      minute    1 min buckets, 24 h       MinuteCapacity
+ *      quarter   15 min buckets, 31 days   QuarterCapacity
+ *
+ * Values are stored as float (the readings carry ~4 significant digits), so
+ * a point costs 12 bytes + 12 per channel. series() answers from the finest
+ * tier that still reaches back to the requested start.
+ *
+ * Closed minute buckets are appended to a binary file; open() reads it back
+ * (rebuilding the quarter tier from it) so the long history survives
+ * restarts. The file is trimmed to QuarterCapacity × 15 minutes on open.
+ * Not thread-safe: use it from one thread.
+ *---------------------------------------------------------------------------*/
+class Rfmu2TelemetryLog
+{
+public:
+    static constexpr int RawCapacity     = 3600;
+    static constexpr int MinuteCapacity  = 24 * 60;
+    static constexpr int QuarterCapacity = 31 * 24 * 4;
+
+    enum Tier { Raw, Minute, Quarter, TierCount };
+
+    struct Point {
+        qint64 ms    = 0;       // start of the interval (sample time for Raw)
+        quint32 count = 0;      // samples merged into it
+        float min  = 0.0f;
+        float mean = 0.0f;
+        float max  = 0.0f;
+    };
+
+    explicit Rfmu2TelemetryLog(int channels = 9);
+    ~Rfmu2TelemetryLog();
+
+    Rfmu2TelemetryLog(const Rfmu2TelemetryLog&)            = delete;
+    Rfmu2TelemetryLog& operator=(const Rfmu2TelemetryLog&) = delete;
+
+    // Replaces the history in memory with what `path` holds and keeps
+    // appending closed minutes to it.
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+
+    int channels() const noexcept { return m_channels; }
+    void append(qint64 ms, const QVector<double> &values);
+    void clear();                                    // memory and file
+
+    bool isEmpty() const noexcept { return m_tiers[Raw].size == 0 && m_tiers[Minute].size == 0; }
+    qint64 latestMs() const noexcept { return m_latestMs; }
+    QVector<double> latest() const { return m_latest; }
+
+    // Oldest first, covering [fromMs, toMs] at the finest tier available
+    QVector<Point> series(int channel, qint64 fromMs, qint64 toMs) const;
+    QVector<Point> series(Tier tier, int channel, qint64 fromMs, qint64 toMs) const;
+
+private:
+    struct Ring {
+        qint64  resolutionMs = 0;
+        int     capacity = 0;
+        int     first = 0;               // index of the oldest point
+        int     size  = 0;
+        QVector<qint64>  startMs;
+        QVector<quint32> count;
+        QVector<float>   values;         // per point: min[ch], mean[ch], max[ch]
+
+        void push(qint64 ms, quint32 n, const float *v, int channels);
+        int  slot(int i) const { return (first + i) % capacity; }
+    };
+
+    struct Bucket {                      // the interval still being filled
+        qint64 startMs = -1;
+        quint32 count  = 0;
+        QVector<double> min, sum, max;
+    };
+
+    void reset(int channels);
+    void accumulate(Bucket &b, quint32 n, const float *v);
+    void closeBucket(Tier tier);
+    bool writeRecord(qint64 ms, quint32 n, const float *v);
+    bool load();
+    bool fail(const QString &msg);
+
+    int m_channels = 0;
+    Ring   m_tiers[TierCount];
+    Bucket m_open[TierCount];            // [Raw] unused
+    qint64 m_latestMs = 0;
+    QVector<double> m_latest;
+
+    QFile   m_file;
+    QString m_error;
+};
@@ -0,0 +1,57 @@
+#include "rfmu2telemetrypoller.h"
+#include "rfmu2tool.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+Rfmu2TelemetryPoller::Rfmu2TelemetryPoller(Rfmu2Tool *tool, QObject *parent)
+    : QObject(parent),
+    m_tool(tool),
+    m_timer(new QTimer(this))
+{
+    m_timer->setInterval(m_intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &Rfmu2TelemetryPoller::poll);
+}
+
+void Rfmu2TelemetryPoller::setIntervalMs(int ms)
+{
+    m_intervalMs = qMax(MinIntervalMs, ms);
+    m_timer->setInterval(m_intervalMs);
+}
+
+void Rfmu2TelemetryPoller::start()
+{
+    m_timer->start();
+    poll();
+}
+
+void Rfmu2TelemetryPoller::stop()
+{
+    m_timer->stop();
+}
+
+bool Rfmu2TelemetryPoller::isRunning() const noexcept
+{
+    return m_timer->isActive();
+}
+
+void Rfmu2TelemetryPoller::poll()
+{
+    if (!m_tool || m_pending || !m_tool->isConnected() || m_tool->isReconnecting())
+        return;
+
+    m_pending = true;
+    m_tool->submit(Rfmu2Priority::Telemetry,
+        [sys = m_tool->systemControl()]() { return sys->readVoltagesAndTemperature(); },
+        this, [this](const QVector<double> &values) {
+            m_pending = false;
+            if (values.isEmpty()) {
+                ++m_failures;
+                emit pollFailed();
+                return;
+            }
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            m_log.append(now, values);
+            emit sampled(now, values);
+        });
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include "rfmu2telemetrylog.h"
+
+class QTimer;
+class Rfmu2Tool;
+
+/*---------------------------------------------------------------------------
+ * Rfmu2TelemetryPoller – reads supply voltages and temperature in the
+ * background and keeps them in an Rfmu2TelemetryLog.
+ *
+ * Reads go out at Telemetry priority, at most one at a time, so they only
+ * run when no Interactive or Streaming job is queued (or once per
+ * Rfmu2IoContext::StarvationLimit jobs under a free-running sweep: one
+ * short round trip). While the link is down ticks are skipped. Failed
+ * reads are counted here; they are not reported as hardware errors.
+ *
+ * Lives on the thread that created it (normally the GUI thread).
+ *---------------------------------------------------------------------------*/
+class Rfmu2TelemetryPoller : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int MinIntervalMs     = 250;
+    static constexpr int DefaultIntervalMs = 5000;
+
+    explicit Rfmu2TelemetryPoller(Rfmu2Tool *tool, QObject *parent = nullptr);
+
+    void setIntervalMs(int ms);
+    int  intervalMs() const noexcept { return m_intervalMs; }
+
+    void start();
+    void stop();
+    bool isRunning() const noexcept;
+
+    Rfmu2TelemetryLog       &log()       noexcept { return m_log; }
+    const Rfmu2TelemetryLog &log() const noexcept { return m_log; }
+
+    int failures() const noexcept { return m_failures; }
+
+signals:
+    void sampled(qint64 ms, const QVector<double> &values);   // [V1..V8, Temp]
+    void pollFailed();
+
+private slots:
+    void poll();
+
+private:
+    QPointer<Rfmu2Tool> m_tool;
+    QTimer            *m_timer;
+    Rfmu2TelemetryLog  m_log;
+    int                m_intervalMs = DefaultIntervalMs;
+    bool               m_pending = false;   // a read is queued or running
+    int                m_failures = 0;
+};
@@ -3,30 +3,47 @@
 
 Rfmu2Tool::Rfmu2Tool(QObject *parent) : QObject(parent)
 {
-    mSocket = new QTcpSocket(this);
-    connect(mSocket, &QAbstractSocket::stateChanged,
-            this, &Rfmu2Tool::onSocketStateChanged);
+    qRegisterMetaType<Rfmu2Error>("Rfmu2Error");
 
-    /* share one socket instance across all functional modules */
-    mSignalGenerator   = new Rfmu2SignalGenerator(mSocket, this);
-    mSpectrumAnalyzer  = new Rfmu2SpectrumAnalyzer(mSocket, this);
-    mNetworkAnalyzer   = new Rfmu2NetworkAnalyzer(mSocket, this);
-    mSystemControl     = new Rfmu2SystemControl(mSocket, this);
+    /* one socket shared by all functional modules, owned by the I/O thread */
+    m_ioThread = new QThread(this);
+    m_ioThread->setObjectName(QStringLiteral("Rfmu2Io"));
+    m_io = new Rfmu2IoContext;              // no parent: it is moved to m_ioThread
+    m_io->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_io, &QObject::deleteLater);
 
-    for (auto src : { static_cast<Rfmu2Base*>(mSignalGenerator),
-                     static_cast<Rfmu2Base*>(mSpectrumAnalyzer),
-                     static_cast<Rfmu2Base*>(mNetworkAnalyzer),
-                     static_cast<Rfmu2Base*>(mSystemControl) })
+    /* both are emitted on the I/O thread and arrive here queued */
+    connect(m_io, &Rfmu2IoContext::connectionStateChanged,
+            this, &Rfmu2Tool::connectionStateChanged);
+    connect(m_io, &Rfmu2IoContext::linkLost,     this, &Rfmu2Tool::linkLost);
+    connect(m_io, &Rfmu2IoContext::reconnecting, this, &Rfmu2Tool::reconnecting);
+    connect(m_io, &Rfmu2IoContext::linkRestored, this, &Rfmu2Tool::linkRestored);
+
+    for (auto src : { static_cast<Rfmu2Base*>(m_io->signalGenerator()),
+                     static_cast<Rfmu2Base*>(m_io->spectrumAnalyzer()),
+                     static_cast<Rfmu2Base*>(m_io->networkAnalyzer()),
+                     static_cast<Rfmu2Base*>(m_io->systemControl()),
+                     static_cast<Rfmu2Base*>(m_io->scalarAnalyzer()) })
     {
+        // While the link is down every request fails; linkLost() already
+        // said why, so those errors are not passed on one by one. Failed
+        // background reads are left to whoever polls (and the status board).
         connect(src, &Rfmu2Base::errorOccurred,
-                this, &Rfmu2Tool::errorOccurred);
+                this, [this](const Rfmu2Error &error) {
+                    if (!isReconnecting() && !error.background)
+                        emit errorOccurred(error);
+                });
     }
+
+    m_ioThread->start();
 }
 
 Rfmu2Tool::~Rfmu2Tool()
 {
-    if (mSocket && mSocket->isOpen())
-        mSocket->abort();
+    // The context (and with it the socket, which aborts the link) is
+    // deleted on the I/O thread once its event loop has stopped.
+    m_ioThread->quit();
+    m_ioThread->wait();
 }
 
 bool Rfmu2Tool::connectToHost(const QString &addr, int port)
@@ -37,9 +54,18 @@ bool Rfmu2Tool::connectToHost(const QString &addr, int port)
         return false;
     }
 
-    mSocket->abort();
-    mSocket->connectToHost(addr, port);
-    if (!mSocket->waitForConnected(2000)) {
+    QTcpSocket *socket = m_io->socket();
+    Rfmu2IoContext *io = m_io;
+    const bool ok = call([io, socket, addr, port]() {
+        io->endSession();
+        socket->abort();
+        socket->connectToHost(addr, port);
+        if (!socket->waitForConnected(Rfmu2IoContext::ConnectTimeoutMs))
+            return false;
+        io->beginSession(addr, quint16(port));
+        return true;
+    });
+    if (!ok) {
         emit errorOccurred({Rfmu2Err::Timeout,
                             tr("Failed to connect to %1:%2").arg(addr).arg(port)});
         return false;
@@ -49,16 +75,45 @@ bool Rfmu2Tool::connectToHost(const QString &addr, int port)
 
 void Rfmu2Tool::disconnectFromHost()
 {
-    if (mSocket->state() == QAbstractSocket::ConnectedState)
-        mSocket->disconnectFromHost();
+    QTcpSocket *socket = m_io->socket();
+    Rfmu2IoContext *io = m_io;
+    call([io, socket]() {
+        io->endSession();
+        if (socket->state() == QAbstractSocket::ConnectedState)
+            socket->disconnectFromHost();
+    });
 }
 
-void Rfmu2Tool::onSocketStateChanged(QAbstractSocket::SocketState state)
+bool Rfmu2Tool::isConnected() const noexcept
 {
-    emit connectionStateChanged(state == QAbstractSocket::ConnectedState);
+    return m_io && m_io->isConnected();
 }
 
-bool Rfmu2Tool::isConnected() const noexcept
+// ---------------- re-entrancy ----------------
+bool Rfmu2Tool::deferWhileInCall(QObject *context, std::function<void()> fn)
+{
+    if (m_callDepth == 0)
+        return false;
+    m_deferred.append({ QPointer<QObject>(context), std::move(fn) });
+    return true;
+}
+
+void Rfmu2Tool::leaveCall()
 {
-    return mSocket && (mSocket->state() == QAbstractSocket::ConnectedState);
+    // Run from the event loop, not from inside the caller's stack frame
+    if (--m_callDepth == 0 && !m_deferred.isEmpty())
+        QMetaObject::invokeMethod(this, [this]() { runDeferred(); }, Qt::QueuedConnection);
+}
+
+void Rfmu2Tool::runDeferred()
+{
+    if (m_callDepth > 0)
+        return;     // another call() began meanwhile; it flushes when it returns
+
+    const auto pending = std::move(m_deferred);
+    m_deferred.clear();
+    for (const auto &entry : pending) {
+        if (entry.first)
+            entry.second();
+    }
 }
@@ -3,10 +3,44 @@
 #include "rfmu2spectrumanalyzer.h"
 #include "rfmu2networkanalyzer.h"
 #include "rfmu2systemcontrol.h"
+#include "rfmu2scalaranalyzer.h"
+#include "rfmu2sweepscheduler.h"
+#include "Rfmu2IoContext.h"
+#include "rfmu2trace.h"
 
 #include <QObject>
-#include <QTcpSocket>
+#include <QEventLoop>
+#include <QPointer>
+#include <QThread>
+#include <QVector>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
+/*---------------------------------------------------------------------------
+ * Rfmu2Tool – front end to the instrument.
+ *
+ * The socket and all modules live in an Rfmu2IoContext on a dedicated I/O
+ * thread; nothing outside that thread touches them directly. Work reaches
+ * them in one of two ways:
+ *
+ *   call(priority, fn)                      blocks the caller until fn ran
+ *   submit(priority, fn, receiver, done)    returns at once; done(result)
+ *                                           runs later on receiver's thread
+ *
+ * fn receives nothing and may use the module accessors below, e.g.
+ *   tool->call([na = tool->networkAnalyzer()] { return na->calibrateSinglePortOpen(); });
+ *
+ * While call() waits, its nested event loop still runs timers and queued
+ * events. submit() results that land meanwhile are held back until the
+ * outermost call() returned; timer-driven slots that would act on the
+ * caller's half-updated state hold themselves back with deferWhileInCall().
+ *
+ * After connectToHost() succeeded, a dropped link is re-established in the
+ * background and the last applied settings are restored (linkLost() ...
+ * linkRestored()); disconnectFromHost() ends that.
+ *---------------------------------------------------------------------------*/
 class Rfmu2Tool : public QObject
 {
     Q_OBJECT
@@ -18,26 +52,137 @@ public:
     Rfmu2Tool& operator=(const Rfmu2Tool&) = delete;
 
     bool isConnected() const noexcept;
+    bool isReconnecting() const noexcept { return m_io && m_io->isLinkDown(); }
+
+    // Latest status snapshot; thread-safe, never waits on the I/O queue
+    Rfmu2Status status() const { return m_io->status(); }
+    // Transport counters and per-command round trips; thread-safe
+    const Rfmu2Metrics &metrics() const { return m_io->metrics(); }
     bool connectToHost(const QString &address, int port);
     void disconnectFromHost();
 
-    /* module accessors */
-    Rfmu2SignalGenerator   *signalGenerator()   const noexcept { return mSignalGenerator; }
-    Rfmu2SpectrumAnalyzer  *spectrumAnalyzer()  const noexcept { return mSpectrumAnalyzer; }
-    Rfmu2NetworkAnalyzer   *networkAnalyzer()   const noexcept { return mNetworkAnalyzer; }
-    Rfmu2SystemControl     *systemControl()     const noexcept { return mSystemControl; }
+    /* module accessors – dereference only inside call()/submit() */
+    Rfmu2SignalGenerator   *signalGenerator()   const noexcept { return m_io->signalGenerator(); }
+    Rfmu2SpectrumAnalyzer  *spectrumAnalyzer()  const noexcept { return m_io->spectrumAnalyzer(); }
+    Rfmu2NetworkAnalyzer   *networkAnalyzer()   const noexcept { return m_io->networkAnalyzer(); }
+    Rfmu2SystemControl     *systemControl()     const noexcept { return m_io->systemControl(); }
+    Rfmu2ScalarAnalyzer    *scalarAnalyzer()    const noexcept { return m_io->scalarAnalyzer(); }
+
+    // start()/stop() are thread-safe; connect to its signals from any thread
+    Rfmu2SweepScheduler    *sweepScheduler()    const noexcept { return m_io->sweepScheduler(); }
+
+    Rfmu2IoContext *ioContext() const noexcept { return m_io; }
+
+    // Run fn on the I/O thread and return its result. The calling thread
+    // keeps repainting and processing timers meanwhile, but user input is
+    // held back until the request completes. For startup, modal and
+    // user-triggered paths; anything periodic uses submit().
+    template <typename Fn>
+    auto call(Rfmu2Priority priority, Fn fn) -> decltype(fn());
+
+    template <typename Fn>
+    auto call(Fn fn) -> decltype(fn()) { return call(Rfmu2Priority::Interactive, std::move(fn)); }
+
+    // Queue fn on the I/O thread; done(result) – or done() for void – is
+    // invoked afterwards, unless receiver is gone. receiver must live on
+    // the tool's thread.
+    template <typename Fn, typename Done>
+    void submit(Rfmu2Priority priority, Fn fn, QObject *receiver, Done done);
+
+    /* re-entrancy, tool's thread only */
+    bool isInCall() const noexcept { return m_callDepth > 0; }
+    // Inside call(): keep fn until the outermost call() returned and run it
+    // then, unless context is gone; returns true. Otherwise returns false
+    // and leaves running to the caller.
+    bool deferWhileInCall(QObject *context, std::function<void()> fn);
 
 signals:
     void connectionStateChanged(bool connected);
     void errorOccurred(const Rfmu2Error &error);    // bubbled-up from sub-modules
 
-private slots:
-    void onSocketStateChanged(QAbstractSocket::SocketState state);
+    void linkLost();                                // reconnecting on its own from here
+    void reconnecting(int attempt, int delayMs);
+    void linkRestored(bool stateReplayed);          // false: some settings were not re-applied
 
 private:
-    QTcpSocket            *mSocket          = nullptr;
-    Rfmu2SignalGenerator  *mSignalGenerator = nullptr;
-    Rfmu2SpectrumAnalyzer *mSpectrumAnalyzer= nullptr;
-    Rfmu2NetworkAnalyzer  *mNetworkAnalyzer = nullptr;
-    Rfmu2SystemControl    *mSystemControl   = nullptr;
+    struct CallScope {
+        explicit CallScope(Rfmu2Tool *tool) : m_tool(tool) { ++m_tool->m_callDepth; }
+        ~CallScope() { m_tool->leaveCall(); }
+        Rfmu2Tool *m_tool;
+    };
+    void leaveCall();
+    void runDeferred();
+
+    QThread        *m_ioThread = nullptr;
+    Rfmu2IoContext *m_io       = nullptr;           // owned by m_ioThread
+
+    int m_callDepth = 0;                            // nested call()s waiting
+    QVector<QPair<QPointer<QObject>, std::function<void()>>> m_deferred;
 };
+
+// ---------------- template implementation ----------------
+template <typename Fn>
+auto Rfmu2Tool::call(Rfmu2Priority priority, Fn fn) -> decltype(fn())
+{
+    using R = decltype(fn());
+
+    if (m_io->isIoThread())
+        return fn();    // already on the I/O thread: queuing would deadlock
+
+    CallScope scope(this);
+    QEventLoop loop;
+    auto finish = [&loop]() { QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection); };
+
+    if constexpr (std::is_void_v<R>) {
+        m_io->post(priority, [&fn, &finish]() { fn(); finish(); });
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    } else {
+        std::optional<R> result;
+        m_io->post(priority, [&fn, &finish, &result]() { result.emplace(fn()); finish(); });
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+        return std::move(*result);
+    }
+}
+
+template <typename Fn, typename Done>
+void Rfmu2Tool::submit(Rfmu2Priority priority, Fn fn, QObject *receiver, Done done)
+{
+    using R = decltype(fn());
+    Q_ASSERT(receiver && receiver->thread() == thread());
+    QPointer<QObject> guard(receiver);
+    const quint64 traceId = Rfmu2Trace::currentId();    // follows the request to both threads
+
+    // The result is posted through the tool, which outlives every job (its
+    // destructor waits for the I/O thread); the receiver is only looked at
+    // on its own thread, where it cannot be deleted in between.
+    m_io->post(priority, [this, fn = std::move(fn), done = std::move(done), guard, traceId]() mutable {
+        Rfmu2TraceScope scope(traceId);
+        if constexpr (std::is_void_v<R>) {
+            {
+                Rfmu2TraceSpan span("job");
+                fn();
+            }
+            QMetaObject::invokeMethod(this, [this, done, guard, traceId]() {
+                std::function<void()> deliver = [done, guard, traceId]() mutable {
+                    Rfmu2TraceScope scope(traceId);
+                    if (guard) done();
+                };
+                if (guard && !deferWhileInCall(guard.data(), deliver))
+                    deliver();
+            }, Qt::QueuedConnection);
+        } else {
+            R result = [&fn]() {
+                Rfmu2TraceSpan span("job");
+                return fn();
+            }();
+            QMetaObject::invokeMethod(this, [this, done, guard, traceId, result = std::move(result)]() {
+                std::function<void()> deliver = [done, guard, traceId, result]() mutable {
+                    Rfmu2TraceScope scope(traceId);
+                    if (guard) done(std::move(result));
+                };
+                if (guard && !deferWhileInCall(guard.data(), deliver))
+                    deliver();
+            }, Qt::QueuedConnection);
+        }
+    });
+}
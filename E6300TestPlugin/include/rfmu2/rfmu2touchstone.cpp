@@ -0,0 +1,153 @@
+#include "rfmu2touchstone.h"
+#include <QDateTime>
+#include <QSaveFile>
+#include <cstring>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+static const int _rfmu2_sparameters_metatype_id =
+    qRegisterMetaType<Rfmu2SParameters>("Rfmu2SParameters");
+
+namespace {
+
+// Collects output and hands it to the device in large blocks.
+class BlockWriter
+{
+public:
+    explicit BlockWriter(QIODevice &dev) : m_dev(dev) { m_buf.reserve(kBlock + 512); }
+
+    void append(const char *s, int n)
+    {
+        m_buf.append(s, n);
+        if (m_buf.size() >= kBlock)
+            flush();
+    }
+    void append(const QByteArray &s) { append(s.constData(), int(s.size())); }
+    void append(char c) { append(&c, 1); }
+    void number(double v)
+    {
+        char tmp[32];
+        append(tmp, Rfmu2TouchstoneWriter::formatNumber(v, tmp));
+    }
+    bool flush()
+    {
+        if (m_ok && !m_buf.isEmpty())
+            m_ok = m_dev.write(m_buf) == m_buf.size();
+        m_buf.clear();
+        return m_ok;
+    }
+    bool ok() const { return m_ok; }
+
+private:
+    static constexpr int kBlock = 64 * 1024;
+    QIODevice &m_dev;
+    QByteArray m_buf;
+    bool m_ok = true;
+};
+
+} // namespace
+
+// ---------------- number formatting ----------------
+int Rfmu2TouchstoneWriter::formatNumber(double value, char *buf)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const auto res = std::to_chars(buf, buf + 32, value);
+    if (res.ec == std::errc())
+        return int(res.ptr - buf);
+#endif
+    // QByteArray::number never consults the locale.
+    const QByteArray s = QByteArray::number(value, 'g', 17);
+    const int n = qMin(int(s.size()), 31);
+    std::memcpy(buf, s.constData(), size_t(n));
+    return n;
+}
+
+QString Rfmu2TouchstoneWriter::fileSuffix(int ports)
+{
+    return QStringLiteral(".s%1p").arg(ports);
+}
+
+// ---------------- write ----------------
+bool Rfmu2TouchstoneWriter::write(QIODevice &out, const Rfmu2SParameters &data,
+                                  Version version, QString *error)
+{
+    auto failWith = [error](const QString &msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    if (data.ports != 1 && data.ports != 2)
+        return failWith(QStringLiteral("Touchstone export supports 1 or 2 ports, got %1").arg(data.ports));
+
+    const int n = int(data.freqsHz.size());
+    const int params = data.ports * data.ports;
+    for (int p = 0; p < params; ++p) {
+        if (data.first[p].size() < n || data.second[p].size() < n)
+            return failWith(QStringLiteral("S-parameter arrays shorter than the frequency axis"));
+    }
+
+    BlockWriter w(out);
+
+    w.append(QByteArrayLiteral("! E6300 RFMU network analyzer export, ")
+             + QDateTime::currentDateTime().toString(Qt::ISODate).toLatin1() + '\n');
+    if (!data.comment.isEmpty()) {
+        for (const QString &line : data.comment.split('\n'))
+            w.append("! " + line.toUtf8() + '\n');
+    }
+
+    if (version == Version::V2_0)
+        w.append(QByteArrayLiteral("[Version] 2.0\n"));
+
+    w.append(QByteArrayLiteral("# HZ S "));
+    w.append(data.format == Rfmu2SParameters::Format::RealImag ? QByteArrayLiteral("RI") : QByteArrayLiteral("DB"));
+    w.append(QByteArrayLiteral(" R "));
+    w.number(data.referenceOhms);
+    w.append('\n');
+
+    if (version == Version::V2_0) {
+        w.append("[Number of Ports] " + QByteArray::number(data.ports) + '\n');
+        if (data.ports == 2)
+            w.append(QByteArrayLiteral("[Two-Port Data Order] 21_12\n"));
+        w.append("[Number of Frequencies] " + QByteArray::number(n) + '\n');
+        w.append(QByteArrayLiteral("[Network Data]\n"));
+    }
+
+    for (int i = 0; i < n; ++i) {
+        w.number(data.freqsHz[i]);
+        for (int p = 0; p < params; ++p) {
+            w.append(' ');
+            w.number(data.first[p][i]);
+            w.append(' ');
+            w.number(data.second[p][i]);
+        }
+        w.append('\n');
+    }
+
+    if (version == Version::V2_0)
+        w.append(QByteArrayLiteral("[End]\n"));
+
+    if (!w.flush())
+        return failWith(out.errorString());
+    return true;
+}
+
+bool Rfmu2TouchstoneWriter::writeFile(const QString &path, const Rfmu2SParameters &data,
+                                      Version version, QString *error)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    if (!write(file, data, version, error)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+    return true;
+}
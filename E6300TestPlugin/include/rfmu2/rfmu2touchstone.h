@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QIODevice>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+/*---------------------------------------------------------------------------
+ * S-parameter snapshot in the NA's native S11, S21, S12, S22 order – which
+ * is also the Touchstone 2-port column order.
+ *---------------------------------------------------------------------------*/
+struct Rfmu2SParameters {
+    enum class Format { RealImag, DbAngle };
+
+    int     ports = 1;                 // 1 or 2
+    Format  format = Format::DbAngle;
+    double  referenceOhms = 50.0;
+    QString comment;                   // written as "!" lines
+    QVector<double> freqsHz;
+    QVector<double> first[4];          // real part, or magnitude in dB
+    QVector<double> second[4];         // imaginary part, or angle in degrees
+};
+Q_DECLARE_METATYPE(Rfmu2SParameters)
+
+/*---------------------------------------------------------------------------
+ * Rfmu2TouchstoneWriter – streams .s1p/.s2p files.
+ *
+ * Numbers are formatted without QLocale/QTextStream (shortest round-trip
+ * representation, always '.' as decimal separator) into a block buffer that
+ * is flushed to the device in large writes.
+ *---------------------------------------------------------------------------*/
+class Rfmu2TouchstoneWriter
+{
+public:
+    enum class Version { V1_1, V2_0 };
+
+    static QString fileSuffix(int ports);   // ".s1p" / ".s2p"
+
+    static bool write(QIODevice &out, const Rfmu2SParameters &data,
+                      Version version, QString *error = nullptr);
+    static bool writeFile(const QString &path, const Rfmu2SParameters &data,
+                          Version version, QString *error = nullptr);
+
+    // Locale-independent double → text; buf must hold at least 32 chars.
+    static int formatNumber(double value, char *buf);
+};
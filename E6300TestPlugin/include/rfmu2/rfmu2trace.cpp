@@ -0,0 +1,233 @@
+#include "rfmu2trace.h"
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char *name = nullptr;
+    qint64  tsNs  = 0;
+    qint64  durNs = 0;
+    quint64 id    = 0;
+    char    phase = 'X';
+};
+
+// One per thread that ever recorded; kept after the thread ends so its
+// events can still be exported.
+struct ThreadBuffer {
+    int     tid = 0;
+    QString name;
+    std::unique_ptr<Event[]> events { new Event[Rfmu2Trace::EventsPerThread] };
+    std::atomic<quint64> written {0};   // total ever recorded; the ring holds the last EventsPerThread
+};
+
+QMutex &registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+std::vector<std::unique_ptr<ThreadBuffer>> &registry()
+{
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+thread_local quint64       t_currentId = 0;
+
+std::atomic<quint64> g_nextId {1};
+
+ThreadBuffer *threadBuffer()
+{
+    if (t_buffer)
+        return t_buffer;
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        buffer->name = QStringLiteral("GUI");
+    else if (thread && !thread->objectName().isEmpty())
+        buffer->name = thread->objectName();
+
+    QMutexLocker lock(&registryMutex());
+    buffer->tid = int(registry().size()) + 1;
+    if (buffer->name.isEmpty())
+        buffer->name = QStringLiteral("Thread %1").arg(buffer->tid);
+    t_buffer = buffer.get();
+    registry().push_back(std::move(buffer));
+    return t_buffer;
+}
+
+void appendEscaped(QByteArray &out, const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size());
+    for (const QChar c : text) {
+        if (c.unicode() < 0x20)
+            continue;
+        if (c == QLatin1Char('"') || c == QLatin1Char('\\'))
+            escaped += QLatin1Char('\\');
+        escaped += c;
+    }
+    out += escaped.toUtf8();
+}
+
+} // namespace
+
+// ---------------- control ----------------
+void Rfmu2Trace::start()
+{
+    {
+        QMutexLocker lock(&registryMutex());
+        for (const auto &buffer : registry())
+            buffer->written.store(0, std::memory_order_relaxed);
+    }
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void Rfmu2Trace::stop()
+{
+    s_enabled.store(false, std::memory_order_release);
+}
+
+quint64 Rfmu2Trace::newId()
+{
+    return g_nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+quint64 Rfmu2Trace::currentId()
+{
+    return t_currentId;
+}
+
+qint64 Rfmu2Trace::nowNs()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - origin).count();
+}
+
+// ---------------- recording ----------------
+void Rfmu2Trace::record(char phase, const char *name, qint64 tsNs, qint64 durNs, quint64 id)
+{
+    if (!isEnabled())
+        return;
+
+    ThreadBuffer *buffer = threadBuffer();
+    const quint64 n = buffer->written.load(std::memory_order_relaxed);
+    Event &e = buffer->events[n % EventsPerThread];
+    e.name  = name;
+    e.tsNs  = tsNs;
+    e.durNs = durNs;
+    e.id    = id;
+    e.phase = phase;
+    buffer->written.store(n + 1, std::memory_order_release);
+}
+
+void Rfmu2Trace::complete(const char *name, qint64 beginNs, qint64 endNs)
+{
+    record('X', name, beginNs, endNs - beginNs, t_currentId);
+}
+
+void Rfmu2Trace::instant(const char *name)
+{
+    record('i', name, nowNs(), 0, t_currentId);
+}
+
+void Rfmu2Trace::asyncBegin(const char *name, quint64 id)
+{
+    if (id != 0)
+        record('b', name, nowNs(), 0, id);
+}
+
+void Rfmu2Trace::asyncEnd(const char *name, quint64 id)
+{
+    if (id != 0)
+        record('e', name, nowNs(), 0, id);
+}
+
+Rfmu2TraceScope::Rfmu2TraceScope(quint64 id) noexcept
+    : m_previous(t_currentId)
+{
+    t_currentId = id;
+}
+
+Rfmu2TraceScope::~Rfmu2TraceScope()
+{
+    t_currentId = m_previous;
+}
+
+// ---------------- export ----------------
+QByteArray Rfmu2Trace::toChromeJson()
+{
+    // Chrome wants microseconds; keep the nanoseconds as decimals
+    auto us = [](qint64 ns) { return QByteArray::number(double(ns) / 1000.0, 'f', 3); };
+
+    QByteArray out;
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&]() {
+        if (!first)
+            out += ",\n";
+        first = false;
+    };
+
+    QMutexLocker lock(&registryMutex());
+    for (const auto &buffer : registry()) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        separate();
+        out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->name);
+        out += "\"}}";
+
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 begin = written > quint64(EventsPerThread) ? written - EventsPerThread : 0;
+        for (quint64 i = begin; i < written; ++i) {
+            const Event &e = buffer->events[i % EventsPerThread];
+            separate();
+            out += "{\"ph\":\"";
+            out += e.phase;
+            out += "\",\"cat\":\"rfmu2\",\"name\":\"";
+            out += e.name;
+            out += "\",\"pid\":1,\"tid\":" + tid + ",\"ts\":" + us(e.tsNs);
+            switch (e.phase) {
+            case 'X':
+                out += ",\"dur\":" + us(e.durNs);
+                break;
+            case 'i':
+                out += ",\"s\":\"t\"";
+                break;
+            default:    // async begin/end pair up by id
+                out += ",\"id\":\"0x" + QByteArray::number(e.id, 16) + '"';
+                break;
+            }
+            if (e.id != 0 && (e.phase == 'X' || e.phase == 'i'))
+                out += ",\"args\":{\"sweep\":" + QByteArray::number(e.id) + '}';
+            out += '}';
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool Rfmu2Trace::exportChromeJson(const QString &path, QString *error)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(toChromeJson()) < 0
+        || !file.commit()) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2Trace – optional span tracing of the sweep lifecycle, exported as
+ * Chrome trace-event JSON (chrome://tracing, Perfetto).
+ *
+ * Every thread records into its own fixed-size ring, so recording is a few
+ * plain stores and one release store; no lock is taken after the first
+ * event of a thread. When tracing is off a span costs one relaxed load.
+ *
+ * A sweep gets an id from newId() where it starts (timer tick, trigger).
+ * Code running on its behalf on another thread opens an Rfmu2TraceScope
+ * with that id, and every span recorded there carries it, so one sweep can
+ * be followed from the tick through the I/O thread to the replot.
+ *
+ * Names must be string literals (only the pointer is stored). Export and
+ * start() read or reset the rings of other threads: stop() first.
+ *---------------------------------------------------------------------------*/
+class Rfmu2Trace
+{
+public:
+    static constexpr int EventsPerThread = 1 << 16;   // oldest are overwritten
+
+    static bool isEnabled() noexcept { return s_enabled.load(std::memory_order_relaxed); }
+    static void start();                               // drops earlier events
+    static void stop();
+
+    static QByteArray toChromeJson();
+    static bool exportChromeJson(const QString &path, QString *error = nullptr);
+
+    static quint64 newId();
+    static quint64 currentId();                        // of the innermost Rfmu2TraceScope
+    static qint64  nowNs();
+
+    static void complete(const char *name, qint64 beginNs, qint64 endNs);
+    static void instant(const char *name);
+    // The whole lifetime of one sweep, possibly ending on another thread;
+    // id 0 (tracing was off when the sweep started) records nothing.
+    static void asyncBegin(const char *name, quint64 id);
+    static void asyncEnd(const char *name, quint64 id);
+
+private:
+    static void record(char phase, const char *name, qint64 tsNs, qint64 durNs, quint64 id);
+
+    static inline std::atomic<bool> s_enabled {false};
+};
+
+/* Records the enclosing block as one span (if tracing was on when it began). */
+class Rfmu2TraceSpan
+{
+public:
+    explicit Rfmu2TraceSpan(const char *name) noexcept
+        : m_name(name),
+        m_beginNs(Rfmu2Trace::isEnabled() ? Rfmu2Trace::nowNs() : -1)
+    {
+    }
+    ~Rfmu2TraceSpan()
+    {
+        if (m_beginNs >= 0)
+            Rfmu2Trace::complete(m_name, m_beginNs, Rfmu2Trace::nowNs());
+    }
+
+    Rfmu2TraceSpan(const Rfmu2TraceSpan&)            = delete;
+    Rfmu2TraceSpan& operator=(const Rfmu2TraceSpan&) = delete;
+
+private:
+    const char *m_name;
+    qint64      m_beginNs;
+};
+
+/* Tags the spans of this thread with `id` until the scope closes. */
+class Rfmu2TraceScope
+{
+public:
+    explicit Rfmu2TraceScope(quint64 id) noexcept;
+    ~Rfmu2TraceScope();
+
+    Rfmu2TraceScope(const Rfmu2TraceScope&)            = delete;
+    Rfmu2TraceScope& operator=(const Rfmu2TraceScope&) = delete;
+
+private:
+    quint64 m_previous;
+};
@@ -0,0 +1,352 @@
+#include "rfmu2tracefile.h"
+#include <QFile>
+#include <QSaveFile>
+#include <cstring>
+#include <limits>
+
+static const int _rfmu2_tracefile_metatype_id =
+    qRegisterMetaType<Rfmu2TraceFile::Contents>("Rfmu2TraceFile::Contents");
+
+// ---------------- on-disk layout ----------------
+struct Rfmu2TraceFile::FileHeader {
+    char    magic[8];          // "RFMUTRC1"
+    quint32 version;
+    quint32 columnCount;
+    qint64  timestampMs;
+    quint32 configSize;        // bytes of config following the header
+    quint32 reserved;
+    char    padding[32];
+};
+
+struct Rfmu2TraceFile::ColumnEntry {
+    char    name[NameBytes];
+    char    unit[UnitBytes];
+    quint8  sampleType;        // SampleType
+    quint8  encoding;          // Encoding
+    quint16 reserved;
+    quint32 count;             // number of samples
+    quint32 reserved2;
+    quint64 offset;            // from start of file
+    quint64 size;              // encoded bytes
+};
+
+static constexpr char    kMagic[8]   = {'R','F','M','U','T','R','C','1'};
+static constexpr quint32 kVersion    = 1;
+static constexpr int     kBlockWords = 128;
+
+static qint64 align8(qint64 v) { return (v + 7) & ~qint64(7); }
+
+static void copyName(char *dst, int capacity, const QString &src)
+{
+    std::memset(dst, 0, size_t(capacity));
+    const QByteArray utf8 = src.toUtf8().left(capacity - 1);
+    std::memcpy(dst, utf8.constData(), size_t(utf8.size()));
+}
+
+static QString readName(const char *src, int capacity)
+{
+    return QString::fromUtf8(src, int(qstrnlen(src, uint(capacity))));
+}
+
+int Rfmu2TraceFile::Contents::indexOf(const QString &name) const
+{
+    for (int i = 0; i < columns.size(); ++i) {
+        if (columns[i].name == name)
+            return i;
+    }
+    return -1;
+}
+
+// ---------------- delta + zigzag + bit-packing ----------------
+void Rfmu2TraceFile::packDeltas(const quint64 *words, int count, QByteArray &out)
+{
+    quint64 prev = 0;
+    quint64 zz[kBlockWords];
+
+    for (int start = 0; start < count; start += kBlockWords) {
+        const int n = qMin(kBlockWords, count - start);
+
+        quint64 widest = 0;
+        for (int i = 0; i < n; ++i) {
+            const qint64 d = qint64(words[start + i] - prev);   // wraps, undone on decode
+            prev = words[start + i];
+            zz[i] = (quint64(d) << 1) ^ quint64(d >> 63);
+            widest |= zz[i];
+        }
+        const int width = widest ? 64 - qCountLeadingZeroBits(widest) : 0;
+        out.append(char(width));
+
+        // LSB-first; at most 32 bits are added at a time so acc never overflows.
+        quint64 acc = 0;
+        int accBits = 0;
+        auto put = [&](quint64 v, int bits) {
+            acc |= v << accBits;
+            accBits += bits;
+            while (accBits >= 8) {
+                out.append(char(acc & 0xff));
+                acc >>= 8;
+                accBits -= 8;
+            }
+        };
+        for (int i = 0; i < n && width > 0; ++i) {
+            if (width <= 32) {
+                put(zz[i], width);
+            } else {
+                put(zz[i] & 0xffffffffu, 32);
+                put(zz[i] >> 32, width - 32);
+            }
+        }
+        if (accBits > 0)
+            out.append(char(acc & 0xff));     // every block ends on a byte boundary
+    }
+}
+
+bool Rfmu2TraceFile::unpackDeltas(const uchar *data, qint64 size, int count, quint64 *words)
+{
+    const uchar *p = data;
+    const uchar *end = data + size;
+    quint64 prev = 0;
+
+    for (int start = 0; start < count; start += kBlockWords) {
+        const int n = qMin(kBlockWords, count - start);
+        if (p >= end)
+            return false;
+        const int width = *p++;
+        if (width > 64 || end - p < (qint64(width) * n + 7) / 8)
+            return false;
+
+        quint64 acc = 0;
+        int accBits = 0;
+        auto get = [&](int bits) {
+            while (accBits < bits) {
+                acc |= quint64(*p++) << accBits;
+                accBits += 8;
+            }
+            const quint64 v = acc & ((bits == 64) ? ~quint64(0) : ((quint64(1) << bits) - 1));
+            acc >>= bits;
+            accBits -= bits;
+            return v;
+        };
+        for (int i = 0; i < n; ++i) {
+            quint64 z = 0;
+            if (width > 32) {
+                z = get(32);
+                z |= get(width - 32) << 32;
+            } else if (width > 0) {
+                z = get(width);
+            }
+            const quint64 d = (z >> 1) ^ (~(z & 1) + 1);
+            prev += d;
+            words[start + i] = prev;
+        }
+    }
+    return p == end;
+}
+
+// ---------------- write ----------------
+static QByteArray encodeColumn(const Rfmu2TraceFile::Column &col, Rfmu2TraceFile::Encoding encoding)
+{
+    const int n = int(col.values.size());
+    const bool f32 = (col.type == Rfmu2TraceFile::SampleType::Float32);
+
+    if (encoding == Rfmu2TraceFile::Encoding::Raw) {
+        if (!f32)
+            return QByteArray(reinterpret_cast<const char*>(col.values.constData()), n * int(sizeof(double)));
+        QByteArray out(n * int(sizeof(float)), Qt::Uninitialized);
+        auto *dst = reinterpret_cast<float*>(out.data());
+        for (int i = 0; i < n; ++i)
+            dst[i] = float(col.values[i]);
+        return out;
+    }
+
+    QVector<quint64> words(n);
+    for (int i = 0; i < n; ++i) {
+        if (f32) {
+            const float f = float(col.values[i]);
+            quint32 w;
+            std::memcpy(&w, &f, sizeof w);
+            words[i] = w;
+        } else {
+            std::memcpy(&words[i], &col.values[i], sizeof(double));
+        }
+    }
+    QByteArray out;
+    out.reserve(n * (f32 ? 4 : 8) / 2);
+    Rfmu2TraceFile::packDeltas(words.constData(), n, out);
+    return out;
+}
+
+bool Rfmu2TraceFile::write(const QString &path, const Contents &contents,
+                           Encoding encoding, QString *error)
+{
+    static_assert(sizeof(FileHeader) == 64, "trace file header must stay 64 bytes");
+    static_assert(sizeof(ColumnEntry) == 64, "column entry must stay 64 bytes");
+
+    auto failWith = [error](const QString &msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    return failWith(QStringLiteral("Trace files are little-endian; this host is not"));
+#endif
+
+    const int columnCount = int(contents.columns.size());
+    const qint64 tableOffset = align8(qint64(sizeof(FileHeader)) + contents.config.size());
+
+    QVector<QByteArray> blocks(columnCount);
+    QVector<ColumnEntry> table(columnCount);
+    qint64 offset = align8(tableOffset + qint64(sizeof(ColumnEntry)) * columnCount);
+
+    for (int c = 0; c < columnCount; ++c) {
+        const Column &col = contents.columns[c];
+        blocks[c] = encodeColumn(col, encoding);
+
+        ColumnEntry &e = table[c];
+        std::memset(&e, 0, sizeof e);
+        copyName(e.name, NameBytes, col.name);
+        copyName(e.unit, UnitBytes, col.unit);
+        e.sampleType = quint8(col.type);
+        e.encoding   = quint8(encoding);
+        e.count      = quint32(col.values.size());
+        e.offset     = quint64(offset);
+        e.size       = quint64(blocks[c].size());
+        offset = align8(offset + blocks[c].size());
+    }
+
+    FileHeader hdr;
+    std::memset(&hdr, 0, sizeof hdr);
+    std::memcpy(hdr.magic, kMagic, sizeof kMagic);
+    hdr.version     = kVersion;
+    hdr.columnCount = quint32(columnCount);
+    hdr.timestampMs = contents.timestampMs;
+    hdr.configSize  = quint32(contents.config.size());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return failWith(file.errorString());
+
+    static const char zeros[8] = {};
+    auto pad = [&file]() {
+        const qint64 pos = file.pos();
+        return file.write(zeros, align8(pos) - pos) >= 0;
+    };
+
+    bool ok = file.write(reinterpret_cast<const char*>(&hdr), sizeof hdr) == qint64(sizeof hdr)
+              && file.write(contents.config) == contents.config.size()
+              && pad()
+              && file.write(reinterpret_cast<const char*>(table.constData()),
+                            qint64(sizeof(ColumnEntry)) * columnCount) == qint64(sizeof(ColumnEntry)) * columnCount;
+    for (int c = 0; ok && c < columnCount; ++c)
+        ok = pad() && file.write(blocks[c]) == blocks[c].size();
+
+    if (!ok) {
+        const QString err = file.errorString();
+        file.cancelWriting();
+        return failWith(err);
+    }
+    if (!file.commit())
+        return failWith(file.errorString());
+    return true;
+}
+
+// ---------------- read ----------------
+bool Rfmu2TraceFile::read(const QString &path, Contents &out, QString *error)
+{
+    auto failWith = [error](const QString &msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return failWith(file.errorString());
+
+    const qint64 fileSize = file.size();
+    if (fileSize < qint64(sizeof(FileHeader)))
+        return failWith(QStringLiteral("Not a trace file"));
+
+    const uchar *map = file.map(0, fileSize);
+    if (!map)
+        return failWith(file.errorString());
+
+    // The mapping is released when file goes out of scope.
+    FileHeader hdr;
+    std::memcpy(&hdr, map, sizeof hdr);
+    if (std::memcmp(hdr.magic, kMagic, sizeof kMagic) != 0)
+        return failWith(QStringLiteral("Not a trace file"));
+    if (hdr.version != kVersion)
+        return failWith(QStringLiteral("Unsupported trace file version %1").arg(hdr.version));
+
+    const qint64 tableOffset = align8(qint64(sizeof(FileHeader)) + hdr.configSize);
+    if (tableOffset + qint64(sizeof(ColumnEntry)) * hdr.columnCount > fileSize)
+        return failWith(QStringLiteral("Trace file is truncated"));
+
+    out = Contents();
+    out.timestampMs = hdr.timestampMs;
+    out.config = QByteArray(reinterpret_cast<const char*>(map) + sizeof(FileHeader), int(hdr.configSize));
+    out.columns.resize(int(hdr.columnCount));
+
+    for (int c = 0; c < int(hdr.columnCount); ++c) {
+        ColumnEntry e;
+        std::memcpy(&e, map + tableOffset + qint64(sizeof(ColumnEntry)) * c, sizeof e);
+        // Written so that a crafted offset or size cannot wrap around
+        if (e.offset > quint64(fileSize) || e.size > quint64(fileSize) - e.offset)
+            return failWith(QStringLiteral("Trace file is truncated"));
+        if (e.count > quint32(std::numeric_limits<int>::max()))
+            return failWith(QStringLiteral("Trace file is corrupt"));
+
+        Column &col = out.columns[c];
+        col.name = readName(e.name, NameBytes);
+        col.unit = readName(e.unit, UnitBytes);
+        col.type = SampleType(e.sampleType);
+        const bool f32 = (col.type == SampleType::Float32);
+        if (!f32 && col.type != SampleType::Float64)
+            return failWith(QStringLiteral("Column %1 has an unknown sample type").arg(col.name));
+
+        // Check the count against the bytes before allocating for it
+        const int n = int(e.count);
+        const Encoding encoding = Encoding(e.encoding);
+        if (encoding == Encoding::Raw) {
+            if (e.size != quint64(n) * (f32 ? sizeof(float) : sizeof(double)))
+                return failWith(QStringLiteral("Column %1 is corrupt").arg(col.name));
+        } else if (encoding == Encoding::DeltaPacked) {
+            // Every block of kBlockWords samples takes at least its width byte
+            if (quint64(n) > e.size * quint64(kBlockWords))
+                return failWith(QStringLiteral("Column %1 is corrupt").arg(col.name));
+        } else {
+            return failWith(QStringLiteral("Column %1 has an unknown encoding").arg(col.name));
+        }
+
+        const uchar *src = map + e.offset;
+        col.values.resize(n);
+        double *dst = col.values.data();
+
+        if (encoding == Encoding::Raw) {
+            if (f32) {
+                for (int i = 0; i < n; ++i) {
+                    float f;
+                    std::memcpy(&f, src + i * sizeof(float), sizeof f);
+                    dst[i] = f;
+                }
+            } else {
+                std::memcpy(dst, src, size_t(n) * sizeof(double));
+            }
+        } else {
+            QVector<quint64> words(n);
+            if (!unpackDeltas(src, qint64(e.size), n, words.data()))
+                return failWith(QStringLiteral("Column %1 is corrupt").arg(col.name));
+            for (int i = 0; i < n; ++i) {
+                if (f32) {
+                    const quint32 w = quint32(words[i]);
+                    float f;
+                    std::memcpy(&f, &w, sizeof f);
+                    dst[i] = f;
+                } else {
+                    std::memcpy(&dst[i], &words[i], sizeof(double));
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+/*---------------------------------------------------------------------------
+ * Rfmu2TraceFile – versioned binary container for exported traces (.rtr).
+ *
+ *   FileHeader (64 B) | config (UTF-8, padded to 8) | column table (64 B each)
+ *   | column data (each block 8-byte aligned)
+ *
+ * Columns are stored independently, as float32 or float64. A column is
+ * either raw (little-endian IEEE values, readable straight from the mapping)
+ * or DeltaPacked: the bit patterns are delta-coded against the previous
+ * value, zigzag-mapped and bit-packed in blocks of 128 with one width byte
+ * per block. Neighbouring samples of a trace share sign, exponent and most
+ * mantissa bits, so the deltas are narrow and the packing is lossless.
+ *---------------------------------------------------------------------------*/
+class Rfmu2TraceFile
+{
+public:
+    enum class SampleType : quint8 { Float32 = 1, Float64 = 2 };
+    enum class Encoding   : quint8 { Raw = 0, DeltaPacked = 1 };
+
+    static constexpr int NameBytes = 24;    // incl. terminating zero
+    static constexpr int UnitBytes = 12;
+
+    struct Column {
+        QString name;                       // e.g. "T1.freq", "T1.amp"
+        QString unit;                       // e.g. "Hz", "dBm"
+        SampleType type = SampleType::Float64;
+        QVector<double> values;
+    };
+
+    struct Contents {
+        qint64 timestampMs = 0;             // ms since epoch
+        QByteArray config;                  // instrument settings, "key=value;..."
+        QVector<Column> columns;
+
+        int indexOf(const QString &name) const;
+    };
+
+    static QString fileSuffix() { return QStringLiteral(".rtr"); }
+
+    static bool write(const QString &path, const Contents &contents,
+                      Encoding encoding, QString *error = nullptr);
+    // Maps the file and decodes every column.
+    static bool read(const QString &path, Contents &out, QString *error = nullptr);
+
+    // Exposed for reuse by other writers: bit patterns -> packed stream and back.
+    static void packDeltas(const quint64 *words, int count, QByteArray &out);
+    static bool unpackDeltas(const uchar *data, qint64 size, int count, quint64 *words);
+
+private:
+    struct FileHeader;
+    struct ColumnEntry;
+};
+Q_DECLARE_METATYPE(Rfmu2TraceFile::Contents)
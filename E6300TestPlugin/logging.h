@@ -1,18 +1,23 @@
 #pragma once
-#include <QTextBrowser>
-#include <QTime>
+#include <QString>
 #include <QStringView>
+#include "logsink.h"
+#include "logview.h"
 
 namespace logger
 {
-    inline void log(QTextBrowser *box, QStringView msg)
+    // Queues msg for the view's channel. Safe from any thread: the view is
+    // only touched by the next batched flush on the GUI thread.
+    inline void log(LogView *view, QStringView msg)
     {
-        if (!box) return;
-        const QString ts = QTime::currentTime().toString("HH:mm:ss.zzz");
-        box->append(QStringLiteral(
-                        "<span style='color:#666666;font-family:monospace'>[%1]</span> %2")
-                        .arg(ts)
-                        .arg(msg.toString()));
+        if (!view) return;
+        LogSink::post(view->channel(), msg);
+    }
 
+    // For code without a view; reaches any view on that channel and the
+    // plugin host's log callback.
+    inline void log(const QString &channel, QStringView msg)
+    {
+        LogSink::post(channel, msg);
     }
 }
@@ -0,0 +1,169 @@
+#include "logsink.h"
+#include "logview.h"
+
+#include <QHash>
+#include <QThread>
+#include <QTime>
+#include <QTimer>
+
+std::atomic<LogSink*> LogSink::s_instance {nullptr};
+std::atomic<int>      LogSink::s_posting {0};
+
+LogSink *LogSink::instance()
+{
+    return s_instance.load(std::memory_order_acquire);
+}
+
+LogSink::LogSink(QObject *parent)
+    : QObject(parent),
+    m_head(&m_stub),
+    m_tail(&m_stub)
+{
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &LogSink::flush);
+
+    LogSink *expected = nullptr;
+    s_instance.compare_exchange_strong(expected, this, std::memory_order_acq_rel);
+}
+
+LogSink::~LogSink()
+{
+    // Unpublish, then let post() calls that already hold the pointer finish
+    // their push; from here on other threads' lines are dropped.
+    LogSink *self = this;
+    if (s_instance.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel)) {
+        while (s_posting.load(std::memory_order_acquire) != 0)
+            QThread::yieldCurrentThread();
+    }
+
+    // Lines still queued at shutdown are dropped; nobody is left to show them
+    while (Node *n = pop()) {
+        if (n != &m_stub)
+            delete n;
+    }
+}
+
+// ---------------- queue ----------------
+void LogSink::push(Node *node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+LogSink::Node *LogSink::pop()
+{
+    Node *tail = m_tail;
+    Node *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &m_stub) {
+        if (!next)
+            return nullptr;
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    if (tail != m_head.load(std::memory_order_acquire))
+        return nullptr;     // a producer has swapped m_head but not linked yet
+
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void LogSink::post(const QString &channel, QStringView text)
+{
+    // Announce first, then load: the destructor waits for the count to drop
+    // after unpublishing, so a sink seen here stays alive until we are done.
+    s_posting.fetch_add(1, std::memory_order_acq_rel);
+    LogSink *sink = instance();
+    if (sink) {
+        auto *node = new Node;
+        node->entry.channel    = channel;
+        node->entry.msecsOfDay = QTime::currentTime().msecsSinceStartOfDay();
+        node->entry.text       = text.toString();
+        sink->push(node);
+
+        // Only the first line after a flush pays for the cross-thread call
+        if (!sink->m_wakePending.exchange(true, std::memory_order_acq_rel))
+            QMetaObject::invokeMethod(sink, "armFlush", Qt::QueuedConnection);
+    }
+    s_posting.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// ---------------- delivery ----------------
+void LogSink::armFlush()
+{
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start(FlushIntervalMs);
+}
+
+void LogSink::attach(const QString &channel, LogModel *model)
+{
+    m_models.append({ channel, QPointer<LogModel>(model) });
+}
+
+void LogSink::setBatchHandler(std::function<void(const QString &)> handler)
+{
+    m_handler = std::move(handler);
+}
+
+QString LogSink::formatLine(const LogEntry &entry, bool withChannel)
+{
+    const QString ts = QTime::fromMSecsSinceStartOfDay(entry.msecsOfDay)
+                           .toString(QStringLiteral("HH:mm:ss.zzz"));
+    return withChannel ? QStringLiteral("[%1] [%2] %3").arg(ts, entry.channel, entry.text)
+                       : QStringLiteral("[%1] %2").arg(ts, entry.text);
+}
+
+void LogSink::flush()
+{
+    // Cleared first: a line pushed from here on schedules the next flush
+    m_wakePending.store(false, std::memory_order_release);
+
+    QHash<QString, QVector<LogEntry>> byChannel;
+    QString batch;
+    int taken = 0;
+    while (taken < MaxPerFlush) {
+        Node *n = pop();
+        if (!n)
+            break;
+        if (n == &m_stub)
+            continue;
+        if (m_handler) {
+            if (!batch.isEmpty())
+                batch += QLatin1Char('\n');
+            batch += formatLine(n->entry, true);
+        }
+        byChannel[n->entry.channel].append(std::move(n->entry));
+        delete n;
+        ++taken;
+    }
+    if (taken == MaxPerFlush)
+        m_flushTimer->start(0);
+
+    if (taken == 0)
+        return;
+
+    for (int i = m_models.size() - 1; i >= 0; --i) {
+        if (!m_models[i].second) {
+            m_models.remove(i);
+            continue;
+        }
+        auto it = byChannel.constFind(m_models[i].first);
+        if (it != byChannel.cend())
+            m_models[i].second->append(*it);
+    }
+
+    if (m_handler && !batch.isEmpty())
+        m_handler(batch);
+}
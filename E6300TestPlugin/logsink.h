@@ -0,0 +1,89 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+class LogModel;
+class QTimer;
+
+// One log line as it travels from log() to the views.
+struct LogEntry
+{
+    QString channel;        // "SA", "NA", "SG", ...
+    int     msecsOfDay = 0; // local time of the log() call
+    QString text;
+};
+
+// Collects log lines from any thread and hands them to the views in batches.
+//
+// log() pushes onto a lock-free multi-producer queue (no mutex, no widget
+// access) and, if no flush is pending yet, asks the GUI thread for one. The
+// flush runs at most every FlushIntervalMs, moves everything queued into the
+// models attached to each channel with one insert per model, and passes the
+// same batch to the external handler (the plugin host's log callback) as a
+// single call.
+//
+// The sink is owned by MainWindow, created on the GUI thread and deleted in
+// its destructor. While one exists it is the instance(); lines logged before
+// or after that are dropped.
+class LogSink : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int FlushIntervalMs = 50;
+    static constexpr int MaxPerFlush     = 5000;    // the rest goes in the next pass
+
+    // GUI thread. The first sink constructed becomes the instance.
+    explicit LogSink(QObject *parent = nullptr);
+    ~LogSink() override;
+
+    // Null while no sink exists.
+    static LogSink *instance();
+
+    // Thread-safe.
+    static void post(const QString &channel, QStringView text);
+
+    /* main thread only */
+    void attach(const QString &channel, LogModel *model);
+    // Called once per flush with the batch's lines joined by '\n'.
+    void setBatchHandler(std::function<void(const QString &)> handler);
+
+    static QString formatLine(const LogEntry &entry, bool withChannel);
+
+public slots:
+    void flush();
+
+private slots:
+    void armFlush();
+
+private:
+    struct Node {
+        std::atomic<Node*> next {nullptr};
+        LogEntry entry;
+    };
+
+    void push(Node *node);
+    Node *pop();            // consumer side; nullptr if empty or a push is half done
+
+    // Vyukov MPSC queue: producers swap m_head, the consumer walks m_tail
+    std::atomic<Node*> m_head;
+    Node              *m_tail;
+    Node               m_stub;
+    std::atomic<bool>  m_wakePending {false};
+
+    static std::atomic<LogSink*> s_instance;
+    static std::atomic<int>      s_posting;    // post() calls holding s_instance
+
+    QTimer *m_flushTimer;
+    QVector<QPair<QString, QPointer<LogModel>>> m_models;
+    std::function<void(const QString &)> m_handler;
+};
+
+#endif // LOGSINK_H
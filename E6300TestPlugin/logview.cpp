@@ -0,0 +1,140 @@
+#include "logview.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QScrollBar>
+#include <algorithm>
+
+// ---------------- model ----------------
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent),
+    m_ring(qMax(1, capacity))
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count)
+        return QVariant();
+
+    const LogEntry &e = at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return LogSink::formatLine(e, false);
+    case Qt::ToolTipRole:
+        return e.text;
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::append(const QVector<LogEntry> &entries)
+{
+    const int capacity = int(m_ring.size());
+    if (entries.isEmpty())
+        return;
+
+    // Only the newest `capacity` lines of the batch can survive
+    const int n = qMin(int(entries.size()), capacity);
+    const auto first = entries.cend() - n;
+
+    const int overflow = m_count + n - capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_first = (m_first + overflow) % capacity;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + n - 1);
+    int slot = (m_first + m_count) % capacity;
+    for (auto it = first; it != entries.cend(); ++it) {
+        m_ring[slot] = *it;
+        slot = (slot + 1) % capacity;
+    }
+    m_count += n;
+    endInsertRows();
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    std::fill(m_ring.begin(), m_ring.end(), LogEntry());
+    m_first = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+// ---------------- view ----------------
+LogView::LogView(const QString &channel, QWidget *parent)
+    : QListView(parent),
+    m_channel(channel),
+    m_model(new LogModel(LogModel::DefaultCapacity, this))
+{
+    setModel(m_model);
+    setUniformItemSizes(true);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setFrameShape(QFrame::NoFrame);
+
+    // Decided before the rows change, since an insert moves the maximum
+    connect(m_model, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+        const QScrollBar *bar = verticalScrollBar();
+        m_followTail = bar->value() >= bar->maximum();
+    });
+    connect(m_model, &QAbstractItemModel::rowsInserted, this, [this]() {
+        if (m_followTail)
+            scrollToBottom();
+    });
+
+    if (LogSink *sink = LogSink::instance())
+        sink->attach(m_channel, m_model);
+}
+
+void LogView::keyPressEvent(QKeyEvent *event)
+{
+    if (event->matches(QKeySequence::Copy)) {
+        copySelection();
+        return;
+    }
+    QListView::keyPressEvent(event);
+}
+
+void LogView::contextMenuEvent(QContextMenuEvent *event)
+{
+    QMenu menu(this);
+    QAction *copy  = menu.addAction(tr("Copy"));
+    QAction *clear = menu.addAction(tr("Clear"));
+    copy->setEnabled(selectionModel()->hasSelection());
+
+    QAction *chosen = menu.exec(event->globalPos());
+    if (chosen == copy)
+        copySelection();
+    else if (chosen == clear)
+        m_model->clear();
+}
+
+void LogView::copySelection() const
+{
+    QModelIndexList rows = selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end(), [](const QModelIndex &a, const QModelIndex &b) {
+        return a.row() < b.row();
+    });
+
+    QStringList lines;
+    for (const QModelIndex &idx : rows)
+        lines.append(idx.data().toString());
+    if (!lines.isEmpty())
+        QApplication::clipboard()->setText(lines.join(QLatin1Char('\n')));
+}
@@ -0,0 +1,59 @@
+#ifndef LOGVIEW_H
+#define LOGVIEW_H
+
+#include <QAbstractListModel>
+#include <QListView>
+#include <QVector>
+#include "logsink.h"
+
+// The last Capacity lines of one log channel, oldest first, in a ring
+// buffer: appending to a full model drops the oldest lines instead of
+// growing, and a whole batch is one remove plus one insert notification.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    static constexpr int DefaultCapacity = 2000;
+
+    explicit LogModel(int capacity = DefaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void append(const QVector<LogEntry> &entries);
+    void clear();
+
+private:
+    const LogEntry &at(int row) const { return m_ring[(m_first + row) % m_ring.size()]; }
+
+    QVector<LogEntry> m_ring;   // sized to capacity up front
+    int m_first = 0;            // ring index of row 0
+    int m_count = 0;
+};
+
+// List view over a LogModel for one channel. Only the visible rows are laid
+// out (uniform row height), and it keeps following the newest line unless
+// the user has scrolled up.
+class LogView : public QListView
+{
+    Q_OBJECT
+public:
+    explicit LogView(const QString &channel, QWidget *parent = nullptr);
+
+    // Fixed at construction, so logger::log() may read it from any thread.
+    const QString &channel() const noexcept { return m_channel; }
+    LogModel *logModel() const noexcept { return m_model; }
+
+protected:
+    void keyPressEvent(QKeyEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    void copySelection() const;
+
+    const QString m_channel;
+    LogModel     *m_model;
+    bool          m_followTail = true;
+};
+
+#endif // LOGVIEW_H
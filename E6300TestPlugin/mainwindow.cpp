@@ -6,20 +6,35 @@
 #include <QDockWidget>
 #include <QTabWidget>
 #include <QDebug>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QStandardPaths>
 
 #include "sawidget.h"
 #include "sgwidget.h"
 #include "nawidget.h"
 #include "rrsucalibdialog.h"
 #include "connectdialog.h"
+#include "portscandialog.h"
+#include "logsink.h"
+#include "statspanel.h"
+#include "telemetrypanel.h"
+#include "include/rfmu2/rfmu2trace.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , m_logSink(new LogSink)
     , m_rfmuTool(new Rfmu2Tool(this))
     , m_saWidget(nullptr)
     , m_sgWidget(nullptr)
     , m_naWidget(nullptr)
     , m_tabWidget(nullptr)
+    , m_dockStats(nullptr)
+    , m_statsPanel(nullptr)
+    , m_dockTelemetry(nullptr)
+    , m_telemetryPanel(nullptr)
+    , m_telemetry(nullptr)
+    , m_sequencer(nullptr)
 {
     setWindowIcon(QIcon(":/images/icons/testspirite.ico"));
 
@@ -28,6 +43,20 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onHardwareError);
     connect(m_rfmuTool, &Rfmu2Tool::connectionStateChanged,
             this, &MainWindow::onConnectionStateChanged);
+    connect(m_rfmuTool, &Rfmu2Tool::linkLost,
+            this, &MainWindow::onLinkLost);
+    connect(m_rfmuTool, &Rfmu2Tool::reconnecting,
+            this, &MainWindow::onReconnecting);
+    connect(m_rfmuTool, &Rfmu2Tool::linkRestored,
+            this, &MainWindow::onLinkRestored);
+
+    // RRSU tables each instrument acknowledged, kept across sessions; the
+    // upload dialog only skips on them when the user opts in
+    const QString rrsuCachePath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                                  + QStringLiteral("/rrsu-uploads.ini");
+    m_rfmuTool->call([sys = m_rfmuTool->systemControl(), rrsuCachePath] {
+        sys->setRRSUCalibrationCache(rrsuCachePath);
+    });
 
     // 2. Create main UI components
     createCentralTabs();    // Tab widget in the center
@@ -45,6 +74,10 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // Not a child: it has to go while this window (and the plugin library
+    // that holds its code) is certainly still here, not with the app
+    delete m_logSink;
+    m_logSink = nullptr;
 }
 
 //----------------------------------------
@@ -92,9 +125,51 @@ void MainWindow::createDockWidgets()
     m_dockSG->setWidget(m_sgWidget);
     addDockWidget(Qt::RightDockWidgetArea, m_dockSG);
 
+    // Performance counters, hidden until asked for from the View menu
+    m_statsPanel = new StatsPanel(m_rfmuTool, this);
+    m_statsPanel->addPlot(tr("Spectrum Analyzer"), m_saWidget->renderStats());
+    m_statsPanel->addPlot(tr("Network Analyzer"), m_naWidget->renderStats());
+
+    m_dockStats = new QDockWidget(tr("Statistics"), this);
+    m_dockStats->setObjectName(QStringLiteral("statsDock"));
+    m_dockStats->setAllowedAreas(Qt::AllDockWidgetAreas);
+    m_dockStats->setWidget(m_statsPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, m_dockStats);
+    m_dockStats->hide();
+
+    // Background voltage/temperature polling. Ticks are skipped while the
+    // link is down, so it can run from startup.
+    m_telemetry = new Rfmu2TelemetryPoller(m_rfmuTool, this);
+    const QString telemetryPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                                  + QStringLiteral("/telemetry/rfmu2-telemetry.bin");
+    if (!m_telemetry->log().open(telemetryPath))
+        qWarning() << "Telemetry history not persisted:" << m_telemetry->log().errorString();
+    m_telemetry->start();
+
+    m_telemetryPanel = new TelemetryPanel(m_telemetry, this);
+    m_dockTelemetry = new QDockWidget(tr("Telemetry"), this);
+    m_dockTelemetry->setObjectName(QStringLiteral("telemetryDock"));
+    m_dockTelemetry->setAllowedAreas(Qt::AllDockWidgetAreas);
+    m_dockTelemetry->setWidget(m_telemetryPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, m_dockTelemetry);
+    m_dockTelemetry->hide();
+
     // If you have more side widgets, create more docks similarly
 }
 
+QJsonObject MainWindow::metricsJson() const
+{
+    QJsonObject plots;
+    if (m_saWidget)
+        plots["SA"] = m_saWidget->renderStats()->statsJson();
+    if (m_naWidget)
+        plots["NA"] = m_naWidget->renderStats()->statsJson();
+
+    QJsonObject metrics = m_rfmuTool->metrics().toJson();
+    metrics["plots"] = plots;
+    return metrics;
+}
+
 //----------------------------------------
 // Create menu actions
 //----------------------------------------
@@ -143,7 +218,7 @@ void MainWindow::createActions()
         }
 
         // Switch clock
-        bool ok = sysCtrl->setReferenceClockMode(true /*useInternal*/);
+        bool ok = m_rfmuTool->call([sysCtrl] { return sysCtrl->setReferenceClockMode(true /*useInternal*/); });
         if (ok) {
             statusBar()->showMessage(tr("Clock reference set to INTERNAL"), 5000);
         } else {
@@ -165,7 +240,7 @@ void MainWindow::createActions()
             return;
         }
 
-        bool ok = sysCtrl->setReferenceClockMode(false /*useInternal*/);
+        bool ok = m_rfmuTool->call([sysCtrl] { return sysCtrl->setReferenceClockMode(false /*useInternal*/); });
         if (ok) {
             statusBar()->showMessage(tr("Clock reference set to EXTERNAL"), 5000);
         } else {
@@ -184,6 +259,25 @@ void MainWindow::createActions()
     m_rrsuCalibAction->setStatusTip(tr("Upload RRSU TX-calibration blob"));
     connect(m_rrsuCalibAction, &QAction::triggered,
             this, &MainWindow::onRRSUCalibrationTriggered);
+
+    // Same measurement over several RF ports
+    m_portScanAction = new QAction(tr("Port Scan..."), this);
+    m_portScanAction->setStatusTip(tr("Run one SA or NA measurement across a list of RF ports"));
+    connect(m_portScanAction, &QAction::triggered,
+            this, &MainWindow::onPortScanTriggered);
+
+    // Scripted measurement run; the same action stops a running plan
+    m_testPlanAction = new QAction(tr("Run Test Plan..."), this);
+    m_testPlanAction->setStatusTip(tr("Run a JSON test plan and write the results to a file"));
+    connect(m_testPlanAction, &QAction::triggered,
+            this, &MainWindow::onRunTestPlanTriggered);
+
+    // Span tracing of the sweep pipeline; unchecking saves the trace
+    m_recordTraceAction = new QAction(tr("Record Trace"), this);
+    m_recordTraceAction->setCheckable(true);
+    m_recordTraceAction->setStatusTip(tr("Trace every sweep stage and save it as a Chrome trace"));
+    connect(m_recordTraceAction, &QAction::toggled,
+            this, &MainWindow::onRecordTraceToggled);
 }
 
 //----------------------------------------
@@ -211,6 +305,8 @@ void MainWindow::createMenus()
     m_refClockMenu->addAction(m_useExternalClockAction);
 
     m_deviceMenu->addSeparator();
+    m_deviceMenu->addAction(m_portScanAction);
+    m_deviceMenu->addAction(m_testPlanAction);
     m_deviceMenu->addAction(m_rrsuCalibAction);
 
     // Add the Reference Clock submenu to the device menu
@@ -221,6 +317,14 @@ void MainWindow::createMenus()
     viewSignalGeneratorAction = m_dockSG->toggleViewAction();
     viewSignalGeneratorAction->setText(tr("Signal Generator"));
     m_viewMenu->addAction(viewSignalGeneratorAction);
+    QAction *viewStatsAction = m_dockStats->toggleViewAction();
+    viewStatsAction->setText(tr("Statistics"));
+    m_viewMenu->addAction(viewStatsAction);
+    QAction *viewTelemetryAction = m_dockTelemetry->toggleViewAction();
+    viewTelemetryAction->setText(tr("Telemetry"));
+    m_viewMenu->addAction(viewTelemetryAction);
+    m_viewMenu->addSeparator();
+    m_viewMenu->addAction(m_recordTraceAction);
 
     // Help menu
     m_helpMenu = menuBar()->addMenu(tr("&Help"));
@@ -294,7 +398,7 @@ void MainWindow::onSetTimeoutsTriggered()
     bool ok = false;
     int genMs = QInputDialog::getInt(this,
                                      tr("Signal Generator Timeout"),
-                                     tr("Timeout (ms):"),
+                                     tr("Timeout ceiling (ms):"),
                                      5000, // default
                                      1, 9999999, 1, &ok);
     if (!ok) {
@@ -305,7 +409,7 @@ void MainWindow::onSetTimeoutsTriggered()
     // 2) Prompt for Spectrum Analyzer Timeout
     int specMs = QInputDialog::getInt(this,
                                       tr("Spectrum Analyzer Timeout"),
-                                      tr("Timeout (ms):"),
+                                      tr("Timeout ceiling (ms):"),
                                       5000, // default
                                       1, 9999999, 1, &ok);
     if (!ok) {
@@ -315,7 +419,7 @@ void MainWindow::onSetTimeoutsTriggered()
     // 3) Prompt for Network Analyzer Timeout
     int naMs = QInputDialog::getInt(this,
                                     tr("Network Analyzer Timeout"),
-                                    tr("Timeout (ms):"),
+                                    tr("Timeout ceiling (ms):"),
                                     20000, // default
                                     1, 9999999, 1, &ok);
     if (!ok) {
@@ -326,9 +430,12 @@ void MainWindow::onSetTimeoutsTriggered()
     auto spec = m_rfmuTool->spectrumAnalyzer();
     auto na   = m_rfmuTool->networkAnalyzer();
 
-    if (gen)  gen->setTimeoutMs(genMs);
-    if (spec) spec->setTimeoutMs(specMs);
-    if (na)   na->setTimeoutMs(naMs);
+    // The modules read their timeouts on the I/O thread, so set them there too
+    m_rfmuTool->call([=] {
+        if (gen)  gen->setTimeoutMs(genMs);
+        if (spec) spec->setTimeoutMs(specMs);
+        if (na)   na->setTimeoutMs(naMs);
+    });
 
     // Show a small confirmation or log
     statusBar()->showMessage(
@@ -364,13 +471,41 @@ void MainWindow::onConnectionStateChanged(bool connected)
 {
     if (connected) {
         statusBar()->showMessage(tr("Hardware connected"));
-    } else {
+    } else if (!m_rfmuTool->isReconnecting()) {
+        // Intended disconnect; a lost link is handled by onLinkLost()
         statusBar()->showMessage(tr("Hardware disconnected"));
         m_saWidget->stopAutoSweep();
         m_naWidget->stopAutoSweep();
     }
 }
 
+void MainWindow::onLinkLost()
+{
+    statusBar()->showMessage(tr("Link lost - reconnecting..."));
+    m_saWidget->suspendAcquisition();
+    m_naWidget->suspendAcquisition();
+}
+
+void MainWindow::onReconnecting(int attempt, int delayMs)
+{
+    statusBar()->showMessage(tr("Link lost - reconnect attempt %1 in %2 ms")
+                                 .arg(attempt).arg(delayMs));
+}
+
+void MainWindow::onLinkRestored(bool stateReplayed)
+{
+    if (stateReplayed) {
+        statusBar()->showMessage(tr("Link restored, settings re-applied"), 5000);
+    } else {
+        statusBar()->showMessage(tr("Link restored, some settings could not be re-applied"));
+        QMessageBox::warning(this, tr("Link Restored"),
+                             tr("The connection is back, but not every setting could be "
+                                "re-applied. Please check the instrument configuration."));
+    }
+    m_saWidget->resumeAcquisition();
+    m_naWidget->resumeAcquisition();
+}
+
 void MainWindow::onSinglePortCaliResult(const QString &msg)
 {
     // Display the message in a message box
@@ -406,7 +541,7 @@ void MainWindow::onReadVoltageTempTriggered()
     }
 
     // 3) Call the new function
-    QVector<double> results = sysCtrl->readVoltagesAndTemperature();
+    QVector<double> results = m_rfmuTool->call([sysCtrl] { return sysCtrl->readVoltagesAndTemperature(); });
     if (results.isEmpty()) {
         // Something went wrong, or user was informed via errorOccurred
         statusBar()->showMessage("Failed to read voltage/temp", 5000);
@@ -449,10 +584,109 @@ void MainWindow::onRRSUCalibrationTriggered()
                              tr("SystemControl not available"));
         return;
     }
-    RRSUCalibDialog dlg(m_rfmuTool->systemControl(), this);
+    RRSUCalibDialog dlg(m_rfmuTool, this);
     dlg.exec(); // modal
 }
 
+void MainWindow::onPortScanTriggered()
+{
+    if (!m_rfmuTool) {
+        QMessageBox::warning(this, tr("Error"), tr("Rfmu2Tool is null!"));
+        return;
+    }
+    PortScanDialog dlg(m_rfmuTool, this);
+    dlg.exec();
+}
+
+void MainWindow::onRunTestPlanTriggered()
+{
+    if (m_sequencer && m_sequencer->isRunning()) {
+        m_sequencer->stop();
+        statusBar()->showMessage(tr("Stopping test plan..."));
+        return;
+    }
+    if (!m_rfmuTool || !m_rfmuTool->isConnected()) {
+        QMessageBox::warning(this, tr("Test Plan"), tr("Not connected."));
+        return;
+    }
+
+    const QString planPath = QFileDialog::getOpenFileName(this, tr("Open Test Plan"),
+                                                          QString(), tr("Test plans (*.json)"));
+    if (planPath.isEmpty())
+        return;
+
+    QString error;
+    const Rfmu2TestPlan plan = Rfmu2TestPlan::fromFile(planPath, &error);
+    if (plan.steps.isEmpty()) {
+        QMessageBox::warning(this, tr("Test Plan"), tr("%1: %2").arg(QFileInfo(planPath).fileName(), error));
+        return;
+    }
+
+    const QFileInfo info(planPath);
+    const QString resultsPath = QFileDialog::getSaveFileName(
+        this, tr("Save Results"),
+        info.absolutePath() + "/" + info.completeBaseName() + "-results.jsonl",
+        tr("JSON lines (*.jsonl)"));
+    if (resultsPath.isEmpty())
+        return;
+
+    if (!m_sequencer) {
+        m_sequencer = new Rfmu2Sequencer(m_rfmuTool, this);
+        connect(m_sequencer, &Rfmu2Sequencer::stepFinished, this, [this](int index, int count, bool) {
+            statusBar()->showMessage(tr("Test plan: step %1 of %2").arg(index + 1).arg(count));
+        });
+        connect(m_sequencer, &Rfmu2Sequencer::finished,
+                this, &MainWindow::onTestPlanFinished);
+    }
+
+    if (!m_sequencer->start(plan, resultsPath)) {
+        QMessageBox::warning(this, tr("Test Plan"), m_sequencer->errorString());
+        return;
+    }
+    m_testPlanAction->setText(tr("Stop Test Plan"));
+}
+
+void MainWindow::onTestPlanFinished(const Rfmu2SequenceSummary &summary)
+{
+    m_testPlanAction->setText(tr("Run Test Plan..."));
+
+    const QString text = tr("%1: %2 steps, %3 passed, %4 failed, %5 errors in %6 s")
+                             .arg(summary.plan.isEmpty() ? tr("Test plan") : summary.plan)
+                             .arg(summary.steps).arg(summary.passed)
+                             .arg(summary.failed).arg(summary.errors)
+                             .arg(summary.elapsedMs / 1000.0, 0, 'f', 1);
+    statusBar()->showMessage(text);
+
+    if (summary.allPassed())
+        QMessageBox::information(this, tr("Test Plan"), text);
+    else
+        QMessageBox::warning(this, tr("Test Plan"),
+                             summary.error.isEmpty() ? text : text + "\n" + summary.error);
+}
+
+void MainWindow::onRecordTraceToggled(bool recording)
+{
+    if (recording) {
+        Rfmu2Trace::start();
+        statusBar()->showMessage(tr("Recording trace..."));
+        return;
+    }
+
+    Rfmu2Trace::stop();
+    statusBar()->clearMessage();
+    const QString path = QFileDialog::getSaveFileName(
+        this, tr("Save Trace"), QStringLiteral("rfmu2-trace.json"),
+        tr("Chrome trace (*.json)"));
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    if (!Rfmu2Trace::exportChromeJson(path, &error))
+        QMessageBox::warning(this, tr("Save Trace"), tr("Could not write %1: %2").arg(path, error));
+    else
+        statusBar()->showMessage(tr("Trace saved to %1").arg(path), 5000);
+}
+
 //----------------------------------------
 // Apply visibility settings based on macro
 //----------------------------------------
@@ -4,8 +4,10 @@
 #include <QMainWindow>
 #include <QDockWidget>
 #include <QTabWidget>
+#include <QJsonObject>
 #include "include/rfmu2/rfmu2tool.h"
 #include "include/rfmu2/rfmu2_error.h"
+#include "include/rfmu2/rfmu2sequencer.h"
 
 // Visibility mode for the main widgets. Adjust WIDGET_VISIBILITY_MODE
 // to one of the DISPLAY_* values below to either show all widgets or
@@ -24,6 +26,10 @@ class Rfmu2Tool;
 class SAWidget;
 class SGWidget;
 class NAWidget;
+class LogSink;
+class StatsPanel;
+class TelemetryPanel;
+class Rfmu2TelemetryPoller;
 
 class MainWindow : public QMainWindow
 {
@@ -33,6 +39,11 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+    Rfmu2Tool *tool() const { return m_rfmuTool; }
+
+    // Transport counters and round trips plus the SA/NA plot pipelines
+    QJsonObject metricsJson() const;
+
 private slots:
     // Menu actions
     void onConnectTriggered();
@@ -41,10 +52,17 @@ private slots:
     void onAboutTriggered();
     void onReadVoltageTempTriggered();
     void onRRSUCalibrationTriggered();
+    void onPortScanTriggered();
+    void onRunTestPlanTriggered();
+    void onTestPlanFinished(const Rfmu2SequenceSummary &summary);
+    void onRecordTraceToggled(bool recording);
 
     // Hardware signals
     void onHardwareError(const Rfmu2Error &error);
     void onConnectionStateChanged(bool connected);
+    void onLinkLost();
+    void onReconnecting(int attempt, int delayMs);
+    void onLinkRestored(bool stateReplayed);
     void onSinglePortCaliResult(const QString &msg);
     void onDualPortCaliResult(const QString &msg);
 
@@ -61,6 +79,10 @@ private:
     void applyVisibilitySettings(); // show/hide widgets based on macro
 
 private:
+    // Log delivery for every view and the plugin host; first, so it exists
+    // before anything logs, and deleted explicitly in the destructor
+    LogSink   *m_logSink;
+
     // The hardware tool managing the TCP connection & submodules
     Rfmu2Tool *m_rfmuTool;
 
@@ -88,9 +110,19 @@ private:
     QAction *m_useExternalClockAction;
     QAction* m_readVoltageTempAction;
     QAction *m_rrsuCalibAction;
+    QAction *m_portScanAction;
+    QAction *m_testPlanAction;
+    QAction *m_recordTraceAction;
     QAction* viewSignalGeneratorAction;
 
     QDockWidget *m_dockSG;
+    QDockWidget *m_dockStats;
+    StatsPanel  *m_statsPanel;
+    QDockWidget *m_dockTelemetry;
+    TelemetryPanel *m_telemetryPanel;
+    Rfmu2TelemetryPoller *m_telemetry;
+
+    Rfmu2Sequencer *m_sequencer;
 };
 
 #endif // MAINWINDOW_H
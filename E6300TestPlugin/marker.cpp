@@ -5,6 +5,8 @@ Marker::Marker(QCustomPlot *plot, const QString &name)
     active(false),
     index(0),
     traceIndex(0),
+    frequency(0),
+    amplitude(0),
     deltaMode(false),
     pkTracking(false)
 {
@@ -54,9 +56,18 @@ Marker::~Marker()
     delete deltaTracer;
 }
 
-void Marker::setPosition(double frequency, double amplitude)
+void Marker::setPosition(QCPGraph *graph, double frequency, double amplitude)
 {
-    tracer->setGraphKey(frequency);
+    this->frequency = frequency;
+    this->amplitude = amplitude;
+
+    tracer->setGraph(nullptr);
+    deltaTracer->setGraph(nullptr);
+    if (graph) {
+        tracer->position->setAxes(graph->keyAxis(), graph->valueAxis());
+        deltaTracer->position->setAxes(graph->keyAxis(), graph->valueAxis());
+    }
+    tracer->position->setCoords(frequency, amplitude);
 
     // Update annotation
     annotation->position->setCoords(frequency, amplitude + 1);
@@ -77,13 +88,10 @@ void Marker::toggleDeltaMode()
 {
     deltaMode = !deltaMode;
     if (deltaMode) {
-        // Activate delta mode: set reference point
-        deltaRefFrequency = tracer->graphKey();
-        deltaRefAmplitude = tracer->position->value();
-
-        // Update delta tracer position
-        deltaTracer->setGraph(tracer->graph());
-        deltaTracer->setGraphKey(deltaRefFrequency);
+        // Activate delta mode: the current point becomes the reference
+        deltaRefFrequency = frequency;
+        deltaRefAmplitude = amplitude;
+        deltaTracer->position->setCoords(deltaRefFrequency, deltaRefAmplitude);
 
         deltaTracer->setVisible(true);
     } else {
@@ -9,7 +9,10 @@ public:
     Marker(QCustomPlot *plot, const QString &name);
     ~Marker();
 
-    void setPosition(double frequency, double amplitude);
+    // Place the marker at a full-resolution point of the trace drawn by
+    // graph. The tracers are positioned by coordinates, not snapped to the
+    // graph: its data is decimated and would pull them to a min/max point.
+    void setPosition(QCPGraph *graph, double frequency, double amplitude);
     void setVisible(bool visible);
     void toggleDeltaMode();
 
@@ -17,6 +20,8 @@ public:
     bool active;
     int index;
     int traceIndex;
+    double frequency;               // where setPosition() put the marker
+    double amplitude;
     QCPItemTracer *tracer;
     QCPItemText *annotation;
 
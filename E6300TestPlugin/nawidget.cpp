@@ -4,6 +4,8 @@
 NAWidget::NAWidget(QWidget *parent)
     : QWidget{parent},
     customPlot(new QCustomPlot(this)),
+    traceDecimator(new TraceDecimator(customPlot, this)),
+    renderScheduler(new RenderScheduler(customPlot, this)),
     dataTimer(new QTimer(this)),
     pkThreshold(-100),
     pkExcurs(6),
@@ -20,7 +22,8 @@ NAWidget::NAWidget(QWidget *parent)
     frequencyRangeChanged(false),
     hardwareTool(nullptr),
     browser_NA(nullptr),
-    dataCount(401)
+    dataCount(401),
+    historyPanel(nullptr)
 {
     setMinimumWidth(1500);
     setMinimumHeight(800);
@@ -79,7 +82,7 @@ NAWidget::NAWidget(QWidget *parent)
     pushButton_Stop->setIcon(QIcon(":/images/icons/stop.png"));
     connect(pushButton_Stop, &QPushButton::clicked, this, [=]() {
         logger::log(browser_NA, QStringLiteral("[Mode] Sweep stopped by user."));
-        dataTimer->stop();
+        setMode(SingleMode);
 
         if (tabWidget && tab_logArea) {
             int logIndex = tabWidget->indexOf(tab_logArea);
@@ -153,6 +156,11 @@ NAWidget::NAWidget(QWidget *parent)
     connect(pushButton_Traces_Export, &QPushButton::clicked, this, &NAWidget::onExportTraceData);
     hbox_Traces->addWidget(pushButton_Traces_Export);
 
+    QPushButton *pushButton_Traces_ExportSParam = new QPushButton("S-Param");
+    pushButton_Traces_ExportSParam->setToolTip("Export the last sweep as a Touchstone .s1p/.s2p file");
+    connect(pushButton_Traces_ExportSParam, &QPushButton::clicked, this, &NAWidget::onExportSParametersClicked);
+    hbox_Traces->addWidget(pushButton_Traces_ExportSParam);
+
     QPushButton *pushButton_Traces_Clear = new QPushButton("Clear");
     connect(pushButton_Traces_Clear, &QPushButton::clicked, this, &NAWidget::onTraceClearClicked);
     hbox_Traces->addWidget(pushButton_Traces_Clear);
@@ -246,7 +254,7 @@ NAWidget::NAWidget(QWidget *parent)
         checkBox_Markers_Active->setChecked(false);
         checkBox_Markers_Active->blockSignals(wasBlocked);
         updateMarkerLabel();
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     });
 
     gridLayout_Markers->addWidget(pushButton_Markers_PeakSearch, 0, 0);
@@ -268,7 +276,11 @@ NAWidget::NAWidget(QWidget *parent)
     QSplitter *splitter_Middle = new QSplitter(Qt::Vertical, splitter_mainHorizontalLayout);
     splitter_Middle->setChildrenCollapsible(false);
 
+    // No frames while a blocking instrument call has the widget half updated
+    renderScheduler->setHold([this]() { return hardwareTool && hardwareTool->isInCall(); });
+
     // Setup multiple graphs for multiple traces
+    customPlot->setCurrentLayer(renderScheduler->tracesLayer());
     for (int i = 0; i < MAX_TRACES; ++i) {
         customPlot->addGraph();
         traces[i].updateEnabled = true;
@@ -307,13 +319,15 @@ NAWidget::NAWidget(QWidget *parent)
 
     tab_logArea = new QWidget(tabWidget);
     QVBoxLayout *verticalLayout_SA_logArea = new QVBoxLayout;
-    browser_NA = new QTextBrowser;
-    browser_NA->setStyleSheet("QTextBrowser { border: none; }");
-    browser_NA->document()->setMaximumBlockCount(20);
+    browser_NA = new LogView(QStringLiteral("NA"));
     verticalLayout_SA_logArea->addWidget(browser_NA);
     tab_logArea->setLayout(verticalLayout_SA_logArea);
     tabWidget->addTab(tab_logArea, "General Messages");
 
+    historyPanel = new SweepHistoryPanel("na_sweeps.bin", 1024, MAX_TRACES, 401, tabWidget);
+    connect(historyPanel, &SweepHistoryPanel::sweepSelected, this, &NAWidget::onHistorySweepSelected);
+    tabWidget->addTab(historyPanel, "Sweep History");
+
     // Single-Port Cali controls
     QWidget *tab_SinglePortCali = new QWidget(tabWidget);
     QVBoxLayout* spLayout = new QVBoxLayout;
@@ -583,13 +597,20 @@ NAWidget::NAWidget(QWidget *parent)
     spinBox_Acquisition_SwpTime->setValue(1);
     // formLayout_Acquisition->addRow("Swp Time", spinBox_Acquisition_SwpTime);
 
+    // Minimum time between sweep starts in Auto mode; 0 = free run
     spinBox_Acquisition_SwpInterval = new QSpinBox;
-    spinBox_Acquisition_SwpInterval->setRange(1, 1e6);
+    spinBox_Acquisition_SwpInterval->setRange(0, 1e6);
     spinBox_Acquisition_SwpInterval->setSuffix(" ms");
-    spinBox_Acquisition_SwpInterval->setValue(50);
-    connect(spinBox_Acquisition_SwpInterval, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int value) { dataTimer->setInterval(value); });
+    spinBox_Acquisition_SwpInterval->setSpecialValueText("Free run");
+    spinBox_Acquisition_SwpInterval->setValue(0);
+    spinBox_Acquisition_SwpInterval->setToolTip("Rate cap for Auto mode. Free run starts the next sweep as soon as one completes.");
     formLayout_Acquisition->addRow("Swp Interval", spinBox_Acquisition_SwpInterval);
 
+    m_checkBoxTouchstoneLog = new QCheckBox("");
+    m_checkBoxTouchstoneLog->setToolTip("Write every new sweep to a numbered Touchstone file series");
+    connect(m_checkBoxTouchstoneLog, &QCheckBox::toggled, this, &NAWidget::onTouchstoneLogToggled);
+    formLayout_Acquisition->addRow("Touchstone Log", m_checkBoxTouchstoneLog);
+
     groupBox_Acquisition->setContentLayout(formLayout_Acquisition);
     verticalLayout_Right->addWidget(groupBox_Acquisition);
 
@@ -605,10 +626,12 @@ NAWidget::NAWidget(QWidget *parent)
     setLayout(mainLayout);
 
     // Initialize markers
+    customPlot->setCurrentLayer(renderScheduler->markersLayer());
     for (int i = 1; i <= 9; ++i) {
         QString markerName = QString("Marker %1").arg(i);
         markers[markerName] = new Marker(customPlot, markerName);
     }
+    customPlot->setCurrentLayer("main");
 
     markerLabel->setStyleSheet("QLabel { background-color : transparent; color : black; }");
     markerLabel->setVisible(false);  // Initially hidden
@@ -621,45 +644,47 @@ NAWidget::NAWidget(QWidget *parent)
     customPlot->installEventFilter(this);
 
     // Setup timer for auto mode updates
-    dataTimer->setInterval(spinBox_Acquisition_SwpInterval->value());
+    // In Auto mode sweeps are chained off completions; the timer only paces
+    // them when a rate cap is set, or polls while no trace needs data.
+    dataTimer->setSingleShot(true);
     connect(dataTimer, &QTimer::timeout, this, &NAWidget::updatePlot);
 
     // setMode(AutoMode); // Set initial mode to AutoMode
 
-    // --- Threaded acquisition setup ---
-    m_workerThread = new QThread(this);
-    m_worker = new NAWorker(hardwareTool, m_workerThread);
-    m_worker->moveToThread(m_workerThread);
+    // --- Export thread: file formatting and disk I/O ---
+    m_exportThread = new QThread(this);
+    m_exportWorker = new ExportWorker;  // no parent: it is moved to m_exportThread
+    m_exportWorker->moveToThread(m_exportThread);
+    connect(m_exportThread, &QThread::finished, m_exportWorker, &QObject::deleteLater);
 
-    connect(this,     &NAWidget::requestSinglePort,
-            m_worker, &NAWorker::measureSinglePortAsync);
-    connect(m_worker, &NAWorker::singlePortReady,
-            this,     &NAWidget::onSinglePortDataReady,
-            Qt::QueuedConnection);
-    connect(this,      &NAWidget::requestDualPort,
-            m_worker,  &NAWorker::measureDualPortAsync);
-    connect(m_worker,  &NAWorker::dualPortReady,
-            this,      &NAWidget::onDualPortDataReady,
+    connect(this,           &NAWidget::requestTouchstoneExport,
+            m_exportWorker, &ExportWorker::writeTouchstone);
+    connect(m_exportWorker, &ExportWorker::exportFinished,
+            this,           &NAWidget::onExportFinished,
             Qt::QueuedConnection);
 
-    m_workerThread->start();
+    m_exportThread->start();
 }
 
 NAWidget::~NAWidget()
 {
-    if (m_workerThread) {
-        m_workerThread->quit();
-        m_workerThread->wait();
+    // Let queued exports finish so no half-written file is left behind
+    if (m_exportThread) {
+        m_exportThread->quit();
+        m_exportThread->wait();
     }
 }
 
 void NAWidget::setMode(NAWidget::Mode mode) {
     currentMode = mode;
+    m_resumeOnLink = false;     // an explicit mode choice overrides a pending resume
     if (currentMode == AutoMode) {
-        // Start continuous data updates
-        dataTimer->start();
+        m_sweepFailures = 0;
+        // Back to live data: undo any span a history sweep put on the axis
+        customPlot->xAxis->setRange(startPoint, endPoint);
+        // Continuous updates are chained off sweep completions (onSweepCompleted)
     } else {
-        // Stop continuous updates
+        // Sweeps still in flight land and are shown, but start no successor
         dataTimer->stop();
     }
 }
@@ -685,8 +710,33 @@ QVector<double>& NAWidget::getDataForTrace(int index)
     }
 }
 
+void NAWidget::suspendAcquisition()
+{
+    if (currentMode != AutoMode)
+        return;
+    logger::log(browser_NA, QStringLiteral("[NA] link lost - continuous sweep paused."));
+    setMode(SingleMode);
+    m_resumeOnLink = true;
+    ++m_sweepGeneration;    // whatever is in flight fails with the link
+}
+
+void NAWidget::resumeAcquisition()
+{
+    if (!m_resumeOnLink)
+        return;
+    logger::log(browser_NA, QStringLiteral("[NA] link restored - continuous sweep resumed."));
+    m_resumeOnLink = false;
+    setMode(AutoMode);
+    updatePlot();
+}
+
 void NAWidget::updatePlot()
 {
+    // Not inside a blocking call(): its caller may be half way through
+    // changing the settings and buffers this works on
+    if (hardwareTool && hardwareTool->deferWhileInCall(this, [this]() { updatePlot(); }))
+        return;
+
     if (frequencyRangeChanged) {
         for (int i = 0; i < MAX_TRACES; ++i) {
             // Clear arrays to start fresh
@@ -711,25 +761,108 @@ void NAWidget::updatePlot()
     }
 
     if (needData) {
-        if (!m_pendingReady) {
-            // fire off asynchronous request - GUI returns immediately
-            auto type = static_cast<Rfmu2NetworkAnalyzer::ResultType>(
-                m_comboBoxMeasType->currentData().toUInt());
-            const bool single = m_comboBoxMeasType->currentText().startsWith("Single-Port");
-            if (single)
-                emit requestSinglePort(type);
-            else
-                emit requestDualPort(type);
-
-            return; // wait until data arrives next timer tick
-        }
+        requestSweeps(); // traces are refreshed when the sweep completes
+        return;
+    }
+
+    refreshTraces();
+    if (currentMode == AutoMode)
+        dataTimer->start(qMax(spinBox_Acquisition_SwpInterval->value(), kIdlePollMs));
+}
+
+void NAWidget::requestSweeps()
+{
+    if (!hardwareTool)
+        return;
+
+    // Free run keeps a second sweep queued behind the running one, so the
+    // I/O thread starts it the moment the first completes.
+    const bool freeRun = (currentMode == AutoMode && spinBox_Acquisition_SwpInterval->value() == 0);
+    const int depth = freeRun ? kMaxSweepsInFlight : 1;
+
+    auto type = static_cast<Rfmu2NetworkAnalyzer::ResultType>(
+        m_comboBoxMeasType->currentData().toUInt());
+    const bool single = m_comboBoxMeasType->currentText().startsWith("Single-Port");
+    auto na = hardwareTool->networkAnalyzer();
+    const quint32 generation = m_sweepGeneration;
+
+    while (m_sweepsInFlight < depth) {
+        ++m_sweepsInFlight;
+        m_sweepClock.start();
+        const quint64 traceId = Rfmu2Trace::isEnabled() ? Rfmu2Trace::newId() : 0;
+        Rfmu2Trace::asyncBegin("sweep", traceId);
+        Rfmu2TraceScope trace(traceId);
+        hardwareTool->submit(Rfmu2Priority::Streaming,
+            [na, type, single]() {
+                return single ? na->measureSinglePort(type) : na->measureDualPort(type);
+            },
+            this, [this, type, generation](const QVector<double> &raw) {
+                --m_sweepsInFlight;
+                if (generation == m_sweepGeneration)
+                    onSweepCompleted(type, raw);
+                else
+                    renderScheduler->noteSweepDropped();
+            });
+    }
+}
+
+void NAWidget::onSweepCompleted(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw)
+{
+    Rfmu2TraceSpan span("process");
+    logger::log(browser_NA, QStringLiteral("[NA] data returned."));
+    if (!acquireSweepData(type, raw)) {
+        renderScheduler->noteSweepDropped();
+        scheduleNextSweep(true);
+        return;
+    }
+    renderScheduler->noteSweepArrived();
+
+    if (historyPanel && historyPanel->isRecording() && !m_freqs.isEmpty()) {
+        const QString config = QString("meas=%1;type=%2;points=%3")
+                                   .arg(m_comboBoxMeasType->currentIndex())
+                                   .arg(m_comboBoxMeasType->currentText())
+                                   .arg(dataCount);
+        historyPanel->record(config.toUtf8(), m_freqs,
+                             {m_s11_ampI, m_s21_ampI, m_s12_ampI, m_s22_ampI,
+                              m_s11_phaseQ, m_s21_phaseQ, m_s12_phaseQ, m_s22_phaseQ});
+    }
+
+    if (m_checkBoxTouchstoneLog->isChecked())
+        logTouchstoneSweep();
+
+    refreshTraces();
+    scheduleNextSweep();
+}
 
-        logger::log(browser_NA, QStringLiteral("[NA] data returned."));
-        acquireSweepData(m_pendingType, m_pendingRaw);
-        m_pendingRaw.clear();
-        m_pendingReady = false;
+void NAWidget::scheduleNextSweep(bool failed)
+{
+    m_sweepFailures = failed ? m_sweepFailures + 1 : 0;
+
+    // Chain the next sweep off this one instead of a fixed poll interval;
+    // a rate cap only delays it by what is left of the cap.
+    if (currentMode != AutoMode || dataTimer->isActive())
+        return;
+
+    // A sweep that fails at once (no link, write error, timeout) must not
+    // be resubmitted at once: back off, and stop after a few in a row.
+    if (m_sweepFailures >= kMaxSweepFailures) {
+        logger::log(browser_NA, QStringLiteral("[NA] %1 sweeps failed in a row - continuous sweep stopped.")
+                                    .arg(m_sweepFailures));
+        setMode(SingleMode);
+        return;
     }
 
+    qint64 waitMs = spinBox_Acquisition_SwpInterval->value() - m_sweepClock.elapsed();
+    if (m_sweepFailures > 0)
+        waitMs = qMax<qint64>(waitMs, qMin(kIdlePollMs << (m_sweepFailures - 1), kFailureBackoffMaxMs));
+    if (waitMs <= 0)
+        updatePlot();
+    else
+        dataTimer->start(int(waitMs));
+}
+
+void NAWidget::refreshTraces()
+{
     for (int i = 0; i < MAX_TRACES; ++i) {
         if (traces[i].type == Off) {
             customPlot->graph(i)->setVisible(false);
@@ -758,7 +891,7 @@ void NAWidget::updatePlot()
         case ClearWrite:
             if (newDataAcquired)
                 applyClearWrite(i, srcFreqs, srcAmps);
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -768,7 +901,7 @@ void NAWidget::updatePlot()
         case MaxHold:
             if (newDataAcquired)
                 applyMaxHold(i, srcFreqs, srcAmps);
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -779,7 +912,7 @@ void NAWidget::updatePlot()
             if (newDataAcquired)
                 applyMinHold(i, srcFreqs, srcAmps);
             // For MinHold, display only one line (use main line graph(i))
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -794,12 +927,12 @@ void NAWidget::updatePlot()
             // graph(i) = max line, graph(i + MAX_TRACES) = min line
             if (traces[i].freqs.isEmpty() || traces[i].amps.isEmpty() || traces[i].minAmps.isEmpty()) {
                 // If no data yet, provide empty sets
-                customPlot->graph(i)->setData(QVector<double>(), QVector<double>());
-                customPlot->graph(i + MAX_TRACES)->setData(QVector<double>(), QVector<double>());
+                traceDecimator->clearGraphData(customPlot->graph(i));
+                traceDecimator->clearGraphData(customPlot->graph(i + MAX_TRACES));
             } else {
                 // Use amps for main (max) line, minAmps for min line
-                customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
-                customPlot->graph(i + MAX_TRACES)->setData(traces[i].freqs, traces[i].minAmps);
+                traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
+                traceDecimator->setGraphData(customPlot->graph(i + MAX_TRACES), traces[i].freqs, traces[i].minAmps);
             }
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(!traces[i].hide);
@@ -815,7 +948,7 @@ void NAWidget::updatePlot()
             if (newDataAcquired)
                 applyAverage(i, srcFreqs, srcAmps);
 
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -850,12 +983,62 @@ void NAWidget::updatePlot()
     }
 
     updateMarkerLabel();
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces | RenderScheduler::Markers);
+}
+
+void NAWidget::onHistorySweepSelected(const Rfmu2SweepHistory::Sweep &sweep)
+{
+    if (sweep.channels.size() != MAX_TRACES)
+        return;
+
+    // Looking at the past: stop overwriting the plot with live sweeps,
+    // including any that are still in flight.
+    if (currentMode == AutoMode)
+        setMode(SingleMode);
+    ++m_sweepGeneration;
+
+    // Show the sweep with the measurement type it was taken with.
+    for (const QByteArray &field : sweep.config.split(';')) {
+        if (field.startsWith("meas=")) {
+            const int measIndex = field.mid(5).toInt();
+            if (measIndex >= 0 && measIndex < m_comboBoxMeasType->count()
+                && measIndex != m_comboBoxMeasType->currentIndex())
+                m_comboBoxMeasType->setCurrentIndex(measIndex);
+        }
+    }
+
+    m_freqs = sweep.keys;
+    m_s11_ampI   = sweep.channels[0];
+    m_s21_ampI   = sweep.channels[1];
+    m_s12_ampI   = sweep.channels[2];
+    m_s22_ampI   = sweep.channels[3];
+    m_s11_phaseQ = sweep.channels[4];
+    m_s21_phaseQ = sweep.channels[5];
+    m_s12_phaseQ = sweep.channels[6];
+    m_s22_phaseQ = sweep.channels[7];
+
+    if (!m_freqs.isEmpty())
+        customPlot->xAxis->setRange(qMin(m_freqs.first(), m_freqs.last()),
+                                    qMax(m_freqs.first(), m_freqs.last()));
+    refreshTraces();
 }
 
-void NAWidget::acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &rawData)
+bool NAWidget::acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &rawData)
 {
     qDebug() << " ---double vector--- \n" << rawData;
+
+    // Validate before touching the buffers: a rejected sweep leaves the last good one in place
+    const int wordsPerPoint =
+        (type == Rfmu2NetworkAnalyzer::ResultType::Complex ||
+         type == Rfmu2NetworkAnalyzer::ResultType::LogAmpPhase) ? 2 : 1;
+
+    const int ports = dataCount > 0 ? rawData.size() / (wordsPerPoint * dataCount) : 0;
+    if ((ports != 1 && ports != 4) || rawData.size() != ports * wordsPerPoint * dataCount) {
+        logger::log(browser_NA,
+                    tr("[NA] unexpected payload size %1").arg(rawData.size()));
+        return false;
+    }
+
     if (m_freqs.size() != dataCount)
         m_freqs.resize(dataCount);
 
@@ -876,17 +1059,6 @@ void NAWidget::acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVe
     std::fill(m_s12_phaseQ.begin(), m_s12_phaseQ.end(), 0.0);
     std::fill(m_s22_phaseQ.begin(), m_s22_phaseQ.end(), 0.0);
 
-    const int wordsPerPoint =
-        (type == Rfmu2NetworkAnalyzer::ResultType::Complex ||
-         type == Rfmu2NetworkAnalyzer::ResultType::LogAmpPhase) ? 2 : 1;
-
-    const int ports = rawData.size() / (wordsPerPoint * dataCount);
-    if (ports != 1 && ports != 4) {
-        logger::log(browser_NA,
-                    tr("[NA] unexpected payload size %1").arg(rawData.size()));
-        return;
-    }
-
     if (ports == 1) {
         parseSinglePortData(type, rawData, m_s11_ampI, m_s11_phaseQ);
     } else {
@@ -894,6 +1066,7 @@ void NAWidget::acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVe
                           m_s11_ampI, m_s21_ampI, m_s12_ampI, m_s22_ampI,
                           m_s11_phaseQ, m_s21_phaseQ, m_s12_phaseQ, m_s22_phaseQ);
     }
+    return true;
 }
 
 void NAWidget::applyClearWrite(int traceIndex, const QVector<double> &newFreqs, const QVector<double> &newAmps)
@@ -1023,6 +1196,44 @@ void NAWidget::AdjustSweepRange()
     frequencyRangeChanged = true;
 }
 
+bool NAWidget::applySweepSettings()
+{
+    if (!hardwareTool || !hardwareTool->networkAnalyzer()) {
+        logger::log(browser_NA, QStringLiteral("NetworkAnalyzer is null!"));
+        return false;
+    }
+
+    Rfmu2NetworkAnalyzer::SweepConfig cfg;
+    cfg.startKHz = static_cast<int>(spinBox_Frequency_Start->frequency() / 1000.0);
+    cfg.stopKHz  = static_cast<int>(spinBox_Frequency_Stop->frequency() / 1000.0);
+    cfg.startDb  = spinBox_Level_Start->value();
+    cfg.stopDb   = spinBox_Level_Stop->value();
+    cfg.points   = mPointsEdit->value();
+    cfg.port1    = mPort1Edit->currentText();
+    cfg.port2    = mPort2Edit->currentText();
+
+    auto na = hardwareTool->networkAnalyzer();
+    bool ok = hardwareTool->call([na, cfg] { return na->configureSweep(cfg); });
+    logger::log(browser_NA,ok ? QStringLiteral("[NA] Sweep settings configured.") : QStringLiteral("[NA] Sweep settings configuration failed."));
+
+    if (tabWidget && tab_logArea) {
+        int logIndex = tabWidget->indexOf(tab_logArea);
+        if (logIndex >= 0 && tabWidget->currentIndex() != logIndex)
+            tabWidget->setCurrentIndex(logIndex);
+    }
+
+    if (ok) {
+        startFrequency = spinBox_Frequency_Start->frequency();
+        stopFrequency = spinBox_Frequency_Stop->frequency();
+        startLevel = spinBox_Level_Start->value();
+        stopLevel = spinBox_Level_Stop->value();
+        dataCount = cfg.points;
+        allocateBuffers(dataCount);
+        AdjustSweepRange();
+    }
+    return ok;
+}
+
 void NAWidget::onFreqSweepClicked()
 {
     if (!hardwareTool || !hardwareTool->networkAnalyzer()) {
@@ -1033,7 +1244,8 @@ void NAWidget::onFreqSweepClicked()
     int startKHz = static_cast<int>(spinBox_Frequency_Start->frequency() / 1000.0);
     int stopKHz = static_cast<int>(spinBox_Frequency_Stop->frequency() / 1000.0);
 
-    bool ok = hardwareTool->networkAnalyzer()->configureFrequencySweep(startKHz, stopKHz);
+    auto na = hardwareTool->networkAnalyzer();
+    bool ok = hardwareTool->call([na, startKHz, stopKHz] { return na->configureFrequencySweep(startKHz, stopKHz); });
     logger::log(browser_NA,ok ? QStringLiteral("[NA] Freq sweep configured.") : QStringLiteral("[NA] Freq sweep configuration failed."));
 
     if (tabWidget && tab_logArea) {
@@ -1059,7 +1271,8 @@ void NAWidget::onLevelSweepClicked()
     double startDb = spinBox_Level_Start->value();
     double stopDb = spinBox_Level_Stop->value();
 
-    bool ok = hardwareTool->networkAnalyzer()->configurePowerSweep(startDb, stopDb);
+    auto na = hardwareTool->networkAnalyzer();
+    bool ok = hardwareTool->call([na, startDb, stopDb] { return na->configurePowerSweep(startDb, stopDb); });
     logger::log(browser_NA,ok ? QStringLiteral("[NA] Level sweep configured.") : QStringLiteral("[NA] Level sweep configuration failed."));
 
     if (tabWidget && tab_logArea) {
@@ -1086,7 +1299,8 @@ void NAWidget::onPointsPortsClicked()
     QString p1 = mPort1Edit->currentText();
     QString p2 = mPort2Edit->currentText();
 
-    bool ok = hardwareTool->networkAnalyzer()->configurePointsAndPorts(pts, p1, p2);
+    auto na = hardwareTool->networkAnalyzer();
+    bool ok = hardwareTool->call([na, pts, p1, p2] { return na->configurePointsAndPorts(pts, p1, p2); });
     logger::log(browser_NA,ok ? QStringLiteral("[NA] Points/Ports configured.") : QStringLiteral("[NA] Points/Ports configuration failed."));
 
     if (tabWidget && tab_logArea) {
@@ -1108,28 +1322,28 @@ void NAWidget::onPointsPortsClicked()
 void NAWidget::onSingleCaliOpenClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateSinglePortOpen() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateSinglePortOpen(); }) : false;
     emit naSinglePortCali(ok ? "[SingleCali] Open succeeded." : "[SingleCali] Open failed.");
 }
 
 void NAWidget::onSingleCaliShortClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateSinglePortShort() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateSinglePortShort(); }) : false;
     emit naSinglePortCali(ok ? "[SingleCali] Short succeeded." : "[SingleCali] Short failed.");
 }
 
 void NAWidget::onSingleCaliLoadStepClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateSinglePortLoad() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateSinglePortLoad(); }) : false;
     emit naSinglePortCali(ok ? "[SingleCali] Load succeeded." : "[SingleCali] Load failed.");
 }
 
 void NAWidget::onSingleCaliFinishClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->finishSinglePortCalibration() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->finishSinglePortCalibration(); }) : false;
     emit naSinglePortCali(ok ? "[SingleCali] Finish succeeded." : "[SingleCali] Finish failed.");
 }
 
@@ -1142,7 +1356,7 @@ void NAWidget::onSingleCaliSaveFileClicked()
         return;
     }
     int fileNum = mSingleFileEdit->text().toInt();
-    bool ok = na->saveSinglePortCalibrationState(fileNum);
+    bool ok = hardwareTool->call([na, fileNum] { return na->saveSinglePortCalibrationState(fileNum); });
     emit naSinglePortCali(ok ? "[SingleCaliFile] Save succeeded." : "[SingleCaliFile] Save failed.");
 }
 
@@ -1156,7 +1370,7 @@ void NAWidget::onSingleCaliLoadFileClicked()
     }
     int fileNum = mSingleFileEdit->text().toInt();
     bool parseOk = false;
-    auto data = na->loadSinglePortCalibrationState(fileNum, &parseOk);
+    auto data = hardwareTool->call([na, fileNum, &parseOk] { return na->loadSinglePortCalibrationState(fileNum, &parseOk); });
     if(!parseOk)
     {
         emit naSinglePortCali("[SingleCaliFile] parse failed.");
@@ -1183,10 +1397,8 @@ void NAWidget::onSingleCaliLoadFileClicked()
     mPointsEdit->setValue(data.sweepPoints);
     mPort1Edit->setCurrentText(port1Label);
 
-    // Invoke the slots to apply parameters
-    onFreqSweepClicked();
-    onLevelSweepClicked();
-    onPointsPortsClicked();
+    // Apply all three together; unchanged settings are not resent
+    applySweepSettings();
 }
 
 // --------------------------------------------------
@@ -1195,63 +1407,63 @@ void NAWidget::onSingleCaliLoadFileClicked()
 void NAWidget::onDualCaliOpen1Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortOpen1() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortOpen1(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Open1 succeeded." : "[DualCali] Open1 failed.");
 }
 
 void NAWidget::onDualCaliShort1Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortShort1() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortShort1(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Short1 succeeded." : "[DualCali] Short1 failed.");
 }
 
 void NAWidget::onDualCaliLoad1StepClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortLoad1() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortLoad1(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Load1 succeeded." : "[DualCali] Load1 failed.");
 }
 
 void NAWidget::onDualCaliThrough1Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortThrough1() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortThrough1(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Through1 succeeded." : "[DualCali] Through1 failed.");
 }
 
 void NAWidget::onDualCaliOpen2Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortOpen2() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortOpen2(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Open2 succeeded." : "[DualCali] Open2 failed.");
 }
 
 void NAWidget::onDualCaliShort2Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortShort2() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortShort2(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Short2 succeeded." : "[DualCali] Short2 failed.");
 }
 
 void NAWidget::onDualCaliLoad2StepClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortLoad2() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortLoad2(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Load2 succeeded." : "[DualCali] Load2 failed.");
 }
 
 void NAWidget::onDualCaliThrough2Clicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->calibrateDualPortThrough2() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->calibrateDualPortThrough2(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Through2 succeeded." : "[DualCali] Through2 failed.");
 }
 
 void NAWidget::onDualCaliFinishClicked()
 {
     auto na = hardwareTool->networkAnalyzer();
-    bool ok = na ? na->finishDualPortCalibration() : false;
+    bool ok = na ? hardwareTool->call([na] { return na->finishDualPortCalibration(); }) : false;
     emit naDualPortCali(ok ? "[DualCali] Finish succeeded." : "[DualCali] Finish failed.");
 }
 
@@ -1264,7 +1476,7 @@ void NAWidget::onDualCaliSaveFileClicked()
         return;
     }
     int fileNum = mDualFileEdit->text().toInt();
-    bool ok = na->saveDualPortCalibrationState(fileNum);
+    bool ok = hardwareTool->call([na, fileNum] { return na->saveDualPortCalibrationState(fileNum); });
     emit naDualPortCali(ok ? "[DualCaliFile] Save succeeded." : "[DualCaliFile] Save failed.");
 }
 
@@ -1278,7 +1490,7 @@ void NAWidget::onDualCaliLoadFileClicked()
     }
     int fileNum = mDualFileEdit->text().toInt();
     bool parseOk = false;
-    auto data = na->loadDualPortCalibrationState(fileNum, &parseOk);
+    auto data = hardwareTool->call([na, fileNum, &parseOk] { return na->loadDualPortCalibrationState(fileNum, &parseOk); });
     if(!parseOk)
     {
         emit naDualPortCali("[DualCaliFile] parse failed.");
@@ -1307,10 +1519,8 @@ void NAWidget::onDualCaliLoadFileClicked()
     mPort1Edit->setCurrentText(port1Label);
     mPort2Edit->setCurrentText(port2Label);
 
-    // Invoke the slots to apply parameters
-    onFreqSweepClicked();
-    onLevelSweepClicked();
-    onPointsPortsClicked();
+    // Apply all three together; unchanged settings are not resent
+    applySweepSettings();
 }
 
 bool NAWidget::eventFilter(QObject *obj, QEvent *event)
@@ -1345,7 +1555,7 @@ void NAWidget::placeMarkerAtClick(QMouseEvent *event)
     checkBox_Markers_Active->blockSignals(wasBlocked);
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::updateMarker(Marker *marker)
@@ -1358,11 +1568,8 @@ void NAWidget::updateMarker(Marker *marker)
     double freq = traces[tIndex].freqs[index];
     double amp = traces[tIndex].amps[index];
 
-    marker->tracer->setGraph(customPlot->graph(tIndex));
-    marker->deltaTracer->setGraph(customPlot->graph(tIndex));
-    marker->tracer->setInterpolating(false);
     marker->setVisible(true);
-    marker->setPosition(freq, amp);
+    marker->setPosition(customPlot->graph(tIndex), freq, amp);
 
     updateMarkerLabel();
 }
@@ -1384,7 +1591,7 @@ void NAWidget::peakSearch()
     checkBox_Markers_Active->setChecked(true);
     checkBox_Markers_Active->blockSignals(wasBlocked);
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::keyPressEvent(QKeyEvent *event)
@@ -1403,11 +1610,11 @@ void NAWidget::keyPressEvent(QKeyEvent *event)
             if (event->key() == Qt::Key_Left && marker->index > 0) {
                 marker->index--;
                 updateMarker(marker);
-                customPlot->replot();
+                renderScheduler->markDirty(RenderScheduler::Markers);
             } else if (event->key() == Qt::Key_Right && marker->index < freqs.size() - 1) {
                 marker->index++;
                 updateMarker(marker);
-                customPlot->replot();
+                renderScheduler->markDirty(RenderScheduler::Markers);
             }
         }
     }
@@ -1460,13 +1667,13 @@ void NAWidget::onMarkerActiveStateChanged(int state)
         }
 
         updateMarker(marker);
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     } else {
         // Deactivate the marker
         marker->active = false;
         marker->setVisible(false);
         updateMarkerLabel();
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     }
 }
 
@@ -1551,7 +1758,7 @@ void NAWidget::onDeltaButtonClicked()
     // If active, proceed as normal
     marker->toggleDeltaMode();
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::onValueOfSetFreqChanged(double frequency)
@@ -1572,7 +1779,7 @@ void NAWidget::onValueOfSetFreqChanged(double frequency)
     checkBox_Markers_Active->setChecked(true);
     checkBox_Markers_Active->blockSignals(wasBlocked);
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::onPkTrackingStateChanged(int state)
@@ -1587,7 +1794,7 @@ void NAWidget::onPkTrackingStateChanged(int state)
         checkBox_Markers_Active->setChecked(true);
         checkBox_Markers_Active->blockSignals(wasBlocked);
         updateMarker(marker);
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     }
 }
 
@@ -1630,6 +1837,158 @@ void NAWidget::onExportTraceData()
     QMessageBox::information(this, "Export Complete", "The trace data has been exported successfully.");
 }
 
+bool NAWidget::currentSParameters(Rfmu2SParameters &out, QString &error)
+{
+    using ResultType = Rfmu2NetworkAnalyzer::ResultType;
+
+    const auto type = static_cast<ResultType>(m_comboBoxMeasType->currentData().toUInt());
+    const bool single = m_comboBoxMeasType->currentText().startsWith("Single-Port");
+
+    if (m_freqs.isEmpty()) {
+        error = "No sweep data is available yet.";
+        return false;
+    }
+    if (!isFreqSweep()) {
+        error = "Touchstone files need a frequency sweep; the current sweep steps the level.";
+        return false;
+    }
+    if (type == ResultType::Phase) {
+        error = "Phase-only measurements carry no magnitude. Use Complex, LogAmp or LogAmpPhase.";
+        return false;
+    }
+
+    const QVector<double> *amps[4]   = { &m_s11_ampI,   &m_s21_ampI,   &m_s12_ampI,   &m_s22_ampI };
+    const QVector<double> *phases[4] = { &m_s11_phaseQ, &m_s21_phaseQ, &m_s12_phaseQ, &m_s22_phaseQ };
+
+    out = Rfmu2SParameters();
+    out.ports = single ? 1 : 2;
+    out.freqsHz = m_freqs;
+    out.comment = QString("Measurement: %1, %2 points").arg(m_comboBoxMeasType->currentText()).arg(m_freqs.size());
+
+    const int params = out.ports * out.ports;
+    for (int p = 0; p < params; ++p) {
+        if (amps[p]->size() != m_freqs.size() || phases[p]->size() != m_freqs.size()) {
+            error = "The S-parameter data does not match the frequency axis.";
+            return false;
+        }
+    }
+
+    switch (type) {
+    case ResultType::Complex:
+        out.format = Rfmu2SParameters::Format::RealImag;
+        for (int p = 0; p < params; ++p) {
+            out.first[p] = *amps[p];     // implicitly shared, no copy
+            out.second[p] = *phases[p];
+        }
+        break;
+    case ResultType::LogAmp:
+    case ResultType::LogAmpPhase:
+        out.format = Rfmu2SParameters::Format::DbAngle;
+        for (int p = 0; p < params; ++p) {
+            out.first[p] = *amps[p];
+            // Phase arrives in rad; LogAmp has none and is written as 0 deg
+            QVector<double> deg(phases[p]->size());
+            for (int i = 0; i < deg.size(); ++i)
+                deg[i] = qRadiansToDegrees((*phases[p])[i]);
+            out.second[p] = deg;
+        }
+        if (type == ResultType::LogAmp)
+            out.comment += "\nPhase not measured (LogAmp); angles are written as 0.";
+        break;
+    case ResultType::Phase:
+        break;
+    }
+    return true;
+}
+
+void NAWidget::onExportSParametersClicked()
+{
+    Rfmu2SParameters data;
+    QString error;
+    if (!currentSParameters(data, error)) {
+        QMessageBox::warning(this, "Export S-Parameters", error);
+        return;
+    }
+
+    const QString suffix = Rfmu2TouchstoneWriter::fileSuffix(data.ports);
+    const QString filterV1 = QString("Touchstone v1.1 (*%1)").arg(suffix);
+    const QString filterV2 = QString("Touchstone v2.0 (*%1)").arg(suffix);
+    QString selectedFilter = filterV1;
+    QString fileName = QFileDialog::getSaveFileName(this, "Export S-Parameters", QString(),
+                                                    filterV1 + ";;" + filterV2, &selectedFilter);
+    if (fileName.isEmpty())
+        return;
+    if (!fileName.endsWith(suffix, Qt::CaseInsensitive))
+        fileName += suffix;
+
+    ++m_exportsInFlight;
+    emit requestTouchstoneExport(fileName, data, selectedFilter == filterV2);
+}
+
+void NAWidget::onTouchstoneLogToggled(bool checked)
+{
+    if (!checked) {
+        if (!m_touchstoneLogDir.isEmpty())
+            logger::log(browser_NA, QString("[NA] Touchstone log stopped after %1 sweeps (%2 dropped).")
+                                        .arg(m_touchstoneLogIndex).arg(m_exportsDropped));
+        m_touchstoneLogDir.clear();
+        return;
+    }
+
+    const QString dir = QFileDialog::getExistingDirectory(this, "Touchstone Log Directory");
+    if (dir.isEmpty()) {
+        QSignalBlocker blocker(m_checkBoxTouchstoneLog);
+        m_checkBoxTouchstoneLog->setChecked(false);
+        return;
+    }
+
+    m_touchstoneLogDir = dir;
+    m_touchstoneLogPrefix = "na_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    m_touchstoneLogIndex = 0;
+    m_exportsDropped = 0;
+    logger::log(browser_NA, QString("[NA] Touchstone log started: %1/%2_*")
+                                .arg(m_touchstoneLogDir, m_touchstoneLogPrefix));
+}
+
+void NAWidget::logTouchstoneSweep()
+{
+    if (m_touchstoneLogDir.isEmpty())
+        return;
+
+    // Disk slower than the sweep: drop rather than queue without bound
+    if (m_exportsInFlight >= kMaxExportsInFlight) {
+        ++m_exportsDropped;
+        return;
+    }
+
+    Rfmu2SParameters data;
+    QString error;
+    if (!currentSParameters(data, error)) {
+        logger::log(browser_NA, "[NA] Touchstone log stopped: " + error);
+        m_checkBoxTouchstoneLog->setChecked(false);
+        return;
+    }
+
+    const QString fileName = QString("%1/%2_%3%4")
+                                 .arg(m_touchstoneLogDir, m_touchstoneLogPrefix)
+                                 .arg(m_touchstoneLogIndex++, 6, 10, QChar('0'))
+                                 .arg(Rfmu2TouchstoneWriter::fileSuffix(data.ports));
+    ++m_exportsInFlight;
+    emit requestTouchstoneExport(fileName, data, false);
+}
+
+void NAWidget::onExportFinished(const QString &path, bool ok, const QString &error)
+{
+    --m_exportsInFlight;
+    if (!ok) {
+        logger::log(browser_NA, QString("[NA] Export to %1 failed: %2").arg(path, error));
+        if (m_checkBoxTouchstoneLog->isChecked() && path.startsWith(m_touchstoneLogDir))
+            m_checkBoxTouchstoneLog->setChecked(false);
+    } else if (!m_checkBoxTouchstoneLog->isChecked() || !path.startsWith(m_touchstoneLogDir)) {
+        logger::log(browser_NA, "[NA] Exported " + path);
+    }
+}
+
 void NAWidget::onTraceUpdateStateChanged(int state)
 {
     traces[currentTraceIndex].updateEnabled = (state == Qt::Checked);
@@ -1649,7 +2008,7 @@ void NAWidget::onTraceHideStateChanged(int state)
         customPlot->graph(currentTraceIndex + MAX_TRACES)->setVisible(!traces[currentTraceIndex].hide);
     }
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void NAWidget::onPlotColorChanged(const QColor &color)
@@ -1658,7 +2017,7 @@ void NAWidget::onPlotColorChanged(const QColor &color)
     customPlot->graph(currentTraceIndex)->setPen(QPen(color));
     QColor minColor = color;
     customPlot->graph(currentTraceIndex + MAX_TRACES)->setPen(QPen(minColor));
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void NAWidget::onCurrentTraceChanged(int index)
@@ -1710,7 +2069,7 @@ void NAWidget::onMarkerPlaceOnChanged(int newTraceIndex)
     }
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::onTraceTypeChanged(int index)
@@ -1750,8 +2109,8 @@ void NAWidget::onTraceClearClicked()
     }
 
     // Update the graph to show no data
-    customPlot->graph(currentTraceIndex)->setData(QVector<double>(), QVector<double>());
-    customPlot->graph(i + MAX_TRACES)->setData(QVector<double>(), QVector<double>());
+    traceDecimator->clearGraphData(customPlot->graph(currentTraceIndex));
+    traceDecimator->clearGraphData(customPlot->graph(i + MAX_TRACES));
 
     // If any markers are on this trace, deactivate them since no data is available
     for (auto &marker : markers) {
@@ -1771,7 +2130,7 @@ void NAWidget::onTraceClearClicked()
         label_CurrAvg->setText("CurrAvg: N/A");
     }
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces | RenderScheduler::Markers);
 }
 
 void NAWidget::onAvgCountChanged(int avgCount)
@@ -1813,11 +2172,11 @@ void NAWidget::onCopyToIndexChanged(int index)
     // Revert combo box to "--"
     revertCopyToComboBox();
 
-    customPlot->graph(destIndex)->setData(traces[destIndex].freqs, traces[destIndex].amps);
+    traceDecimator->setGraphData(customPlot->graph(destIndex), traces[destIndex].freqs, traces[destIndex].amps);
     customPlot->graph(destIndex)->setVisible(!traces[destIndex].hide);
 
     if (traces[destIndex].type == MinMaxHold) {
-        customPlot->graph(destIndex + MAX_TRACES)->setData(traces[destIndex].freqs, traces[destIndex].minAmps);
+        traceDecimator->setGraphData(customPlot->graph(destIndex + MAX_TRACES), traces[destIndex].freqs, traces[destIndex].minAmps);
         customPlot->graph(destIndex + MAX_TRACES)->setVisible(!traces[destIndex].hide);
         QColor fillColor = traces[destIndex].color;
         fillColor.setAlpha(50);
@@ -1847,7 +2206,7 @@ void NAWidget::onCopyToIndexChanged(int index)
 
     updateMarkerLabel();
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void NAWidget::revertCopyToComboBox()
@@ -1906,7 +2265,7 @@ void NAWidget::onMinPeakClicked()
     checkBox_Markers_Active->blockSignals(wasBlocked);
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::computeMeanAndStdev(const QVector<double> &amps, double &mean, double &stdev)
@@ -2093,7 +2452,7 @@ void NAWidget::onPeakLeftClicked()
     // Update marker position
     marker->index = bestIndex;
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::onPeakRightClicked()
@@ -2120,7 +2479,7 @@ void NAWidget::onPeakRightClicked()
         if (p.index > currentIdx) {
             marker->index = p.index;
             updateMarker(marker);
-            customPlot->replot();
+            renderScheduler->markDirty(RenderScheduler::Markers);
             return;
         }
     }
@@ -2183,7 +2542,7 @@ void NAWidget::onNextPeakClicked()
 
     marker->index = allPeaks[nextPos].index;
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void NAWidget::onRefLevelChanged(double newRefLevel) {
@@ -2195,7 +2554,7 @@ void NAWidget::onRefLevelChanged(double newRefLevel) {
     double rangeBottom = rangeTop - 10 * div; // Calculate the bottom of the range (10 divisions below the ref level)
 
     customPlot->yAxis->setRange(rangeBottom, rangeTop); // Set y-axis range
-    customPlot->replot(); // Replot the graph to update the view
+    renderScheduler->markDirty(RenderScheduler::Axes);
 }
 
 void NAWidget::onDivChanged(double newDiv) {
@@ -2210,7 +2569,7 @@ void NAWidget::onDivChanged(double newDiv) {
     double rangeBottom = rangeTop - 10 * newDiv;
 
     customPlot->yAxis->setRange(rangeBottom, rangeTop); // Set the new y-axis range
-    customPlot->replot(); // Replot the graph to update the view
+    renderScheduler->markDirty(RenderScheduler::Axes);
 }
 
 void NAWidget::onMeasTypeChanged()
@@ -2273,48 +2632,14 @@ void NAWidget::parseSinglePortData(Rfmu2NetworkAnalyzer::ResultType type,
     // outS11_ampOrI => the amplitude or I
     // outS11_phaseOrQ => the phase (in rad) or Q
 
-    const int N = dataCount;
-
-    const int expected = (type == Rfmu2NetworkAnalyzer::ResultType::LogAmp   ||
-                          type == Rfmu2NetworkAnalyzer::ResultType::Phase)
-                             ? N        // 1 value per point
-                             : 2 * N;   // amp/phase or I/Q
-
-    if (raw.size() != expected) {
-        qWarning() << Q_FUNC_INFO << "unexpected raw size"
-                   << raw.size() << "expected" << expected;
+    QVector<QVector<double>> a, q;
+    if (!Rfmu2NetworkAnalyzer::splitMeasurement(type, false, raw, dataCount, a, q)) {
+        qWarning() << Q_FUNC_INFO << "unexpected raw size" << raw.size()
+                   << "for" << dataCount << "points";
         return;
     }
-
-    ampOrI.resize(N);
-    phOrQ.resize(N);
-
-    switch (type) {
-    case Rfmu2NetworkAnalyzer::ResultType::Complex:
-        for (int i = 0; i < N; ++i) {
-            ampOrI[i] = raw[2 * i];
-            phOrQ[i]  = raw[2 * i + 1];
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::LogAmp:
-        for (int i = 0; i < N; ++i) {
-            ampOrI[i] = raw[i];
-            phOrQ[i]  = 0.0;
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::Phase:
-        for (int i = 0; i < N; ++i) {
-            ampOrI[i] = 0.0;
-            phOrQ[i]  = raw[i];
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::LogAmpPhase:
-        for (int i = 0; i < N; ++i) {
-            ampOrI[i] = raw[2 * i];
-            phOrQ[i]  = raw[2 * i + 1];
-        }
-        break;
-    }
+    ampOrI = a[0];
+    phOrQ  = q[0];
 }
 
 void NAWidget::parseDualPortData(Rfmu2NetworkAnalyzer::ResultType type,
@@ -2324,60 +2649,15 @@ void NAWidget::parseDualPortData(Rfmu2NetworkAnalyzer::ResultType type,
                                  QVector<double> &s11PQ, QVector<double> &s21PQ,
                                  QVector<double> &s12PQ, QVector<double> &s22PQ)
 {
-    const int N = dataCount;
-
-    const int expected = (type == Rfmu2NetworkAnalyzer::ResultType::LogAmp   ||
-                          type == Rfmu2NetworkAnalyzer::ResultType::Phase)
-                             ? 4 * N    // S11,S21,S12,S22
-                             : 8 * N;   // each of the four ports has amp/phase or I/Q
-
-    if (raw.size() != expected) {
-        qWarning() << Q_FUNC_INFO << "unexpected raw size"
-                   << raw.size() << "expected" << expected;
+    // S11, S21, S12, S22 in that order
+    QVector<QVector<double>> a, q;
+    if (!Rfmu2NetworkAnalyzer::splitMeasurement(type, true, raw, dataCount, a, q)) {
+        qWarning() << Q_FUNC_INFO << "unexpected raw size" << raw.size()
+                   << "for" << dataCount << "points";
         return;
     }
-
-    s11AI.resize(N); s21AI.resize(N); s12AI.resize(N); s22AI.resize(N);
-    s11PQ.resize(N); s21PQ.resize(N); s12PQ.resize(N); s22PQ.resize(N);
-
-    switch (type) {
-    case Rfmu2NetworkAnalyzer::ResultType::Complex:
-        for (int i = 0; i < N; ++i) {
-            const int k = 8 * i;
-            s11AI[i] = raw[k + 0]; s11PQ[i] = raw[k + 1];
-            s21AI[i] = raw[k + 2]; s21PQ[i] = raw[k + 3];
-            s12AI[i] = raw[k + 4]; s12PQ[i] = raw[k + 5];
-            s22AI[i] = raw[k + 6]; s22PQ[i] = raw[k + 7];
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::LogAmp:
-        for (int i = 0; i < N; ++i) {
-            const int k = 4 * i;
-            s11AI[i] = raw[k + 0]; s11PQ[i] = 0.0;
-            s21AI[i] = raw[k + 1]; s21PQ[i] = 0.0;
-            s12AI[i] = raw[k + 2]; s12PQ[i] = 0.0;
-            s22AI[i] = raw[k + 3]; s22PQ[i] = 0.0;
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::Phase:
-        for (int i = 0; i < N; ++i) {
-            const int k = 4 * i;
-            s11AI[i] = 0.0; s11PQ[i] = raw[k + 0];
-            s21AI[i] = 0.0; s21PQ[i] = raw[k + 1];
-            s12AI[i] = 0.0; s12PQ[i] = raw[k + 2];
-            s22AI[i] = 0.0; s22PQ[i] = raw[k + 3];
-        }
-        break;
-    case Rfmu2NetworkAnalyzer::ResultType::LogAmpPhase:
-        for (int i = 0; i < N; ++i) {
-            const int k = 8 * i;
-            s11AI[i] = raw[k + 0]; s11PQ[i] = raw[k + 1];
-            s21AI[i] = raw[k + 2]; s21PQ[i] = raw[k + 3];
-            s12AI[i] = raw[k + 4]; s12PQ[i] = raw[k + 5];
-            s22AI[i] = raw[k + 6]; s22PQ[i] = raw[k + 7];
-        }
-        break;
-    }
+    s11AI = a[0]; s21AI = a[1]; s12AI = a[2]; s22AI = a[3];
+    s11PQ = q[0]; s21PQ = q[1]; s12PQ = q[2]; s22PQ = q[3];
 }
 
 void NAWidget::setTraceTypeForTrace(int targetTraceIndex, TraceType newType)
@@ -2471,28 +2751,7 @@ void NAWidget::allocateBuffers(int N)
     prep(m_s11_phaseQ); prep(m_s21_phaseQ); prep(m_s12_phaseQ); prep(m_s22_phaseQ);
 }
 
-void NAWidget::onSinglePortDataReady(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw)
-{
-    m_pendingType  = type;
-    m_pendingRaw   = raw;
-    m_pendingReady = true; // handled next timer tick
-}
-
-void NAWidget::onDualPortDataReady(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw)
-{
-    m_pendingType  = type;
-    m_pendingRaw   = raw;
-    m_pendingReady = true;
-}
-
 void NAWidget::setTool(Rfmu2Tool *tool)
 {
     hardwareTool = tool;
-
-    // hand the same pointer to the worker (in its own thread):
-    if (m_worker)
-        QMetaObject::invokeMethod(
-            m_worker, "setTool",
-            Qt::QueuedConnection,
-            Q_ARG(Rfmu2Tool*, tool));
 }
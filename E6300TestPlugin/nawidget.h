@@ -17,47 +17,19 @@
 #include <QSplitter>
 #include <QTabWidget>
 #include <QThread>
+#include <QElapsedTimer>
 #include "include/qcustomplot.h"
 #include "include/frequencyspinbox.h"
 #include "marker.h"
+#include "tracedecimator.h"
+#include "renderscheduler.h"
 #include "colorpickerwidget.h"
 #include "collapsiblegroupbox.h"
+#include "sweephistorypanel.h"
+#include "exportworker.h"
+#include "logview.h"
 #include "include/rfmu2/rfmu2tool.h"
 
-// Small worker that runs in its own QThread and performs the
-// blocking network-analyser call so the GUI thread stays responsive.
-class NAWorker : public QObject
-{
-    Q_OBJECT
-public:
-    explicit NAWorker(Rfmu2Tool *tool, QObject *parent = nullptr)
-        : QObject(parent), m_tool(tool) {}
-
-public slots:
-    void setTool(Rfmu2Tool *tool) { m_tool = tool; }
-
-    void measureSinglePortAsync(Rfmu2NetworkAnalyzer::ResultType type)
-    {
-        if (!m_tool || !m_tool->networkAnalyzer()) return;
-        QVector<double> raw = m_tool->networkAnalyzer()->measureSinglePort(type);
-        emit singlePortReady(type, raw);
-    }
-
-    void measureDualPortAsync(Rfmu2NetworkAnalyzer::ResultType type)
-    {
-        if (!m_tool || !m_tool->networkAnalyzer()) return;
-        QVector<double> raw = m_tool->networkAnalyzer()->measureDualPort(type);
-        emit dualPortReady(type, raw); // queued back to GUI thread
-    }
-
-signals:
-    void singlePortReady(Rfmu2NetworkAnalyzer::ResultType, const QVector<double> &);
-    void dualPortReady  (Rfmu2NetworkAnalyzer::ResultType, const QVector<double> &);
-
-private:
-    Rfmu2Tool *m_tool {nullptr};
-};
-
 class NAWidget : public QWidget
 {
     Q_OBJECT
@@ -70,9 +42,16 @@ public:
 
     void setTool(Rfmu2Tool *tool);
 
+    // Replot and sweep-to-screen statistics of the plot
+    const RenderScheduler *renderStats() const noexcept { return renderScheduler; }
+
 public slots:
     void stopAutoSweep() { setMode(SingleMode); }
 
+    // Link lost / back: a running Auto sweep pauses and picks up again
+    void suspendAcquisition();
+    void resumeAcquisition();
+
 private:
     struct TraceData {
         QVector<double> freqs;       // Current frequencies for this trace
@@ -137,6 +116,9 @@ private slots:
     void onValueOfSetFreqChanged(double frequency);
     void onPkTrackingStateChanged(int state);
     void onExportTraceData();
+    void onExportSParametersClicked();
+    void onTouchstoneLogToggled(bool checked);
+    void onExportFinished(const QString &path, bool ok, const QString &error);
     void onTraceUpdateStateChanged(int state);
     void onTraceHideStateChanged(int state);
     void onPlotColorChanged(const QColor &color);
@@ -182,12 +164,18 @@ private slots:
     void onDualCaliLoadFileClicked();
 
     void onMeasTypeChanged();
+    void onHistorySweepSelected(const Rfmu2SweepHistory::Sweep &sweep);
 
 private:
     void updateMarker(Marker *marker);
     void updateMarkerLabel();
 
-    void acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &rawData);
+    bool acquireSweepData(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &rawData);
+    // Feed the current m_freqs / S-parameter arrays through the trace types and markers
+    void refreshTraces();
+    // Snapshot of the last sweep as S-parameters, false (with reason) if it cannot be expressed
+    bool currentSParameters(Rfmu2SParameters &out, QString &error);
+    void logTouchstoneSweep();
 
     // Helper functions for each type
     void applyClearWrite(int traceIndex, const QVector<double> &newFreqs, const QVector<double> &newAmps);
@@ -204,6 +192,8 @@ private:
     bool checkExcursion(const QVector<double> &amps, int peakIndex, double pkExcurs);
 
     QCustomPlot *customPlot;
+    TraceDecimator *traceDecimator; // Full-resolution trace data -> per-pixel min/max for drawing
+    RenderScheduler *renderScheduler; // Coalesces replot requests into at most one per frame
     QTimer *dataTimer;
 
     double pkThreshold; // For user-defined min amplitude
@@ -256,12 +246,15 @@ private:
     QTabWidget *tabWidget;
     QWidget *tab_logArea;
 
-    QTextBrowser *browser_NA;
+    LogView *browser_NA;
 
     int dataCount;
 
+    SweepHistoryPanel *historyPanel;
+
     bool isFreqSweep(double epsilon);
     void AdjustSweepRange();
+    bool applySweepSettings();      // frequency, level and points/ports in one exchange
 
     QSpinBox *mPointsEdit;
     QComboBox *mPort1Edit;
@@ -295,19 +288,35 @@ private:
     QString yAxisUnitForTrace(int traceIndex) const;
 
 private:
-    QThread *m_workerThread {nullptr};
-    NAWorker *m_worker {nullptr};
-    QVector<double> m_pendingRaw; // data handed over from worker
-    Rfmu2NetworkAnalyzer::ResultType m_pendingType {};
-    bool m_pendingReady {false};
+    int m_sweepsInFlight {0};         // sweeps queued or running on the I/O thread
+    quint32 m_sweepGeneration {0};    // bumped to discard sweeps still in flight
+    bool m_resumeOnLink {false};      // Auto mode was interrupted by a link loss
+    QElapsedTimer m_sweepClock;       // since the last sweep was issued (rate cap)
+    static constexpr int kMaxSweepsInFlight = 2; // free run: one running, one queued
+    static constexpr int kIdlePollMs = 200;      // Auto mode with no trace to update
+    int m_sweepFailures {0};          // consecutive sweeps that came back unusable
+    static constexpr int kMaxSweepFailures = 5;      // then Auto mode gives up
+    static constexpr int kFailureBackoffMaxMs = 5000;
+
+    // --- Touchstone export / continuous sweep logging ---
+    QThread *m_exportThread {nullptr};
+    ExportWorker *m_exportWorker {nullptr};
+    QCheckBox *m_checkBoxTouchstoneLog {nullptr};
+    QString m_touchstoneLogDir;
+    QString m_touchstoneLogPrefix;
+    int m_touchstoneLogIndex {0};
+    int m_exportsInFlight {0};
+    int m_exportsDropped {0};
+    static constexpr int kMaxExportsInFlight = 8; // beyond this, logged sweeps are dropped
 
 signals:
-    void requestSinglePort(Rfmu2NetworkAnalyzer::ResultType type);
-    void requestDualPort(Rfmu2NetworkAnalyzer::ResultType type);
+    void requestTouchstoneExport(const QString &path, const Rfmu2SParameters &data, bool version2);
 
-private slots:
-    void onSinglePortDataReady(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw);
-    void onDualPortDataReady(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw);
+private:
+    void requestSweeps();
+    // `failed`: the sweep that just landed was unusable (backs off, gives up after a few)
+    void scheduleNextSweep(bool failed = false);
+    void onSweepCompleted(Rfmu2NetworkAnalyzer::ResultType type, const QVector<double> &raw);
 };
 
 #endif // NAWIDGET_H
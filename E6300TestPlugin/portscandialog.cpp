@@ -0,0 +1,367 @@
+#include "portscandialog.h"
+#include "include/rfmu2/rfmu2tool.h"
+#include "include/qcustomplot.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QFile>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTextStream>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <numeric>
+
+static constexpr double kSaSpanHz = 1e6;    // the SA's fixed span around its center
+
+static const QStringList kRfPorts = {
+    "01A","01B","01C","01D",
+    "02A","02B","02C","02D",
+    "03A","03B","03C","03D",
+    "04A","04B","04C","04D"
+};
+
+PortScanDialog::PortScanDialog(Rfmu2Tool *tool, QWidget *parent)
+    : QDialog(parent), m_tool(tool)
+{
+    setWindowTitle(tr("Port Scan"));
+    resize(900, 700);
+
+    // --- what to measure ---
+    m_instrument = new QComboBox(this);
+    m_instrument->addItem(tr("Spectrum Analyzer (raw)"));
+    m_instrument->addItem(tr("Network Analyzer"));
+
+    auto *portsGroup = new QGroupBox(tr("Ports"), this);
+    auto *portsGrid  = new QGridLayout(portsGroup);
+    for (int i = 0; i < kRfPorts.size(); ++i) {
+        auto *cb = new QCheckBox(kRfPorts[i], portsGroup);
+        cb->setChecked(true);
+        m_portBoxes.append(cb);
+        portsGrid->addWidget(cb, i / 4, i % 4);
+    }
+    auto *allButton  = new QPushButton(tr("All"), portsGroup);
+    auto *noneButton = new QPushButton(tr("None"), portsGroup);
+    portsGrid->addWidget(allButton, 0, 4);
+    portsGrid->addWidget(noneButton, 1, 4);
+    connect(allButton, &QPushButton::clicked, this, [this]() {
+        for (QCheckBox *cb : m_portBoxes) cb->setChecked(true);
+    });
+    connect(noneButton, &QPushButton::clicked, this, [this]() {
+        for (QCheckBox *cb : m_portBoxes) cb->setChecked(false);
+    });
+
+    m_saGroup = new QGroupBox(tr("Spectrum Analyzer"), this);
+    m_saFreq = new QDoubleSpinBox(m_saGroup);
+    m_saFreq->setRange(0.1, 6.0);      // GHz
+    m_saFreq->setDecimals(6);          // 1 kHz resolution
+    m_saFreq->setValue(1.0);
+    m_saLevel = new QDoubleSpinBox(m_saGroup);
+    m_saLevel->setRange(-100.0, 30.0);
+    m_saLevel->setDecimals(1);
+    m_saLevel->setSuffix(" dBm");
+    m_saReceive = new QSpinBox(m_saGroup);
+    m_saReceive->setRange(1, 4);
+    auto *saForm = new QFormLayout(m_saGroup);
+    saForm->addRow(tr("Center Freq [GHz]:"), m_saFreq);
+    saForm->addRow(tr("Level:"),             m_saLevel);
+    saForm->addRow(tr("Receive:"),           m_saReceive);
+
+    m_naGroup = new QGroupBox(tr("Network Analyzer"), this);
+    m_naMeasType = new QComboBox(m_naGroup);
+    using RT = Rfmu2NetworkAnalyzer::ResultType;
+    for (bool dual : {false, true}) {
+        const QString prefix = dual ? QStringLiteral("Dual-Port ") : QStringLiteral("Single-Port ");
+        m_naMeasType->addItem(prefix + "Complex",     QVariantList{dual, int(RT::Complex)});
+        m_naMeasType->addItem(prefix + "LogAmp",      QVariantList{dual, int(RT::LogAmp)});
+        m_naMeasType->addItem(prefix + "Phase",       QVariantList{dual, int(RT::Phase)});
+        m_naMeasType->addItem(prefix + "LogAmpPhase", QVariantList{dual, int(RT::LogAmpPhase)});
+    }
+    m_naMeasType->setCurrentIndex(1);
+    auto makeFreqBox = [this](double ghz) {
+        auto *sb = new QDoubleSpinBox(m_naGroup);
+        sb->setRange(0.1, 6.0);        // GHz
+        sb->setDecimals(6);            // 1 kHz resolution
+        sb->setValue(ghz);
+        return sb;
+    };
+    m_naStart = makeFreqBox(1.0);
+    m_naStop  = makeFreqBox(3.0);
+    m_naPoints = new QSpinBox(m_naGroup);
+    m_naPoints->setRange(1, 401);
+    m_naPoints->setValue(201);
+    m_naPort2 = new QComboBox(m_naGroup);
+    m_naPort2->addItems(kRfPorts);
+    auto *naForm = new QFormLayout(m_naGroup);
+    naForm->addRow(tr("Measurement:"),      m_naMeasType);
+    naForm->addRow(tr("Start Freq [GHz]:"), m_naStart);
+    naForm->addRow(tr("Stop Freq [GHz]:"),  m_naStop);
+    naForm->addRow(tr("Points:"),           m_naPoints);
+    naForm->addRow(tr("Port 2:"),      m_naPort2);
+
+    m_pipelined = new QCheckBox(tr("Send the next port's request while the current one runs"), this);
+    m_pipelined->setChecked(true);
+
+    auto *settingsRow = new QHBoxLayout;
+    settingsRow->addWidget(portsGroup);
+    settingsRow->addWidget(m_saGroup);
+    settingsRow->addWidget(m_naGroup);
+
+    // --- run / results ---
+    m_runButton    = new QPushButton(tr("Run Scan"), this);
+    m_exportButton = new QPushButton(tr("Export CSV..."), this);
+    m_exportButton->setEnabled(false);
+    m_status = new QLabel(this);
+    m_series = new QComboBox(this);
+    m_series->setEnabled(false);
+
+    auto *runRow = new QHBoxLayout;
+    runRow->addWidget(new QLabel(tr("Instrument:"), this));
+    runRow->addWidget(m_instrument);
+    runRow->addWidget(m_pipelined);
+    runRow->addStretch();
+    runRow->addWidget(m_status);
+    runRow->addWidget(new QLabel(tr("Show:"), this));
+    runRow->addWidget(m_series);
+    runRow->addWidget(m_runButton);
+    runRow->addWidget(m_exportButton);
+
+    m_table = new QTableWidget(0, 5, this);
+    m_table->setHorizontalHeaderLabels({tr("Port"), tr("Points"), tr("Max"), tr("Min"), tr("Mean")});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    m_plot = new QCustomPlot(this);
+    m_plot->xAxis->setLabel(tr("Frequency (Hz)"));
+    m_plot->legend->setVisible(true);
+    m_plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    m_plot->setMinimumHeight(300);
+
+    auto *lay = new QVBoxLayout(this);
+    lay->addLayout(settingsRow);
+    lay->addLayout(runRow);
+    lay->addWidget(m_plot, 3);
+    lay->addWidget(m_table, 2);
+
+    connect(m_instrument, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &PortScanDialog::onInstrumentChanged);
+    connect(m_runButton,    &QPushButton::clicked, this, &PortScanDialog::onRunClicked);
+    connect(m_exportButton, &QPushButton::clicked, this, &PortScanDialog::onExportClicked);
+    connect(m_series, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &PortScanDialog::plotSeries);
+    onInstrumentChanged(m_instrument->currentIndex());
+}
+
+QStringList PortScanDialog::selectedPorts() const
+{
+    QStringList ports;
+    for (QCheckBox *cb : m_portBoxes)
+        if (cb->isChecked())
+            ports.append(cb->text());
+    return ports;
+}
+
+void PortScanDialog::onInstrumentChanged(int index)
+{
+    m_saGroup->setVisible(index == 0);
+    m_naGroup->setVisible(index == 1);
+}
+
+void PortScanDialog::onRunClicked()
+{
+    if (!m_tool || !m_tool->isConnected()) {
+        QMessageBox::warning(this, tr("Port Scan"), tr("Not connected."));
+        return;
+    }
+    const QStringList ports = selectedPorts();
+    if (ports.isEmpty()) {
+        QMessageBox::warning(this, tr("Port Scan"), tr("Select at least one port."));
+        return;
+    }
+
+    const bool na = m_instrument->currentIndex() == 1;
+    if (na && m_naStop->value() <= m_naStart->value()) {
+        QMessageBox::warning(this, tr("Port Scan"), tr("Stop frequency must be above the start frequency."));
+        return;
+    }
+
+    const int window = m_pipelined->isChecked() ? 2 : 1;
+    m_scanPorts = ports;
+    m_scanNa = na;
+    m_runButton->setEnabled(false);
+    m_status->setText(tr("Scanning %1 ports...").arg(ports.size()));
+    m_clock.start();
+
+    auto done = [this](const QVector<QVector<double>> &traces) { showResults(traces); };
+
+    // The whole scan is one job: nothing else reaches the instrument
+    // between the ports, so every trace sees the same settings.
+    if (!na) {
+        const int freqKHz  = static_cast<int>(qRound64(m_saFreq->value() * 1e6));
+        const double level = m_saLevel->value();
+        const int receive  = m_saReceive->value();
+        auto sa = m_tool->spectrumAnalyzer();
+        m_tool->submit(Rfmu2Priority::Interactive,
+                       [sa, freqKHz, level, receive, ports, window]() {
+                           return sa->scanPorts(freqKHz, level, receive, ports, window);
+                       }, this, done);
+    } else {
+        const QVariantList meas = m_naMeasType->currentData().toList();
+        Rfmu2NetworkAnalyzer::PortScan scan;
+        scan.ports    = ports;
+        scan.port2    = m_naPort2->currentText();
+        scan.startKHz = static_cast<int>(qRound64(m_naStart->value() * 1e6));
+        scan.stopKHz  = static_cast<int>(qRound64(m_naStop->value() * 1e6));
+        scan.points   = m_naPoints->value();
+        scan.dualPort = meas.value(0).toBool();
+        scan.type     = static_cast<Rfmu2NetworkAnalyzer::ResultType>(meas.value(1).toInt());
+        scan.window   = window;
+        m_scanDual = scan.dualPort;
+        m_scanType = scan.type;
+
+        // Same spacing as the NA's own sweep
+        m_keys.resize(scan.points);
+        const double step = scan.points > 1 ? (scan.stopKHz - scan.startKHz) * 1e3 / (scan.points - 1) : 0.0;
+        for (int i = 0; i < scan.points; ++i)
+            m_keys[i] = scan.startKHz * 1e3 + i * step;
+
+        auto analyzer = m_tool->networkAnalyzer();
+        m_tool->submit(Rfmu2Priority::Interactive,
+                       [analyzer, scan]() { return analyzer->scanPorts(scan); }, this, done);
+    }
+}
+
+void PortScanDialog::showResults(const QVector<QVector<double>> &traces)
+{
+    m_runButton->setEnabled(true);
+    m_traces = traces;
+    m_exportButton->setEnabled(!m_traces.isEmpty());
+
+    const qint64 ms = m_clock.elapsed();
+    m_status->setText(tr("%1 of %2 ports in %3 ms (%4 ms/port)")
+                          .arg(traces.size()).arg(m_scanPorts.size()).arg(ms)
+                          .arg(traces.isEmpty() ? 0 : ms / traces.size()));
+
+    // Raw bins span the SA's fixed window around the center it was tuned to
+    if (!m_scanNa) {
+        const int n = traces.isEmpty() ? 0 : int(traces.first().size());
+        const double startHz = m_saFreq->value() * 1e9 - kSaSpanHz / 2;
+        m_keys.resize(n);
+        for (int i = 0; i < n; ++i)
+            m_keys[i] = n > 1 ? startHz + i * kSaSpanHz / (n - 1) : startHz + kSaSpanHz / 2;
+    }
+
+    // One entry per S-parameter and part the result carries
+    using RT = Rfmu2NetworkAnalyzer::ResultType;
+    const QSignalBlocker block(m_series);
+    m_series->clear();
+    if (!m_scanNa) {
+        m_series->addItem(tr("Level (dBm)"), QVariantList{0, 0});
+    } else {
+        const QStringList params = m_scanDual ? QStringList{"S11", "S21", "S12", "S22"}
+                                              : QStringList{"S11"};
+        QVector<QPair<QString, int>> parts;     // name, 0 = amplitude or I, 1 = phase or Q
+        switch (m_scanType) {
+        case RT::Complex:     parts = { {tr("I"), 0}, {tr("Q"), 1} };             break;
+        case RT::LogAmp:      parts = { {tr("LogAmp"), 0} };                       break;
+        case RT::Phase:       parts = { {tr("Phase"), 1} };                        break;
+        case RT::LogAmpPhase: parts = { {tr("LogAmp"), 0}, {tr("Phase"), 1} };     break;
+        }
+        for (int p = 0; p < params.size(); ++p)
+            for (const auto &part : parts)
+                m_series->addItem(params[p] + QLatin1Char(' ') + part.first, QVariantList{p, part.second});
+    }
+    m_series->setEnabled(m_series->count() > 1);
+    plotSeries();
+}
+
+QVector<double> PortScanDialog::seriesFor(const QVector<double> &raw) const
+{
+    if (!m_scanNa)
+        return raw;
+
+    const QVariantList sel = m_series->currentData().toList();
+    const int param = sel.value(0).toInt();
+    const int part  = sel.value(1).toInt();
+    QVector<QVector<double>> ampOrI, phaseOrQ;
+    if (!Rfmu2NetworkAnalyzer::splitMeasurement(m_scanType, m_scanDual, raw, int(m_keys.size()),
+                                                ampOrI, phaseOrQ))
+        return {};      // not the shape the scan asked for
+    return part == 0 ? ampOrI.value(param) : phaseOrQ.value(param);
+}
+
+void PortScanDialog::plotSeries()
+{
+    m_plot->clearGraphs();
+    m_table->setRowCount(m_traces.size());
+    for (int i = 0; i < m_traces.size(); ++i) {
+        QVector<double> y = seriesFor(m_traces[i]);
+        if (y.size() != m_keys.size())
+            y.clear();      // unexpected length: listed, but not plotted
+
+        QCPGraph *g = m_plot->addGraph();
+        g->setName(m_scanPorts[i]);
+        g->setPen(QPen(QColor::fromHsv(i * 360 / qMax(1, int(m_traces.size())), 200, 220)));
+        if (!y.isEmpty())
+            g->setData(m_keys, y, true);
+
+        const bool empty = y.isEmpty();
+        const double maxV = empty ? 0.0 : *std::max_element(y.cbegin(), y.cend());
+        const double minV = empty ? 0.0 : *std::min_element(y.cbegin(), y.cend());
+        const double mean = empty ? 0.0 : std::accumulate(y.cbegin(), y.cend(), 0.0) / y.size();
+
+        m_table->setItem(i, 0, new QTableWidgetItem(m_scanPorts[i]));
+        m_table->setItem(i, 1, new QTableWidgetItem(QString::number(y.size())));
+        m_table->setItem(i, 2, new QTableWidgetItem(QString::number(maxV, 'f', 2)));
+        m_table->setItem(i, 3, new QTableWidgetItem(QString::number(minV, 'f', 2)));
+        m_table->setItem(i, 4, new QTableWidgetItem(QString::number(mean, 'f', 2)));
+    }
+    m_plot->rescaleAxes();
+    m_plot->replot();
+}
+
+void PortScanDialog::onExportClicked()
+{
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export Port Scan"),
+                                                      QString(), tr("CSV files (*.csv)"));
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Port Scan"), tr("Cannot write %1").arg(path));
+        return;
+    }
+
+    // The series on show: one column per port, one row per frequency
+    QVector<QVector<double>> series;
+    for (const QVector<double> &raw : m_traces)
+        series.append(seriesFor(raw));
+
+    QTextStream out(&file);
+    out << "freqHz";
+    for (int i = 0; i < series.size(); ++i)
+        out << ',' << m_scanPorts[i] << ' ' << m_series->currentText();
+    out << '\n';
+    for (int r = 0; r < m_keys.size(); ++r) {
+        out << QString::number(m_keys[r], 'f', 0);
+        for (const QVector<double> &t : series) {
+            out << ',';
+            if (t.size() == m_keys.size())
+                out << QString::number(t[r], 'g', 10);
+        }
+        out << '\n';
+    }
+}
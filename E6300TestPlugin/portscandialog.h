@@ -0,0 +1,73 @@
+#pragma once
+#include "include/rfmu2/rfmu2networkanalyzer.h"
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QGroupBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+class QTableWidget;
+class QCustomPlot;
+class Rfmu2Tool;
+
+/*! Runs one SA or NA measurement on a list of RF ports in a single
+ *  pipelined exchange and shows one trace per port against frequency,
+ *  overlaid and as a summary table, for port-to-port comparison. NA
+ *  results are split per S-parameter and part; one is shown at a time. */
+class PortScanDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit PortScanDialog(Rfmu2Tool *tool, QWidget *parent = nullptr);
+
+private slots:
+    void onInstrumentChanged(int index);
+    void onRunClicked();
+    void onExportClicked();
+    void plotSeries();
+
+private:
+    QStringList selectedPorts() const;
+    void showResults(const QVector<QVector<double>> &traces);
+    QVector<double> seriesFor(const QVector<double> &raw) const;   // selected part of one result
+
+    Rfmu2Tool      *m_tool {};               // not owned
+
+    QComboBox      *m_instrument {};
+    QVector<QCheckBox*> m_portBoxes;
+
+    QGroupBox      *m_saGroup {};
+    QDoubleSpinBox *m_saFreq {};
+    QDoubleSpinBox *m_saLevel {};
+    QSpinBox       *m_saReceive {};
+
+    QGroupBox      *m_naGroup {};
+    QComboBox      *m_naMeasType {};
+    QDoubleSpinBox *m_naStart {};
+    QDoubleSpinBox *m_naStop {};
+    QSpinBox       *m_naPoints {};
+    QComboBox      *m_naPort2 {};
+
+    QCheckBox      *m_pipelined {};
+    QPushButton    *m_runButton {};
+    QPushButton    *m_exportButton {};
+    QLabel         *m_status {};
+    QComboBox      *m_series {};
+    QTableWidget   *m_table {};
+    QCustomPlot    *m_plot {};
+
+    // the last scan
+    QStringList     m_scanPorts;             // in order
+    QVector<QVector<double>> m_traces;       // raw result, one per entry of m_scanPorts
+    QVector<double> m_keys;                  // frequency of each point, Hz
+    bool            m_scanNa = false;
+    bool            m_scanDual = false;
+    Rfmu2NetworkAnalyzer::ResultType m_scanType = Rfmu2NetworkAnalyzer::ResultType::LogAmp;
+    QElapsedTimer   m_clock;
+};
@@ -0,0 +1,138 @@
+#include "renderscheduler.h"
+
+RenderScheduler::RenderScheduler(QCustomPlot *plot, QObject *parent)
+    : QObject(parent),
+    m_plot(plot)
+{
+    m_plot->addLayer("traces", m_plot->layer("main"), QCustomPlot::limAbove);
+    m_plot->addLayer("markers", m_plot->layer("traces"), QCustomPlot::limAbove);
+    m_tracesLayer = m_plot->layer("traces");
+    m_markersLayer = m_plot->layer("markers");
+    m_tracesLayer->setMode(QCPLayer::lmBuffered);
+    m_markersLayer->setMode(QCPLayer::lmBuffered);
+
+    // Any range change moves the grid and tick labels, which only a full
+    // replot redraws; catch the ones nobody marked explicitly (zoom, drag).
+    const auto axes = m_plot->axisRect()->axes();
+    for (QCPAxis *axis : axes) {
+        connect(axis, qOverload<const QCPRange &>(&QCPAxis::rangeChanged), this, [this]() {
+            markDirty(Axes);
+        });
+    }
+
+    m_clock.start();
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &RenderScheduler::render);
+}
+
+void RenderScheduler::setMaxFrameRate(int fps)
+{
+    m_frameIntervalMs = qMax(1, 1000 / qBound(1, fps, 1000));
+}
+
+void RenderScheduler::markDirty(DirtyFlags what)
+{
+    m_dirty |= what;
+    if (m_frameTimer.isActive())
+        return; // already coalescing into the pending frame
+
+    // Render as soon as the previous frame is one interval old; an idle plot
+    // therefore still reacts on the next event loop pass.
+    int delay = 0;
+    if (m_sinceLastFrame.isValid())
+        delay = qMax<qint64>(0, m_frameIntervalMs - m_sinceLastFrame.elapsed());
+    m_frameTimer.start(delay);
+}
+
+void RenderScheduler::flush()
+{
+    if (!m_dirty)
+        return;
+    m_frameTimer.stop();
+    render();
+}
+
+void RenderScheduler::noteSweepArrived()
+{
+    m_sweeps.fetch_add(1, std::memory_order_relaxed);
+    if (m_sweepArrivedNs >= 0) {
+        m_superseded.fetch_add(1, std::memory_order_relaxed);
+        Rfmu2Trace::asyncEnd("sweep", m_sweepTraceId);
+    }
+    m_sweepArrivedNs = m_clock.nsecsElapsed();
+    m_sweepTraceId = Rfmu2Trace::currentId();
+}
+
+void RenderScheduler::noteSweepDropped()
+{
+    m_discarded.fetch_add(1, std::memory_order_relaxed);
+    Rfmu2Trace::asyncEnd("sweep", Rfmu2Trace::currentId());
+}
+
+void RenderScheduler::render()
+{
+    if (!m_dirty)
+        return;
+    if (m_hold && m_hold()) {
+        m_frameTimer.start(m_frameIntervalMs);
+        return;
+    }
+
+    const DirtyFlags dirty = m_dirty;
+    m_dirty = {};
+    const bool firstFrame = !m_sinceLastFrame.isValid();
+    m_sinceLastFrame.start();
+    const bool drawsSweep = m_sweepArrivedNs >= 0 && (dirty & Traces);
+    const qint64 startNs = m_clock.nsecsElapsed();
+
+    {
+        Rfmu2TraceScope trace(drawsSweep ? m_sweepTraceId : 0);
+        Rfmu2TraceSpan span("replot");
+
+        // Layer buffers only exist after a first full replot. After a resize,
+        // QCPLayer::replot itself falls back to a full replot.
+        if (firstFrame || (dirty & Axes)) {
+            m_plot->replot();
+        } else {
+            // Tracers sit on graph data, so new trace data moves the markers too.
+            if (dirty & Traces)
+                m_tracesLayer->replot();
+            m_markersLayer->replot();
+        }
+    }
+
+    const qint64 doneNs = m_clock.nsecsElapsed();
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    m_replotUs.record((doneNs - startNs) / 1000);
+    if (drawsSweep) {
+        m_sweepToScreenUs.record((doneNs - m_sweepArrivedNs) / 1000);
+        m_sweepArrivedNs = -1;
+        Rfmu2Trace::asyncEnd("sweep", m_sweepTraceId);
+    }
+}
+
+RenderScheduler::Stats RenderScheduler::stats() const
+{
+    Stats s;
+    s.frames        = m_frames.load(std::memory_order_relaxed);
+    s.sweeps        = m_sweeps.load(std::memory_order_relaxed);
+    s.superseded    = m_superseded.load(std::memory_order_relaxed);
+    s.discarded     = m_discarded.load(std::memory_order_relaxed);
+    s.replot        = m_replotUs.summary();
+    s.sweepToScreen = m_sweepToScreenUs.summary();
+    return s;
+}
+
+QJsonObject RenderScheduler::statsJson() const
+{
+    const Stats s = stats();
+    return QJsonObject {
+        { "frames",        double(s.frames) },
+        { "sweeps",        double(s.sweeps) },
+        { "superseded",    double(s.superseded) },
+        { "discarded",     double(s.discarded) },
+        { "replot",        s.replot.toJson() },
+        { "sweepToScreen", s.sweepToScreen.toJson() },
+    };
+}
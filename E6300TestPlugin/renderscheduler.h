@@ -0,0 +1,104 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <atomic>
+#include <functional>
+#include "include/qcustomplot.h"
+#include "include/rfmu2/rfmu2metrics.h"
+#include "include/rfmu2/rfmu2trace.h"
+
+// Collects "something on the plot changed" notifications and turns them into
+// at most one replot per frame. Slots that used to call replot() directly
+// (marker moves, key repeats, peak search, new sweeps) now only mark what
+// changed; a burst of them inside one frame interval costs a single repaint.
+//
+// Graphs and markers live on their own buffered layers ("traces" above the
+// grid, "markers" above the traces), so a frame only redraws what is dirty:
+// marker-only changes repaint the marker layer, new sweep data repaints the
+// trace and marker layers, and the grid/axes buffers are reused until a range
+// or the plot geometry changes.
+//
+// It also keeps the pipeline statistics of the plot: how long a replot takes,
+// how long a sweep waits between arriving and being on screen, and how many
+// sweeps never made it there. Those are atomics, so the stats panel and the
+// plugin host may read them from any thread.
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum DirtyFlag {
+        Traces  = 0x1,   // graph data, visibility, pens/brushes
+        Markers = 0x2,   // tracers, annotations, delta tracers
+        Axes    = 0x4,   // ranges, ticks, grid
+        All     = Traces | Markers | Axes
+    };
+    Q_DECLARE_FLAGS(DirtyFlags, DirtyFlag)
+
+    explicit RenderScheduler(QCustomPlot *plot, QObject *parent = nullptr);
+
+    // Make these the current layer before adding graphs / marker items.
+    QCPLayer *tracesLayer() const noexcept { return m_tracesLayer; }
+    QCPLayer *markersLayer() const noexcept { return m_markersLayer; }
+
+    void setMaxFrameRate(int fps);
+
+    // While hold() is true frames are put off, one interval at a time
+    // (e.g. while the owner waits in a blocking instrument call).
+    void setHold(std::function<bool()> hold) { m_hold = std::move(hold); }
+    int maxFrameRate() const noexcept { return 1000 / m_frameIntervalMs; }
+
+    // Record what changed and make sure a frame is on its way.
+    void markDirty(DirtyFlags what);
+
+    // Render now if anything is pending (e.g. right before grabbing the plot).
+    void flush();
+
+    // A sweep was accepted for display; the frame that draws it closes its
+    // acquisition-to-render time. A sweep replaced before that frame counts
+    // as superseded. Both also end the sweep's trace (Rfmu2Trace::currentId()).
+    void noteSweepArrived();
+    // A sweep came back but was thrown away (stale span, wrong size, ...).
+    void noteSweepDropped();
+
+    struct Stats {
+        quint64 frames     = 0;
+        quint64 sweeps     = 0;   // accepted for display
+        quint64 superseded = 0;   // accepted, but replaced before a frame drew them
+        quint64 discarded  = 0;
+        Rfmu2Histogram::Summary replot;
+        Rfmu2Histogram::Summary sweepToScreen;
+    };
+    Stats stats() const;
+    QJsonObject statsJson() const;
+
+private slots:
+    void render();
+
+private:
+    QCustomPlot *m_plot;
+    QCPLayer *m_tracesLayer;
+    QCPLayer *m_markersLayer;
+    QTimer m_frameTimer;
+    QElapsedTimer m_sinceLastFrame;
+    DirtyFlags m_dirty;
+    int m_frameIntervalMs = 16;
+    std::function<bool()> m_hold;
+
+    QElapsedTimer m_clock;             // time base of the sweep stamps
+    qint64 m_sweepArrivedNs = -1;      // newest sweep not drawn yet, -1 if none
+    quint64 m_sweepTraceId = 0;        // its trace id
+    std::atomic<quint64> m_frames {0};
+    std::atomic<quint64> m_sweeps {0};
+    std::atomic<quint64> m_superseded {0};
+    std::atomic<quint64> m_discarded {0};
+    Rfmu2Histogram m_replotUs;
+    Rfmu2Histogram m_sweepToScreenUs;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(RenderScheduler::DirtyFlags)
+
+#endif // RENDERSCHEDULER_H
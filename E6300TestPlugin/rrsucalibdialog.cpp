@@ -2,72 +2,52 @@
 #include "include/rfmu2/rfmu2tool.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QCheckBox>
 #include <QComboBox>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QDialogButtonBox>
+#include <QFile>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include <QLabel>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
 
-bool RRSUCalibDialog::readFile(const QString &path, QByteArray &outData)
+// Runs on the parse thread. The file is mapped rather than read when the
+// platform allows it; parsing works on the raw bytes either way.
+bool RRSUCalibDialog::readFile(const QString &path, QByteArray &outData, QString *error)
 {
     QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // Could show a message box or log an error if you like
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
         return false;
     }
 
-    outData.clear();  // Make sure we're starting fresh
-
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.isEmpty())
-            continue;  // Skip empty lines
-
-        // Split by comma. We expect exactly 2 columns: freq, attenuation
-        QStringList parts = line.split(',');
-        if (parts.size() < 2) {
-            // If there's a header or mismatch, decide how strict you want to be
-            // Here we return false immediately:
-            file.close();
-            return false;
-        }
-
-        // Parse the frequency (unused, but we verify we can parse it)
-        bool freqOk = false;
-        double freq = parts.at(0).toDouble(&freqOk);
-
-        // Parse the attenuation
-        bool attOk = false;
-        double attenuation = parts.at(1).toDouble(&attOk);
-
-        // If any parse failed, return false (or handle differently)
-        if (!freqOk || !attOk) {
-            file.close();
-            return false;
-        }
-
-        // Use your helper to split the attenuation into two qint8 values
-        QPair<qint8, qint8> splitted = Rfmu2Base::splitDoubleAtDecimal(attenuation);
-
-        // Convert qint8 -> char and append to the output buffer
-        outData.append(static_cast<char>(splitted.first));
-        outData.append(static_cast<char>(splitted.second));
+    const qint64 size = file.size();
+    if (size > 16 * 1024 * 1024) {              // far beyond what one upload can hold
+        *error = QObject::tr("file is too large");
+        return false;
     }
 
-    file.close();
-    return true;
+    if (uchar *mapped = size > 0 ? file.map(0, size) : nullptr) {
+        const QByteArray csv = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), int(size));
+        const bool ok = Rfmu2SystemControl::parseRRSUCalibrationCsv(csv, outData, error);
+        file.unmap(mapped);
+        return ok;
+    }
+    return Rfmu2SystemControl::parseRRSUCalibrationCsv(file.readAll(), outData, error);
 }
 /*-------------------------------------------------------*/
 
-RRSUCalibDialog::RRSUCalibDialog(Rfmu2SystemControl *sys, QWidget *parent)
-    : QDialog(parent), m_sys(sys)
+RRSUCalibDialog::RRSUCalibDialog(Rfmu2Tool *tool, QWidget *parent)
+    : QDialog(parent), m_tool(tool)
 {
     setWindowTitle(tr("RRSU TX Calibration Upload"));
     setModal(true);
-    resize(500, 160);
+    resize(500, 200);
 
     /* --- channel selector --- */
     m_chanBox = new QComboBox(this);
@@ -79,27 +59,48 @@ RRSUCalibDialog::RRSUCalibDialog(Rfmu2SystemControl *sys, QWidget *parent)
     m_chanBox->addItems(chans);
 
     /* --- file picker --- */
-    QPushButton *fileBtn = new QPushButton(tr("Select"), this);
+    m_fileBtn = new QPushButton(tr("Select"), this);
     m_fileEdit = new QLineEdit(this);
     m_fileEdit->setReadOnly(true);
 
-    connect(fileBtn, &QPushButton::clicked, this, &RRSUCalibDialog::selectFile);
+    connect(m_fileBtn, &QPushButton::clicked, this, &RRSUCalibDialog::selectFile);
+
+    m_forceBox = new QCheckBox(tr("Upload even if the channel already has this table"), this);
+    m_trustBox = new QCheckBox(tr("Trust tables uploaded to this address in earlier sessions"), this);
+    m_trustBox->setToolTip(tr("Only if the same unit is still behind this address and has not "
+                              "lost its tables since."));
+    connect(m_forceBox, &QCheckBox::toggled, m_trustBox, &QCheckBox::setDisabled);
+
+    /* --- progress --- */
+    m_progress = new QProgressBar(this);
+    m_progress->setRange(0, 1000);
+    m_progress->setValue(0);
+    m_progress->setVisible(false);
+    m_status = new QLabel(this);
+
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(50);
+    connect(m_progressTimer, &QTimer::timeout, this, &RRSUCalibDialog::updateProgress);
 
     /* --- layout --- */
     QGridLayout *grid = new QGridLayout;
     grid->addWidget(new QLabel(tr("Channel:"), this), 0, 0);
     grid->addWidget(m_chanBox, 0, 1, 1, 2);
-    grid->addWidget(fileBtn, 1, 0);
+    grid->addWidget(m_fileBtn, 1, 0);
     grid->addWidget(m_fileEdit, 1, 1, 1, 2);
+    grid->addWidget(m_forceBox, 2, 0, 1, 3);
+    grid->addWidget(m_trustBox, 3, 0, 1, 3);
 
     /* --- button box --- */
-    QDialogButtonBox *bb = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, this);
-    connect(bb, &QDialogButtonBox::accepted, this, &RRSUCalibDialog::doConfirm);
-    connect(bb, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, this);
+    connect(m_buttons, &QDialogButtonBox::accepted, this, &RRSUCalibDialog::doConfirm);
+    connect(m_buttons, &QDialogButtonBox::rejected, this, &RRSUCalibDialog::reject);
 
     QVBoxLayout *v = new QVBoxLayout(this);
     v->addLayout(grid);
-    v->addWidget(bb);
+    v->addWidget(m_progress);
+    v->addWidget(m_status);
+    v->addWidget(m_buttons);
 }
 
 void RRSUCalibDialog::selectFile()
@@ -113,9 +114,24 @@ void RRSUCalibDialog::selectFile()
     }
 }
 
+void RRSUCalibDialog::reject()
+{
+    // Busy: Cancel (or closing the window) stops the transfer; the dialog
+    // stays open until the worker or the I/O job has noticed.
+    if (m_upload) {
+        m_upload->cancel.store(true, std::memory_order_relaxed);
+        m_status->setText(tr("Cancelling..."));
+        m_buttons->button(QDialogButtonBox::Cancel)->setEnabled(false);
+        return;
+    }
+    QDialog::reject();
+}
+
 void RRSUCalibDialog::doConfirm()
 {
-    if (!m_sys) {
+    if (m_upload)
+        return;
+    if (!m_tool || !m_tool->systemControl()) {
         QMessageBox::critical(this, {}, tr("SystemControl instance is null."));
         return;
     }
@@ -124,20 +140,119 @@ void RRSUCalibDialog::doConfirm()
         return;
     }
 
-    QByteArray blob;
-    bool ok = readFile(m_filePath, blob);
-    if (!ok) {
-        QMessageBox::critical(this, {}, tr("File parsing failed."));
-        return;
-    }
+    m_upload = std::make_shared<Upload>();
+    setBusy(true);
+    m_status->setText(tr("Parsing %1...").arg(QFileInfo(m_filePath).fileName()));
 
+    struct Parsed { QByteArray blob; QString error; bool ok = false; };
+    auto parsed = std::make_shared<Parsed>();
+    const QString path = m_filePath;
+
+    QThread *worker = QThread::create([path, parsed] {
+        parsed->ok = readFile(path, parsed->blob, &parsed->error);
+    });
+    connect(worker, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &QThread::finished, this, [this, parsed, upload = m_upload] {
+        if (upload != m_upload)
+            return;
+        if (upload->cancel.load(std::memory_order_relaxed)) {
+            finishUpload(false);
+            return;
+        }
+        if (!parsed->ok) {
+            m_upload.reset();
+            setBusy(false);
+            m_status->clear();
+            QMessageBox::critical(this, {}, tr("File parsing failed: %1").arg(parsed->error));
+            return;
+        }
+        startUpload(parsed->blob);
+    });
+    worker->start();
+}
+
+void RRSUCalibDialog::startUpload(const QByteArray &blob)
+{
     const QString chan = m_chanBox->currentText();
-    const bool sent = m_sys->sendRRSUCalibration(blob, chan);
+    auto sys = m_tool->systemControl();
+    const bool force = m_forceBox->isChecked();
+    const bool trust = m_trustBox->isChecked();
+    auto upload = m_upload;
+
+    m_status->setText(tr("Uploading %1 bytes to %2...").arg(blob.size()).arg(chan));
+    m_clock.start();
+    m_progressTimer->start();
+
+    m_tool->submit(Rfmu2Priority::Interactive,
+        [sys, blob, chan, force, trust, upload] {
+            bool skipped = false;
+            Rfmu2UploadControl control;
+            control.cancel  = &upload->cancel;
+            control.force   = force;
+            control.trustEarlierSessions = trust;
+            control.skipped = &skipped;
+            control.progress = [upload](qint64 sent, qint64 total) {
+                upload->total.store(total, std::memory_order_relaxed);
+                upload->sent.store(sent, std::memory_order_relaxed);
+            };
+            const bool ok = sys->sendRRSUCalibration(blob, chan, control);
+            upload->skipped.store(skipped, std::memory_order_relaxed);
+            return ok;
+        },
+        this, [this](bool sent) { finishUpload(sent); });
+}
+
+void RRSUCalibDialog::updateProgress()
+{
+    if (!m_upload)
+        return;
+    const qint64 total = m_upload->total.load(std::memory_order_relaxed);
+    const qint64 sent  = m_upload->sent.load(std::memory_order_relaxed);
+    if (total <= 0)
+        return;
+
+    m_progress->setValue(int(sent * 1000 / total));
+    if (m_upload->cancel.load(std::memory_order_relaxed))
+        return;     // keep "Cancelling..." up
+    const qint64 ms = qMax<qint64>(1, m_clock.elapsed());
+    m_status->setText(tr("%1 of %2 bytes  (%3 kB/s)")
+                          .arg(sent).arg(total)
+                          .arg(double(sent) / ms, 0, 'f', 1));
+}
+
+void RRSUCalibDialog::finishUpload(bool sent)
+{
+    const bool cancelled = m_upload && m_upload->cancel.load(std::memory_order_relaxed);
+    const bool skipped   = m_upload && m_upload->skipped.load(std::memory_order_relaxed);
+    m_progressTimer->stop();
+    m_upload.reset();
+    setBusy(false);
+
+    if (cancelled && !sent) {
+        m_status->setText(tr("Upload cancelled."));
+        return;
+    }
+    m_status->clear();
 
     QMessageBox::information(this, {},
-                             sent ? tr("Calibration data sent successfully.")
-                                  : tr("Calibration upload failed."));
+                             skipped ? tr("Channel %1 already has this calibration table; nothing was sent.")
+                                           .arg(m_chanBox->currentText())
+                             : sent  ? tr("Calibration data sent successfully.")
+                                     : tr("Calibration upload failed."));
 
     if (sent)
         accept(); // close dialog
 }
+
+void RRSUCalibDialog::setBusy(bool busy)
+{
+    m_chanBox->setEnabled(!busy);
+    m_forceBox->setEnabled(!busy);
+    m_trustBox->setEnabled(!busy && !m_forceBox->isChecked());
+    m_fileBtn->setEnabled(!busy);
+    m_buttons->button(QDialogButtonBox::Ok)->setEnabled(!busy);
+    m_buttons->button(QDialogButtonBox::Cancel)->setEnabled(true);
+    m_progress->setVisible(busy);
+    if (busy)
+        m_progress->setValue(0);
+}
@@ -1,27 +1,65 @@
 #pragma once
 #include <QDialog>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
 
+class QCheckBox;
 class QComboBox;
+class QDialogButtonBox;
+class QLabel;
 class QLineEdit;
+class QProgressBar;
 class QPushButton;
-class Rfmu2SystemControl;
+class QTimer;
+class Rfmu2Tool;
 
+/*! Parses an RRSU TX-calibration CSV on a worker thread and streams it to
+ *  the selected channel from the I/O thread. Cancel stops either stage;
+ *  closing the dialog while busy cancels first. A table the channel
+ *  acknowledged in this session is not sent again unless forced; one from
+ *  an earlier session only counts when the user says so. */
 class RRSUCalibDialog : public QDialog
 {
     Q_OBJECT
 public:
-    explicit RRSUCalibDialog(Rfmu2SystemControl *sys,
+    explicit RRSUCalibDialog(Rfmu2Tool *tool,
                              QWidget *parent = nullptr);
 
+public slots:
+    void reject() override;
+
 private slots:
     void selectFile();
     void doConfirm();
+    void updateProgress();
 
 private:
-    static bool readFile(const QString &path, QByteArray &outData); // stub
+    // Shared with the parse thread and the upload job
+    struct Upload {
+        std::atomic<bool>   cancel {false};
+        std::atomic<qint64> sent {0};
+        std::atomic<qint64> total {0};
+        std::atomic<bool>   skipped {false};
+    };
+
+    static bool readFile(const QString &path, QByteArray &outData, QString *error);
+    void startUpload(const QByteArray &blob);
+    void finishUpload(bool sent);
+    void setBusy(bool busy);
 
-    Rfmu2SystemControl *m_sys {};            // not owned
+    Rfmu2Tool          *m_tool {};           // not owned
     QComboBox          *m_chanBox {};
+    QPushButton        *m_fileBtn {};
     QLineEdit          *m_fileEdit {};
+    QCheckBox          *m_forceBox {};
+    QCheckBox          *m_trustBox {};
+    QProgressBar       *m_progress {};
+    QLabel             *m_status {};
+    QDialogButtonBox   *m_buttons {};
+    QTimer             *m_progressTimer {};
     QString             m_filePath;
+
+    std::shared_ptr<Upload> m_upload;        // set while parsing or uploading
+    QElapsedTimer       m_clock;
 };
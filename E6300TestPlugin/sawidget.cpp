@@ -1,9 +1,12 @@
 #include "sawidget.h"
 #include "logging.h"
+#include "scalarsweepdialog.h"
 
 SAWidget::SAWidget(QWidget *parent)
     : QWidget{parent},
     customPlot(new QCustomPlot(this)),
+    traceDecimator(new TraceDecimator(customPlot, this)),
+    renderScheduler(new RenderScheduler(customPlot, this)),
     dataTimer(new QTimer(this)),
     pkThreshold(-100),
     pkExcurs(6),
@@ -13,7 +16,8 @@ SAWidget::SAWidget(QWidget *parent)
     markerLabel(new QLabel(customPlot)),
     currentTraceIndex(0),
     frequencyRangeChanged(false),
-    hardwareTool(nullptr)
+    hardwareTool(nullptr),
+    historyPanel(nullptr)
 {
     setMinimumWidth(1500);
     setMinimumHeight(800);
@@ -46,7 +50,7 @@ SAWidget::SAWidget(QWidget *parent)
     pushButton_Stop->setIcon(QIcon(":/images/icons/stop.png"));
     connect(pushButton_Stop, &QPushButton::clicked, this, [=]() {
         logger::log(browser_SA, QStringLiteral("[Mode] Sweep stopped by user."));
-        dataTimer->stop();
+        setMode(SingleMode);
     });
     horiBar->addWidget(pushButton_Stop);
 
@@ -113,6 +117,11 @@ SAWidget::SAWidget(QWidget *parent)
     connect(pushButton_Traces_Export, &QPushButton::clicked, this, &SAWidget::onExportTraceData);
     hbox_Traces->addWidget(pushButton_Traces_Export);
 
+    QPushButton *pushButton_Traces_Import = new QPushButton("Import");
+    pushButton_Traces_Import->setToolTip("Load a trace from an .rtr file into the current trace slot");
+    connect(pushButton_Traces_Import, &QPushButton::clicked, this, &SAWidget::onImportTraceData);
+    hbox_Traces->addWidget(pushButton_Traces_Import);
+
     QPushButton *pushButton_Traces_Clear = new QPushButton("Clear");
     connect(pushButton_Traces_Clear, &QPushButton::clicked, this, &SAWidget::onTraceClearClicked);
     hbox_Traces->addWidget(pushButton_Traces_Clear);
@@ -209,7 +218,7 @@ SAWidget::SAWidget(QWidget *parent)
         checkBox_Markers_Active->setChecked(false);
         checkBox_Markers_Active->blockSignals(wasBlocked);
         updateMarkerLabel();
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     });
 
     gridLayout_Markers->addWidget(pushButton_Markers_PeakSearch, 0, 0);
@@ -232,7 +241,11 @@ SAWidget::SAWidget(QWidget *parent)
     QSplitter *splitter_Middle = new QSplitter(Qt::Vertical, splitter_mainHorizontalLayout);
     splitter_Middle->setChildrenCollapsible(false);
 
+    // No frames while a blocking instrument call has the widget half updated
+    renderScheduler->setHold([this]() { return hardwareTool && hardwareTool->isInCall(); });
+
     // Setup multiple graphs for multiple traces
+    customPlot->setCurrentLayer(renderScheduler->tracesLayer());
     for (int i = 0; i < MAX_TRACES; ++i) {
         customPlot->addGraph();
         traces[i].updateEnabled = true;
@@ -271,13 +284,15 @@ SAWidget::SAWidget(QWidget *parent)
 
     QWidget *tab_logArea = new QWidget(tabWidget);
     QVBoxLayout *verticalLayout_SA_logArea = new QVBoxLayout;
-    browser_SA = new QTextBrowser;
-    browser_SA->setStyleSheet("QTextBrowser { border: none; }");
-    browser_SA->document()->setMaximumBlockCount(20);
+    browser_SA = new LogView(QStringLiteral("SA"));
     verticalLayout_SA_logArea->addWidget(browser_SA);
     tab_logArea->setLayout(verticalLayout_SA_logArea);
     tabWidget->addTab(tab_logArea, "General Messages");
 
+    historyPanel = new SweepHistoryPanel("sa_sweeps.bin", 4096, 1, 1024, tabWidget);
+    connect(historyPanel, &SweepHistoryPanel::sweepSelected, this, &SAWidget::onHistorySweepSelected);
+    tabWidget->addTab(historyPanel, "Sweep History");
+
     splitter_Middle->addWidget(tabWidget);
 
     splitter_mainHorizontalLayout->addWidget(splitter_Middle);
@@ -344,6 +359,11 @@ SAWidget::SAWidget(QWidget *parent)
     connect(pushButton_Frequency_PeakMeasure, &QPushButton::clicked, this, &SAWidget::onFreqPeakMeasureClicked);
     formLayout_Frequency->addRow(pushButton_Frequency_PeakMeasure);
 
+    m_buttonScalarSweep = new QPushButton("Scalar Sweep");
+    m_buttonScalarSweep->setToolTip("Step the signal generator and read the peak here at each point");
+    connect(m_buttonScalarSweep, &QPushButton::clicked, this, &SAWidget::onScalarSweepClicked);
+    formLayout_Frequency->addRow(m_buttonScalarSweep);
+
     vbox_Frequency->addLayout(formLayout_Frequency);
     QHBoxLayout *hbox_Frequency = new QHBoxLayout;
     // QPushButton *pushButton_Frequency_FullSpan = new QPushButton("Full Span");
@@ -431,11 +451,13 @@ SAWidget::SAWidget(QWidget *parent)
     spinBox_Acquisition_SwpTime->setValue(1);
     // formLayout_Acquisition->addRow("Swp Time", spinBox_Acquisition_SwpTime);
 
+    // Minimum time between sweep starts in Auto mode; 0 = free run
     spinBox_Acquisition_SwpInterval = new QSpinBox;
-    spinBox_Acquisition_SwpInterval->setRange(1, 1e6);
+    spinBox_Acquisition_SwpInterval->setRange(0, 1e6);
     spinBox_Acquisition_SwpInterval->setSuffix(" ms");
-    spinBox_Acquisition_SwpInterval->setValue(50);
-    connect(spinBox_Acquisition_SwpInterval, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int value) { dataTimer->setInterval(value); });
+    spinBox_Acquisition_SwpInterval->setSpecialValueText("Free run");
+    spinBox_Acquisition_SwpInterval->setValue(0);
+    spinBox_Acquisition_SwpInterval->setToolTip("Rate cap for Auto mode. Free run starts the next sweep as soon as one completes.");
     formLayout_Acquisition->addRow("Swp Interval", spinBox_Acquisition_SwpInterval);
 
     groupBox_Acquisition->setContentLayout(formLayout_Acquisition);
@@ -453,10 +475,12 @@ SAWidget::SAWidget(QWidget *parent)
     setLayout(mainLayout);
 
     // Initialize markers
+    customPlot->setCurrentLayer(renderScheduler->markersLayer());
     for (int i = 1; i <= 9; ++i) {
         QString markerName = QString("Marker %1").arg(i);
         markers[markerName] = new Marker(customPlot, markerName);
     }
+    customPlot->setCurrentLayer("main");
 
     markerLabel->setStyleSheet("QLabel { background-color : transparent; color : black; }");
     markerLabel->setVisible(false);  // Initially hidden
@@ -469,29 +493,78 @@ SAWidget::SAWidget(QWidget *parent)
     customPlot->installEventFilter(this);
 
     // Setup timer for auto mode updates
-    dataTimer->setInterval(spinBox_Acquisition_SwpInterval->value());
+    // In Auto mode sweeps are chained off completions; the timer only paces
+    // them when a rate cap is set, or polls while no trace needs data.
+    dataTimer->setSingleShot(true);
     connect(dataTimer, &QTimer::timeout, this, &SAWidget::updatePlot);
 
     // setMode(AutoMode); // Set initial mode to AutoMode
+
+    // --- Export thread: trace file encoding and disk I/O ---
+    m_exportThread = new QThread(this);
+    m_exportWorker = new ExportWorker;  // no parent: it is moved to m_exportThread
+    m_exportWorker->moveToThread(m_exportThread);
+    connect(m_exportThread, &QThread::finished, m_exportWorker, &QObject::deleteLater);
+
+    connect(this,           &SAWidget::requestTraceExport,
+            m_exportWorker, &ExportWorker::writeTraceFile);
+    connect(m_exportWorker, &ExportWorker::exportFinished,
+            this,           &SAWidget::onExportFinished,
+            Qt::QueuedConnection);
+
+    m_exportThread->start();
 }
 
 SAWidget::~SAWidget()
 {
+    // Let queued exports finish so no half-written file is left behind
+    if (m_exportThread) {
+        m_exportThread->quit();
+        m_exportThread->wait();
+    }
 }
 
 void SAWidget::setMode(SAWidget::Mode mode) {
     currentMode = mode;
+    m_resumeOnLink = false;     // an explicit mode choice overrides a pending resume
     if (currentMode == AutoMode) {
-        // Start continuous data updates
-        dataTimer->start();
+        m_sweepFailures = 0;
+        // Back to live data: undo any span a history sweep put on the axis
+        customPlot->xAxis->setRange(startFrequency, stopFrequency);
+        // Continuous updates are chained off sweep completions (onRawSweepReady)
     } else {
-        // Stop continuous updates
+        // Sweeps still in flight land and are shown, but start no successor
         dataTimer->stop();
     }
 }
 
+void SAWidget::suspendAcquisition()
+{
+    if (currentMode != AutoMode)
+        return;
+    logger::log(browser_SA, QStringLiteral("[Spectrum] link lost - continuous sweep paused."));
+    setMode(SingleMode);
+    m_resumeOnLink = true;
+    ++m_sweepGeneration;    // whatever is in flight fails with the link
+}
+
+void SAWidget::resumeAcquisition()
+{
+    if (!m_resumeOnLink)
+        return;
+    logger::log(browser_SA, QStringLiteral("[Spectrum] link restored - continuous sweep resumed."));
+    m_resumeOnLink = false;
+    setMode(AutoMode);
+    updatePlot();
+}
+
 void SAWidget::updatePlot()
 {
+    // Not inside a blocking call(): its caller may be half way through
+    // changing the settings and buffers this works on
+    if (hardwareTool && hardwareTool->deferWhileInCall(this, [this]() { updatePlot(); }))
+        return;
+
     if (frequencyRangeChanged) {
         for (int i = 0; i < MAX_TRACES; ++i) {
             // Clear arrays to start fresh
@@ -518,9 +591,127 @@ void SAWidget::updatePlot()
 
     if (needData)
     {
-        acquireSweepData(tmpFreqs, tmpAmps);
+        // The sweep completes asynchronously and is processed in onRawSweepReady()
+        requestSweeps();
+        return;
+    }
+
+    refreshTraces(tmpFreqs, tmpAmps);
+    if (currentMode == AutoMode)
+        dataTimer->start(qMax(spinBox_Acquisition_SwpInterval->value(), kIdlePollMs));
+}
+
+void SAWidget::requestSweeps()
+{
+    // Free run keeps a second sweep queued behind the running one, so the
+    // I/O thread starts it the moment the first completes.
+    const bool freeRun = (currentMode == AutoMode && spinBox_Acquisition_SwpInterval->value() == 0);
+    const int depth = freeRun ? kMaxSweepsInFlight : 1;
+    if (m_sweepsInFlight >= depth)
+        return; // the running sweeps will refresh the traces when they land
+
+    if (!hardwareTool || !hardwareTool->spectrumAnalyzer()) {
+        logger::log(browser_SA, QStringLiteral("Spectrum Analyzer is null!"));
+        return;
+    }
+
+    int freqKHz  = static_cast<int>(spinBox_Frequency_Center->frequency() / 1000.0);
+    double level = spinBox_Level->value();
+    int receive = spinBox_receiveChannel->value();
+    QString chan = comboBox_Channel->currentText();
+
+    logger::log(browser_SA, QString("[Spectrum] Starting measure with freq=%1 kHz, level=%2 dB, receive=%3, chan=%4")
+                                .arg(freqKHz).arg(level).arg(receive).arg(chan));
+
+    // The span travels with the request so the result can be checked against it
+    const double startHz = startFrequency;
+    const double stopHz = stopFrequency;
+    auto sa = hardwareTool->spectrumAnalyzer();
+    const quint32 generation = m_sweepGeneration;
+
+    while (m_sweepsInFlight < depth) {
+        ++m_sweepsInFlight;
+        m_sweepClock.start();
+        const quint64 traceId = Rfmu2Trace::isEnabled() ? Rfmu2Trace::newId() : 0;
+        Rfmu2Trace::asyncBegin("sweep", traceId);
+        Rfmu2TraceScope trace(traceId);
+        hardwareTool->submit(Rfmu2Priority::Streaming,
+            [sa, freqKHz, level, receive, chan]() {
+                return sa->measureRawData(freqKHz, level, receive, chan);
+            },
+            this, [this, startHz, stopHz, generation](const QVector<double> &raw) {
+                --m_sweepsInFlight;
+                if (generation == m_sweepGeneration)
+                    onRawSweepReady(startHz, stopHz, raw);
+                else
+                    renderScheduler->noteSweepDropped();
+            });
+    }
+}
+
+void SAWidget::scheduleNextSweep(bool failed)
+{
+    m_sweepFailures = failed ? m_sweepFailures + 1 : 0;
+
+    // Chain the next sweep off this one instead of a fixed poll interval;
+    // a rate cap only delays it by what is left of the cap.
+    if (currentMode != AutoMode || dataTimer->isActive())
+        return;
+
+    // A sweep that fails at once (no link, write error, timeout) must not
+    // be resubmitted at once: back off, and stop after a few in a row.
+    if (m_sweepFailures >= kMaxSweepFailures) {
+        logger::log(browser_SA, QStringLiteral("[Spectrum] %1 sweeps failed in a row - continuous sweep stopped.")
+                                    .arg(m_sweepFailures));
+        setMode(SingleMode);
+        return;
+    }
+
+    qint64 waitMs = spinBox_Acquisition_SwpInterval->value() - m_sweepClock.elapsed();
+    if (m_sweepFailures > 0)
+        waitMs = qMax<qint64>(waitMs, qMin(kIdlePollMs << (m_sweepFailures - 1), kFailureBackoffMaxMs));
+    if (waitMs <= 0)
+        updatePlot();
+    else
+        dataTimer->start(int(waitMs));
+}
+
+void SAWidget::onRawSweepReady(double startHz, double stopHz, const QVector<double> &raw)
+{
+    Rfmu2TraceSpan span("process");
+    logger::log(browser_SA, QStringLiteral("[Spectrum] measureRawData() returned."));
+
+    // The span moved while this sweep was on the wire: its bins belong to the old axis
+    if (startHz != startFrequency || stopHz != stopFrequency) {
+        logger::log(browser_SA, QStringLiteral("[Spectrum] discarded sweep - span changed during measurement"));
+        renderScheduler->noteSweepDropped();
+        scheduleNextSweep();
+        return;
+    }
+
+    QVector<double> sweepFreqs, sweepAmps;
+    if (!buildSweep(raw, startHz, stopHz, sweepFreqs, sweepAmps)) {
+        renderScheduler->noteSweepDropped();
+        scheduleNextSweep(true);
+        return;
+    }
+    renderScheduler->noteSweepArrived();
+
+    if (historyPanel && historyPanel->isRecording()) {
+        const QString config = QString("center=%1;level=%2;rx=%3;port=%4")
+                                   .arg(spinBox_Frequency_Center->frequency(), 0, 'f', 0)
+                                   .arg(spinBox_Level->value())
+                                   .arg(spinBox_receiveChannel->value())
+                                   .arg(comboBox_Channel->currentText());
+        historyPanel->record(config.toUtf8(), sweepFreqs, {sweepAmps});
     }
 
+    refreshTraces(sweepFreqs, sweepAmps);
+    scheduleNextSweep();
+}
+
+void SAWidget::refreshTraces(const QVector<double> &sweepFreqs, const QVector<double> &sweepAmps)
+{
     for (int i = 0; i < MAX_TRACES; ++i) {
         if (traces[i].type == Off) {
             customPlot->graph(i)->setVisible(false);
@@ -538,9 +729,8 @@ void SAWidget::updatePlot()
         bool newDataAcquired = false;
 
         if (traces[i].updateEnabled) {
-            // acquireSweepData(newFreqs, newAmps);
-            newFreqs = tmpFreqs;
-            newAmps = tmpAmps;
+            newFreqs = sweepFreqs;
+            newAmps = sweepAmps;
             newDataAcquired = true;
         }
 
@@ -549,7 +739,7 @@ void SAWidget::updatePlot()
         case ClearWrite:
             if (newDataAcquired)
                 applyClearWrite(i, newFreqs, newAmps);
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -559,7 +749,7 @@ void SAWidget::updatePlot()
         case MaxHold:
             if (newDataAcquired)
                 applyMaxHold(i, newFreqs, newAmps);
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -570,7 +760,7 @@ void SAWidget::updatePlot()
             if (newDataAcquired)
                 applyMinHold(i, newFreqs, newAmps);
             // For MinHold, display only one line (use main line graph(i))
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -585,12 +775,12 @@ void SAWidget::updatePlot()
             // graph(i) = max line, graph(i + MAX_TRACES) = min line
             if (traces[i].freqs.isEmpty() || traces[i].amps.isEmpty() || traces[i].minAmps.isEmpty()) {
                 // If no data yet, provide empty sets
-                customPlot->graph(i)->setData(QVector<double>(), QVector<double>());
-                customPlot->graph(i + MAX_TRACES)->setData(QVector<double>(), QVector<double>());
+                traceDecimator->clearGraphData(customPlot->graph(i));
+                traceDecimator->clearGraphData(customPlot->graph(i + MAX_TRACES));
             } else {
                 // Use amps for main (max) line, minAmps for min line
-                customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
-                customPlot->graph(i + MAX_TRACES)->setData(traces[i].freqs, traces[i].minAmps);
+                traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
+                traceDecimator->setGraphData(customPlot->graph(i + MAX_TRACES), traces[i].freqs, traces[i].minAmps);
             }
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(!traces[i].hide);
@@ -606,7 +796,7 @@ void SAWidget::updatePlot()
             if (newDataAcquired)
                 applyAverage(i, newFreqs, newAmps);
 
-            customPlot->graph(i)->setData(traces[i].freqs, traces[i].amps);
+            traceDecimator->setGraphData(customPlot->graph(i), traces[i].freqs, traces[i].amps);
             customPlot->graph(i)->setVisible(!traces[i].hide);
             customPlot->graph(i + MAX_TRACES)->setVisible(false);
             customPlot->graph(i)->setBrush(Qt::NoBrush);
@@ -641,44 +831,48 @@ void SAWidget::updatePlot()
     }
 
     updateMarkerLabel();
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces | RenderScheduler::Markers);
 }
 
-void SAWidget::acquireSweepData(QVector<double> &outFreqs, QVector<double> &outAmps)
+void SAWidget::onHistorySweepSelected(const Rfmu2SweepHistory::Sweep &sweep)
 {
-    static constexpr int kExpectedPoints = 411; // hardware spec
-
-    if (!hardwareTool || !hardwareTool->spectrumAnalyzer()) {
-        logger::log(browser_SA, QStringLiteral("Spectrum Analyzer is null!"));
-    }
+    if (sweep.channels.isEmpty())
+        return;
 
-    int freqKHz  = static_cast<int>(spinBox_Frequency_Center->frequency() / 1000.0);
-    double level = spinBox_Level->value();
-    int receive = spinBox_receiveChannel->value();
-    QString chan = comboBox_Channel->currentText();
+    // Looking at the past: stop overwriting the plot with live sweeps,
+    // including any that are still in flight.
+    if (currentMode == AutoMode)
+        setMode(SingleMode);
+    ++m_sweepGeneration;
 
-    logger::log(browser_SA, QString("[Spectrum] Starting measure with freq=%1 kHz, level=%2 dB, receive=%3, chan=%4")
-                                .arg(freqKHz).arg(level).arg(receive).arg(chan));
+    const QVector<double> &freqs = sweep.keys;
+    if (!freqs.isEmpty())
+        customPlot->xAxis->setRange(freqs.first(), freqs.last());
+    refreshTraces(freqs, sweep.channels.first());
+}
 
-    auto rawAmps = hardwareTool->spectrumAnalyzer()->measureRawData(freqKHz, level, receive, chan);
-    logger::log(browser_SA, QStringLiteral("[Spectrum] measureRawData() returned."));
+bool SAWidget::buildSweep(const QVector<double> &raw, double startHz, double stopHz,
+                          QVector<double> &outFreqs, QVector<double> &outAmps)
+{
+    static constexpr int kExpectedPoints = 411; // hardware spec
 
-    if (rawAmps.size() != kExpectedPoints) {
+    if (raw.size() != kExpectedPoints) {
         logger::log(browser_SA,
                     tr("[Spectrum] discarded sweep - expected %1 points, got %2")
                         .arg(kExpectedPoints)
-                        .arg(rawAmps.size()));
+                        .arg(raw.size()));
         outFreqs.clear();
         outAmps.clear();
-        return;
+        return false;
     }
 
-    outAmps = rawAmps;
+    outAmps = raw;
     outFreqs.resize(kExpectedPoints);
-    const double step = (stopFrequency - startFrequency) / double(kExpectedPoints - 1);
+    const double step = (stopHz - startHz) / double(kExpectedPoints - 1);
 
     for (int i = 0; i < kExpectedPoints; ++i)
-        outFreqs[i] = startFrequency + i * step;
+        outFreqs[i] = startHz + i * step;
+    return true;
 }
 
 void SAWidget::applyClearWrite(int traceIndex, const QVector<double> &newFreqs, const QVector<double> &newAmps)
@@ -830,7 +1024,7 @@ void SAWidget::placeMarkerAtClick(QMouseEvent *event)
     checkBox_Markers_Active->blockSignals(wasBlocked);
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::updateMarker(Marker *marker)
@@ -843,11 +1037,8 @@ void SAWidget::updateMarker(Marker *marker)
     double freq = traces[tIndex].freqs[index];
     double amp = traces[tIndex].amps[index];
 
-    marker->tracer->setGraph(customPlot->graph(tIndex));
-    marker->deltaTracer->setGraph(customPlot->graph(tIndex));
-    marker->tracer->setInterpolating(false);
     marker->setVisible(true);
-    marker->setPosition(freq, amp);
+    marker->setPosition(customPlot->graph(tIndex), freq, amp);
 
     updateMarkerLabel();
 }
@@ -869,7 +1060,7 @@ void SAWidget::peakSearch()
     checkBox_Markers_Active->setChecked(true);
     checkBox_Markers_Active->blockSignals(wasBlocked);
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::keyPressEvent(QKeyEvent *event)
@@ -888,11 +1079,11 @@ void SAWidget::keyPressEvent(QKeyEvent *event)
             if (event->key() == Qt::Key_Left && marker->index > 0) {
                 marker->index--;
                 updateMarker(marker);
-                customPlot->replot();
+                renderScheduler->markDirty(RenderScheduler::Markers);
             } else if (event->key() == Qt::Key_Right && marker->index < freqs.size() - 1) {
                 marker->index++;
                 updateMarker(marker);
-                customPlot->replot();
+                renderScheduler->markDirty(RenderScheduler::Markers);
             }
         }
     }
@@ -945,13 +1136,13 @@ void SAWidget::onMarkerActiveStateChanged(int state)
         }
 
         updateMarker(marker);
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     } else {
         // Deactivate the marker
         marker->active = false;
         marker->setVisible(false);
         updateMarkerLabel();
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     }
 }
 
@@ -1029,7 +1220,7 @@ void SAWidget::onDeltaButtonClicked()
     // If active, proceed as normal
     marker->toggleDeltaMode();
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::onValueOfSetFreqChanged(double frequency)
@@ -1050,7 +1241,7 @@ void SAWidget::onValueOfSetFreqChanged(double frequency)
     checkBox_Markers_Active->setChecked(true);
     checkBox_Markers_Active->blockSignals(wasBlocked);
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::onPkTrackingStateChanged(int state)
@@ -1065,18 +1256,158 @@ void SAWidget::onPkTrackingStateChanged(int state)
         checkBox_Markers_Active->setChecked(true);
         checkBox_Markers_Active->blockSignals(wasBlocked);
         updateMarker(marker);
-        customPlot->replot();
+        renderScheduler->markDirty(RenderScheduler::Markers);
     }
 }
 
 void SAWidget::onExportTraceData()
 {
-    QString fileName = QFileDialog::getSaveFileName(this, "Export Trace Data", QString(), "CSV Files (*.csv);;All Files (*)");
+    const QString filterRaw = "RFMU Trace (*.rtr)";
+    const QString filterPacked = "RFMU Trace, compressed (*.rtr)";
+    const QString filterCsv = "CSV Files, current trace (*.csv)";
+    QString selectedFilter = filterRaw;
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Trace Data", QString(),
+                                                    filterRaw + ";;" + filterPacked + ";;" + filterCsv,
+                                                    &selectedFilter);
 
     if (fileName.isEmpty()) {
         return;
     }
 
+    if (selectedFilter == filterCsv) {
+        exportCurrentTraceCsv(fileName);
+        return;
+    }
+
+    Rfmu2TraceFile::Contents contents = traceFileContents();
+    if (contents.columns.isEmpty()) {
+        QMessageBox::information(this, "No Data", "No trace holds any data to export.");
+        return;
+    }
+    if (!fileName.endsWith(Rfmu2TraceFile::fileSuffix(), Qt::CaseInsensitive))
+        fileName += Rfmu2TraceFile::fileSuffix();
+
+    // Encoding and disk I/O run on the export thread; the result is logged.
+    emit requestTraceExport(fileName, contents, selectedFilter == filterPacked);
+}
+
+Rfmu2TraceFile::Contents SAWidget::traceFileContents() const
+{
+    Rfmu2TraceFile::Contents contents;
+    contents.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    contents.config = QString("center=%1;span=%2;level=%3;rx=%4;port=%5")
+                          .arg(spinBox_Frequency_Center->frequency(), 0, 'f', 0)
+                          .arg(stopFrequency - startFrequency, 0, 'f', 0)
+                          .arg(spinBox_Level->value())
+                          .arg(spinBox_receiveChannel->value())
+                          .arg(comboBox_Channel->currentText())
+                          .toUtf8();
+
+    // Per trace: "Tn.freq" (Hz, float64), "Tn.amp" (dBm, float32) and, for
+    // Min/Max Hold, "Tn.min". The vectors are implicitly shared, not copied.
+    for (int i = 0; i < MAX_TRACES; ++i) {
+        const TraceData &t = traces[i];
+        if (t.type == Off || t.freqs.isEmpty() || t.amps.size() != t.freqs.size())
+            continue;
+
+        const QString prefix = QString("T%1.").arg(i + 1);
+        contents.columns.append({prefix + "freq", "Hz", Rfmu2TraceFile::SampleType::Float64, t.freqs});
+        contents.columns.append({prefix + "amp", "dBm", Rfmu2TraceFile::SampleType::Float32, t.amps});
+        if (t.type == MinMaxHold && t.minAmps.size() == t.freqs.size())
+            contents.columns.append({prefix + "min", "dBm", Rfmu2TraceFile::SampleType::Float32, t.minAmps});
+    }
+    return contents;
+}
+
+void SAWidget::onImportTraceData()
+{
+    const QString fileName = QFileDialog::getOpenFileName(this, "Import Trace Data", QString(),
+                                                          "RFMU Trace (*.rtr);;All Files (*)");
+    if (fileName.isEmpty())
+        return;
+
+    Rfmu2TraceFile::Contents contents;
+    QString error;
+    if (!Rfmu2TraceFile::read(fileName, contents, &error)) {
+        QMessageBox::warning(this, "Import Failed", error);
+        return;
+    }
+
+    QStringList available;
+    for (const auto &col : contents.columns) {
+        if (col.name.endsWith(".amp"))
+            available << col.name.chopped(4);
+    }
+    if (available.isEmpty()) {
+        QMessageBox::warning(this, "Import Failed", "The file holds no amplitude trace.");
+        return;
+    }
+
+    QString source = available.first();
+    if (available.size() > 1) {
+        bool ok = false;
+        source = QInputDialog::getItem(this, "Import Trace Data",
+                                       QString("Load into Trace %1 from:").arg(currentTraceIndex + 1),
+                                       available, 0, false, &ok);
+        if (!ok)
+            return;
+    }
+
+    const int freqCol = contents.indexOf(source + ".freq");
+    const int ampCol = contents.indexOf(source + ".amp");
+    const int minCol = contents.indexOf(source + ".min");
+    if (freqCol < 0 || contents.columns[freqCol].values.size() != contents.columns[ampCol].values.size()) {
+        QMessageBox::warning(this, "Import Failed", "The trace has no matching frequency column.");
+        return;
+    }
+
+    const int i = currentTraceIndex;
+    loadReferenceTrace(i, contents.columns[freqCol].values, contents.columns[ampCol].values,
+                       (minCol >= 0) ? contents.columns[minCol].values : QVector<double>());
+
+    logger::log(browser_SA, QString("[Trace] Loaded %1 from %2 into Trace %3 (%4 points).")
+                                .arg(source, QFileInfo(fileName).fileName())
+                                .arg(i + 1).arg(traces[i].freqs.size()));
+}
+
+void SAWidget::loadReferenceTrace(int i, const QVector<double> &freqs, const QVector<double> &amps,
+                                  const QVector<double> &minAmps)
+{
+    // A reference trace is frozen: it keeps its data and ignores new sweeps.
+    const bool minMax = !minAmps.isEmpty();
+    TraceData &t = traces[i];
+    t.type = minMax ? MinMaxHold : ClearWrite;
+    t.updateEnabled = false;
+    t.freqs = freqs;
+    t.amps = amps;
+    t.minAmps = minAmps;
+    t.sumAmps.clear();
+    t.lastSweeps.clear();
+
+    onCurrentTraceChanged(i);   // sync the trace controls without triggering a sweep
+
+    traceDecimator->setGraphData(customPlot->graph(i), t.freqs, t.amps);
+    customPlot->graph(i)->setVisible(!t.hide);
+    if (minMax) {
+        traceDecimator->setGraphData(customPlot->graph(i + MAX_TRACES), t.freqs, t.minAmps);
+        customPlot->graph(i + MAX_TRACES)->setVisible(!t.hide);
+    } else {
+        traceDecimator->clearGraphData(customPlot->graph(i + MAX_TRACES));
+        customPlot->graph(i + MAX_TRACES)->setVisible(false);
+    }
+    renderScheduler->markDirty(RenderScheduler::Traces | RenderScheduler::Markers);
+}
+
+void SAWidget::onExportFinished(const QString &path, bool ok, const QString &error)
+{
+    if (ok)
+        logger::log(browser_SA, "[Trace] Exported " + path);
+    else
+        QMessageBox::warning(this, "Export Failed", QString("%1\n%2").arg(path, error));
+}
+
+void SAWidget::exportCurrentTraceCsv(const QString &fileName)
+{
     QFile file(fileName);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         QMessageBox::warning(this, "Export Failed", "Could not open the file for writing.");
@@ -1127,7 +1458,7 @@ void SAWidget::onTraceHideStateChanged(int state)
         customPlot->graph(currentTraceIndex + MAX_TRACES)->setVisible(!traces[currentTraceIndex].hide);
     }
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void SAWidget::onPlotColorChanged(const QColor &color)
@@ -1136,7 +1467,7 @@ void SAWidget::onPlotColorChanged(const QColor &color)
     customPlot->graph(currentTraceIndex)->setPen(QPen(color));
     QColor minColor = color;
     customPlot->graph(currentTraceIndex + MAX_TRACES)->setPen(QPen(minColor));
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void SAWidget::onCurrentTraceChanged(int index)
@@ -1188,7 +1519,7 @@ void SAWidget::onMarkerPlaceOnChanged(int newTraceIndex)
     }
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::onTraceTypeChanged(int index)
@@ -1228,8 +1559,8 @@ void SAWidget::onTraceClearClicked()
     }
 
     // Update the graph to show no data
-    customPlot->graph(currentTraceIndex)->setData(QVector<double>(), QVector<double>());
-    customPlot->graph(i + MAX_TRACES)->setData(QVector<double>(), QVector<double>());
+    traceDecimator->clearGraphData(customPlot->graph(currentTraceIndex));
+    traceDecimator->clearGraphData(customPlot->graph(i + MAX_TRACES));
 
     // If any markers are on this trace, deactivate them since no data is available
     for (auto &marker : markers) {
@@ -1249,7 +1580,7 @@ void SAWidget::onTraceClearClicked()
         label_CurrAvg->setText("CurrAvg: N/A");
     }
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces | RenderScheduler::Markers);
 }
 
 void SAWidget::onAvgCountChanged(int avgCount)
@@ -1291,11 +1622,11 @@ void SAWidget::onCopyToIndexChanged(int index)
     // Revert combo box to "--"
     revertCopyToComboBox();
 
-    customPlot->graph(destIndex)->setData(traces[destIndex].freqs, traces[destIndex].amps);
+    traceDecimator->setGraphData(customPlot->graph(destIndex), traces[destIndex].freqs, traces[destIndex].amps);
     customPlot->graph(destIndex)->setVisible(!traces[destIndex].hide);
 
     if (traces[destIndex].type == MinMaxHold) {
-        customPlot->graph(destIndex + MAX_TRACES)->setData(traces[destIndex].freqs, traces[destIndex].minAmps);
+        traceDecimator->setGraphData(customPlot->graph(destIndex + MAX_TRACES), traces[destIndex].freqs, traces[destIndex].minAmps);
         customPlot->graph(destIndex + MAX_TRACES)->setVisible(!traces[destIndex].hide);
         QColor fillColor = traces[destIndex].color;
         fillColor.setAlpha(50);
@@ -1325,7 +1656,7 @@ void SAWidget::onCopyToIndexChanged(int index)
 
     updateMarkerLabel();
 
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Traces);
 }
 
 void SAWidget::revertCopyToComboBox()
@@ -1384,7 +1715,7 @@ void SAWidget::onMinPeakClicked()
     checkBox_Markers_Active->blockSignals(wasBlocked);
 
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::computeMeanAndStdev(const QVector<double> &amps, double &mean, double &stdev)
@@ -1571,7 +1902,7 @@ void SAWidget::onPeakLeftClicked()
     // Update marker position
     marker->index = bestIndex;
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::onPeakRightClicked()
@@ -1598,7 +1929,7 @@ void SAWidget::onPeakRightClicked()
         if (p.index > currentIdx) {
             marker->index = p.index;
             updateMarker(marker);
-            customPlot->replot();
+            renderScheduler->markDirty(RenderScheduler::Markers);
             return;
         }
     }
@@ -1661,7 +1992,7 @@ void SAWidget::onNextPeakClicked()
 
     marker->index = allPeaks[nextPos].index;
     updateMarker(marker);
-    customPlot->replot();
+    renderScheduler->markDirty(RenderScheduler::Markers);
 }
 
 void SAWidget::onRefLevelChanged(double newRefLevel) {
@@ -1673,7 +2004,7 @@ void SAWidget::onRefLevelChanged(double newRefLevel) {
     double rangeBottom = rangeTop - 10 * div; // Calculate the bottom of the range (10 divisions below the ref level)
 
     customPlot->yAxis->setRange(rangeBottom, rangeTop); // Set y-axis range
-    customPlot->replot(); // Replot the graph to update the view
+    renderScheduler->markDirty(RenderScheduler::Axes);
 }
 
 void SAWidget::onDivChanged(double newDiv) {
@@ -1688,7 +2019,7 @@ void SAWidget::onDivChanged(double newDiv) {
     double rangeBottom = rangeTop - 10 * newDiv;
 
     customPlot->yAxis->setRange(rangeBottom, rangeTop); // Set the new y-axis range
-    customPlot->replot(); // Replot the graph to update the view
+    renderScheduler->markDirty(RenderScheduler::Axes);
 }
 
 void SAWidget::onFreqPeakMeasureClicked()
@@ -1697,6 +2028,10 @@ void SAWidget::onFreqPeakMeasureClicked()
         logger::log(browser_SA, QStringLiteral("Spectrum Analyzer is null!"));
         return;
     }
+    if (m_peakInFlight) {
+        logger::log(browser_SA, QStringLiteral("[Spectrum] Peak measure already running."));
+        return;
+    }
 
     int freqKHz  = static_cast<int>(spinBox_Frequency_Center->frequency() / 1000.0);
     double level = spinBox_Level->value();
@@ -1706,15 +2041,140 @@ void SAWidget::onFreqPeakMeasureClicked()
     logger::log(browser_SA, QString("[Spectrum] Starting peak measure with freq=%1, level=%2, receive=%3, chan=%4")
                            .arg(freqKHz).arg(level).arg(receive).arg(chan));
 
-    QVector<double> outAmps = hardwareTool->spectrumAnalyzer()->measurePeakData(freqKHz, level, receive, chan);
+    auto sa = hardwareTool->spectrumAnalyzer();
+
+    m_peakInFlight = true;
+    hardwareTool->submit(Rfmu2Priority::Interactive,
+        [sa, freqKHz, level, receive, chan]() {
+            return sa->measurePeakData(freqKHz, level, receive, chan);
+        },
+        this, [this](const QVector<double> &peak) {
+            onPeakDataReady(peak);
+        });
+}
+
+void SAWidget::onPeakDataReady(const QVector<double> &peak)
+{
+    m_peakInFlight = false;
     logger::log(browser_SA, QStringLiteral("[Spectrum] measurePeakData() returned."));
-    int dataSize = outAmps.size();
-    if(dataSize == 0)
+    if (peak.isEmpty())
     {
         logger::log(browser_SA, QStringLiteral("Spectrum measure returned empty."));
         return;
     }
-    logger::log(browser_SA, QString("[Spectrum] Peak value=%1").arg(QString::number(outAmps.first(), 'f', 6)));
+    logger::log(browser_SA, QString("[Spectrum] Peak value=%1").arg(QString::number(peak.first(), 'f', 6)));
+}
+
+// ---------------- scalar response sweep ----------------
+void SAWidget::onScalarSweepClicked()
+{
+    if (m_scalarRunning) {
+        m_scalarCancel = true;  // takes effect when the current chunk lands
+        return;
+    }
+    if (!hardwareTool || !hardwareTool->scalarAnalyzer()) {
+        logger::log(browser_SA, QStringLiteral("Spectrum Analyzer is null!"));
+        return;
+    }
+
+    ScalarSweepDialog dlg(this);
+    if (dlg.exec() != QDialog::Accepted)
+        return;
+
+    // Live sweeps would retune the receiver between scalar points
+    if (currentMode == AutoMode)
+        setMode(SingleMode);
+
+    m_scalarSetup = Rfmu2ScalarAnalyzer::Setup();
+    m_scalarSetup.freqsKHz        = dlg.freqsKHz();
+    m_scalarSetup.sourceLevelDbm  = dlg.sourceLevelDbm();
+    m_scalarSetup.sourcePort      = dlg.sourcePort();
+    m_scalarSetup.receiveLevelDbm = spinBox_Level->value();
+    m_scalarSetup.receiveChannel  = spinBox_receiveChannel->value();
+    m_scalarSetup.receivePort     = comboBox_Channel->currentText();
+    m_scalarSetup.window          = dlg.pipelined() ? 2 : 1;
+    m_scalarAsGain = dlg.showAsGain();
+
+    logger::log(browser_SA, QString("[Scalar] %1 points, %2-%3 kHz, source %4 dBm on %5, receive RX%6 %7%8")
+                                .arg(m_scalarSetup.freqsKHz.size())
+                                .arg(m_scalarSetup.freqsKHz.first()).arg(m_scalarSetup.freqsKHz.last())
+                                .arg(m_scalarSetup.sourceLevelDbm).arg(m_scalarSetup.sourcePort)
+                                .arg(m_scalarSetup.receiveChannel).arg(m_scalarSetup.receivePort)
+                                .arg(dlg.pipelined() ? ", pipelined" : ""));
+
+    m_scalarPower.clear();
+    m_scalarPower.reserve(m_scalarSetup.freqsKHz.size());
+    m_scalarRunning = true;
+    m_scalarCancel = false;
+    m_buttonScalarSweep->setText("Stop Scalar Sweep");
+    m_scalarClock.start();
+    submitScalarChunk();
+}
+
+void SAWidget::submitScalarChunk()
+{
+    Rfmu2ScalarAnalyzer::Setup chunk = m_scalarSetup;
+    chunk.freqsKHz = m_scalarSetup.freqsKHz.mid(m_scalarPower.size(), kScalarChunk);
+    const int requested = chunk.freqsKHz.size();
+
+    auto scalar = hardwareTool->scalarAnalyzer();
+    hardwareTool->submit(Rfmu2Priority::Interactive,
+        [scalar, chunk]() { return scalar->measureResponse(chunk); },
+        this, [this, requested](const QVector<double> &power) {
+            onScalarChunkDone(power, requested);
+        });
+}
+
+void SAWidget::onScalarChunkDone(const QVector<double> &power, int requested)
+{
+    m_scalarPower += power;
+
+    if (power.size() < requested) {
+        finishScalarSweep(QString("no valid reading at point %1").arg(m_scalarPower.size()));
+        return;
+    }
+    if (m_scalarCancel) {
+        finishScalarSweep("stopped by user");
+        return;
+    }
+    if (m_scalarPower.size() < m_scalarSetup.freqsKHz.size()) {
+        m_buttonScalarSweep->setText(QString("Stop Scalar Sweep (%1%)")
+                                         .arg(100 * m_scalarPower.size() / m_scalarSetup.freqsKHz.size()));
+        submitScalarChunk();
+        return;
+    }
+    finishScalarSweep(QString());
+}
+
+void SAWidget::finishScalarSweep(const QString &error)
+{
+    m_scalarRunning = false;
+    m_buttonScalarSweep->setText("Scalar Sweep");
+
+    const int n = m_scalarPower.size();
+    const double elapsedMs = m_scalarClock.nsecsElapsed() / 1e6;
+    if (!error.isEmpty())
+        logger::log(browser_SA, QString("[Scalar] Ended early: %1.").arg(error));
+    logger::log(browser_SA, QString("[Scalar] %1 of %2 points in %3 ms (%4 ms/point).")
+                                .arg(n).arg(m_scalarSetup.freqsKHz.size())
+                                .arg(elapsedMs, 0, 'f', 1)
+                                .arg(n ? elapsedMs / n : 0.0, 0, 'f', 2));
+    if (n == 0)
+        return;
+
+    const double offsetDb = m_scalarAsGain ? m_scalarSetup.sourceLevelDbm : 0.0;
+    QVector<double> freqs(n), amps(n);
+    for (int k = 0; k < n; ++k) {
+        freqs[k] = m_scalarSetup.freqsKHz[k] * 1e3;
+        amps[k]  = m_scalarPower[k] - offsetDb;
+    }
+
+    loadReferenceTrace(currentTraceIndex, freqs, amps);
+    customPlot->xAxis->setRange(freqs.first(), freqs.last());
+    renderScheduler->markDirty(RenderScheduler::Axes);
+    logger::log(browser_SA, QString("[Scalar] Response loaded into Trace %1%2.")
+                                .arg(currentTraceIndex + 1)
+                                .arg(m_scalarAsGain ? " as gain (dB)" : ""));
 }
 
 void SAWidget::setTool(Rfmu2Tool *tool)
@@ -16,11 +16,18 @@
 #include <QSpinBox>
 #include <QSplitter>
 #include <QTabWidget>
+#include <QThread>
+#include <QElapsedTimer>
 #include "include/qcustomplot.h"
 #include "include/frequencyspinbox.h"
 #include "marker.h"
+#include "tracedecimator.h"
+#include "renderscheduler.h"
 #include "colorpickerwidget.h"
 #include "collapsiblegroupbox.h"
+#include "sweephistorypanel.h"
+#include "exportworker.h"
+#include "logview.h"
 #include "include/rfmu2/rfmu2tool.h"
 
 class SAWidget : public QWidget
@@ -46,9 +53,16 @@ public:
 
     void setTool(Rfmu2Tool *tool);
 
+    // Replot and sweep-to-screen statistics of the plot
+    const RenderScheduler *renderStats() const noexcept { return renderScheduler; }
+
 public slots:
     void stopAutoSweep() { setMode(SingleMode); }
 
+    // Link lost / back: a running Auto sweep pauses and picks up again
+    void suspendAcquisition();
+    void resumeAcquisition();
+
 private:
     struct TraceData {
         QVector<double> freqs;       // Current frequencies for this trace
@@ -72,6 +86,7 @@ private:
     };
 
 signals:
+    void requestTraceExport(const QString &path, const Rfmu2TraceFile::Contents &contents, bool compress);
 
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -90,6 +105,8 @@ private slots:
     void onValueOfSetFreqChanged(double frequency);
     void onPkTrackingStateChanged(int state);
     void onExportTraceData();
+    void onImportTraceData();
+    void onExportFinished(const QString &path, bool ok, const QString &error);
     void onTraceUpdateStateChanged(int state);
     void onTraceHideStateChanged(int state);
     void onPlotColorChanged(const QColor &color);
@@ -109,13 +126,24 @@ private slots:
     void onDivChanged(double newDiv);
 
     void onFreqPeakMeasureClicked();
+    void onRawSweepReady(double startHz, double stopHz, const QVector<double> &raw);
+    void onPeakDataReady(const QVector<double> &peak);
+    void onScalarSweepClicked();
+    void onHistorySweepSelected(const Rfmu2SweepHistory::Sweep &sweep);
 
 private:
     void updateMarker(Marker *marker);
     void updateMarkerLabel();
 
-    // Data acquisition function that always returns a fresh sweep
-    void acquireSweepData(QVector<double> &outFreqs, QVector<double> &outAmps);
+    // Keep the sweep pipeline filled on the I/O thread; results arrive in onRawSweepReady()
+    void requestSweeps();
+    // `failed`: the sweep that just landed was unusable (backs off, gives up after a few)
+    void scheduleNextSweep(bool failed = false);
+    // Turn raw FFT bins into a frequency/amplitude sweep, false if the data is unusable
+    bool buildSweep(const QVector<double> &raw, double startHz, double stopHz,
+                    QVector<double> &outFreqs, QVector<double> &outAmps);
+    // Feed one sweep (live or from history) through the trace types and markers
+    void refreshTraces(const QVector<double> &sweepFreqs, const QVector<double> &sweepAmps);
 
     // Helper functions for each type
     void applyClearWrite(int traceIndex, const QVector<double> &newFreqs, const QVector<double> &newAmps);
@@ -125,6 +153,16 @@ private:
     void applyAverage(int traceIndex, const QVector<double> &newFreqs, const QVector<double> &newAmps);
 
     void copyTraceData(int srcIndex, int destIndex);
+    // Put a finished trace (file import, scalar sweep) into slot i, frozen
+    void loadReferenceTrace(int i, const QVector<double> &freqs, const QVector<double> &amps,
+                            const QVector<double> &minAmps = QVector<double>());
+
+    // Scalar response sweep: submitted in chunks so other requests get a turn
+    void submitScalarChunk();
+    void onScalarChunkDone(const QVector<double> &power, int requested);
+    void finishScalarSweep(const QString &error);
+    Rfmu2TraceFile::Contents traceFileContents() const;
+    void exportCurrentTraceCsv(const QString &fileName);
     void revertCopyToComboBox();
 
     void computeMeanAndStdev(const QVector<double> &amps, double &mean, double &stdev);
@@ -132,6 +170,8 @@ private:
     bool checkExcursion(const QVector<double> &amps, int peakIndex, double pkExcurs);
 
     QCustomPlot *customPlot;
+    TraceDecimator *traceDecimator; // Full-resolution trace data -> per-pixel min/max for drawing
+    RenderScheduler *renderScheduler; // Coalesces replot requests into at most one per frame
     QTimer *dataTimer;
 
     double pkThreshold; // For user-defined min amplitude
@@ -176,7 +216,32 @@ private:
 
     Rfmu2Tool *hardwareTool;
 
-    QTextBrowser *browser_SA;
+    LogView *browser_SA;
+    SweepHistoryPanel *historyPanel;
+
+    QThread *m_exportThread {nullptr};
+    ExportWorker *m_exportWorker {nullptr};
+
+    int m_sweepsInFlight {0};         // sweeps queued or running on the I/O thread
+    quint32 m_sweepGeneration {0};    // bumped to discard sweeps still in flight
+    bool m_resumeOnLink {false};      // Auto mode was interrupted by a link loss
+    QElapsedTimer m_sweepClock;       // since the last sweep was issued (rate cap)
+    static constexpr int kMaxSweepsInFlight = 2; // free run: one running, one queued
+    static constexpr int kIdlePollMs = 200;      // Auto mode with no trace to update
+    int m_sweepFailures {0};          // consecutive sweeps that came back unusable
+    static constexpr int kMaxSweepFailures = 5;      // then Auto mode gives up
+    static constexpr int kFailureBackoffMaxMs = 5000;
+    bool m_peakInFlight {false};
+
+    // --- scalar (SG -> SA) response sweep ---
+    QPushButton *m_buttonScalarSweep {nullptr};
+    Rfmu2ScalarAnalyzer::Setup m_scalarSetup;   // freqsKHz holds the whole sweep
+    QVector<double> m_scalarPower;
+    bool m_scalarAsGain {false};                // show response - source level
+    bool m_scalarRunning {false};
+    bool m_scalarCancel {false};
+    QElapsedTimer m_scalarClock;
+    static constexpr int kScalarChunk = 64;     // points per I/O job
 };
 
 #endif // SAWIDGET_H
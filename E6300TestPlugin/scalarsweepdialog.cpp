@@ -0,0 +1,94 @@
+#include "scalarsweepdialog.h"
+#include <QDoubleSpinBox>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QFormLayout>
+#include <QDialogButtonBox>
+#include <QMessageBox>
+
+ScalarSweepDialog::ScalarSweepDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Scalar Response Sweep"));
+
+    auto makeFreqBox = [this](double ghz) {
+        auto *sb = new QDoubleSpinBox(this);
+        sb->setRange(0.1, 6.0);   // GHz
+        sb->setDecimals(6);       // 1 kHz resolution
+        sb->setSingleStep(0.001);
+        sb->setValue(ghz);
+        return sb;
+    };
+
+    m_startFreq = makeFreqBox(1.0);
+    m_stopFreq  = makeFreqBox(3.0);
+
+    m_points = new QSpinBox(this);
+    m_points->setRange(2, 20001);
+    m_points->setValue(201);
+
+    m_sourceLevel = new QDoubleSpinBox(this);
+    m_sourceLevel->setRange(-100.0, 10.0);
+    m_sourceLevel->setDecimals(1);
+    m_sourceLevel->setSuffix(" dBm");
+    m_sourceLevel->setValue(-10.0);
+
+    m_sourcePort = new QComboBox(this);
+    m_sourcePort->addItems({"01A","01B","01C","01D",
+                            "02A","02B","02C","02D",
+                            "03A","03B","03C","03D",
+                            "04A","04B","04C","04D"});
+    m_sourcePort->setCurrentText("01A");
+
+    m_pipelined = new QCheckBox(tr("Send next SG step while reading the SA"), this);
+    m_pipelined->setChecked(true);
+
+    m_gain = new QCheckBox(tr("Show as gain (response - source level)"), this);
+
+    auto *lay = new QFormLayout(this);
+    lay->addRow(tr("Start Freq [GHz]:"), m_startFreq);
+    lay->addRow(tr("Stop Freq [GHz]:"),  m_stopFreq);
+    lay->addRow(tr("Points:"),           m_points);
+    lay->addRow(tr("Source Level:"),     m_sourceLevel);
+    lay->addRow(tr("Source RfPath:"),    m_sourcePort);
+    lay->addRow(m_pipelined);
+    lay->addRow(m_gain);
+
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Ok
+                                         | QDialogButtonBox::Cancel, this);
+    lay->addWidget(m_buttons);
+
+    connect(m_buttons, &QDialogButtonBox::accepted, this, &ScalarSweepDialog::doConfirm);
+    connect(m_buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+void ScalarSweepDialog::doConfirm()
+{
+    // freqsKHz() steps from start to stop; an empty or reversed span would
+    // repeat one point or sweep downwards
+    if (m_stopFreq->value() <= m_startFreq->value()) {
+        QMessageBox::warning(this, {}, tr("Stop frequency must be above the start frequency."));
+        return;
+    }
+    accept();
+}
+
+/* ---------- trivial getters ------------------------------------------ */
+double  ScalarSweepDialog::startFreqHz()    const { return m_startFreq->value() * 1e9; }
+double  ScalarSweepDialog::stopFreqHz()     const { return m_stopFreq->value() * 1e9;  }
+int     ScalarSweepDialog::points()         const { return m_points->value();          }
+double  ScalarSweepDialog::sourceLevelDbm() const { return m_sourceLevel->value();     }
+QString ScalarSweepDialog::sourcePort()     const { return m_sourcePort->currentText(); }
+bool    ScalarSweepDialog::pipelined()      const { return m_pipelined->isChecked();   }
+bool    ScalarSweepDialog::showAsGain()     const { return m_gain->isChecked();        }
+
+QVector<int> ScalarSweepDialog::freqsKHz() const
+{
+    const int n = points();
+    const double step = (stopFreqHz() - startFreqHz()) / double(n - 1);
+    QVector<int> out(n);
+    for (int i = 0; i < n; ++i)
+        out[i] = static_cast<int>(qRound64((startFreqHz() + i * step) / 1'000.0));
+    return out;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <QDialog>
+#include <QVector>
+
+class QDoubleSpinBox;
+class QSpinBox;
+class QComboBox;
+class QCheckBox;
+class QDialogButtonBox;
+
+/*! Stimulus side of a scalar (SG -> SA) response sweep. The receive side
+ *  uses the spectrum analyzer's own Level / Receive / Channel settings.   */
+class ScalarSweepDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit ScalarSweepDialog(QWidget *parent = nullptr);
+
+    double  startFreqHz()    const;
+    double  stopFreqHz()     const;
+    int     points()         const;
+    double  sourceLevelDbm() const;
+    QString sourcePort()     const;
+    bool    pipelined()      const;
+    bool    showAsGain()     const;   // subtract the source level
+
+    QVector<int> freqsKHz()  const;
+
+private slots:
+    void doConfirm();
+
+private:
+    QDoubleSpinBox *m_startFreq, *m_stopFreq;
+    QSpinBox       *m_points;
+    QDoubleSpinBox *m_sourceLevel;
+    QComboBox      *m_sourcePort;
+    QCheckBox      *m_pipelined;
+    QCheckBox      *m_gain;
+    QDialogButtonBox *m_buttons;
+};
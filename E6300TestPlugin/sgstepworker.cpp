@@ -1,4 +0,0 @@
-#include "sgstepworker.h"
-#include <QThread>
-#include "include/rfmu2/rfmu2tool.h"
-#include "include/rfmu2/rfmu2signalgenerator.h"
@@ -4,7 +4,12 @@
 #include <QGroupBox>
 #include <QFormLayout>
 #include <QVBoxLayout>
+#include <QHBoxLayout>
 #include <QLabel>
+#include <QDialog>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDialogButtonBox>
 #include <QDebug>
 
 SGWidget::SGWidget(QWidget *parent)
@@ -16,9 +21,8 @@ SGWidget::SGWidget(QWidget *parent)
     mainLayout->setSpacing(10);
 
     // Optional log area at bottom
-    mLogArea = new QTextBrowser(this);
+    mLogArea = new LogView(QStringLiteral("SG"), this);
     mLogArea->setFixedHeight(100);
-    mLogArea->document()->setMaximumBlockCount(20);
     logger::log(mLogArea, QStringLiteral("Signal generator initialized."));
 
     // Group box for Signal Generator inputs
@@ -111,41 +115,25 @@ SGWidget::SGWidget(QWidget *parent)
     connect(mStopSingleBtn, &QPushButton::clicked,
             this, &SGWidget::onStopSingleOutputClicked);
 
-    m_btnStepSweep = new QPushButton(tr("Step Sweep"), signalGenGroup);
-    sigLayout->addRow(m_btnStepSweep);
-    connect(m_btnStepSweep, &QPushButton::clicked,
-            this, &SGWidget::onStepSweepClicked);
-
-    /* ---------- dedicated sweep thread ----------------- */
-    m_sweepThread  = new QThread(this);
-    m_sweepWorker = new SGStepWorker;
-
-    connect(m_sweepWorker, &SGStepWorker::stepReady,
-            this, [this](int freqKHz, double lvlDbm, const QString &path)
-            {
-                if (!hardwareTool || !hardwareTool->signalGenerator())
-                    return;
-
-                logger::log(mLogArea, QString("[SignalGen] Configure single freq=%1 kHz, level=%2 dBm, path=%3").arg(freqKHz).arg(lvlDbm).arg(path));
-                bool ok = hardwareTool->signalGenerator()->configureSingleChannel(freqKHz, lvlDbm, path);
-                if (!ok) {
-                    logger::log(mLogArea, QStringLiteral("Failed to configure single channel."));
-                } else {
-                    logger::log(mLogArea, QStringLiteral("Single channel configured successfully."));
-                }
-            },
-            Qt::QueuedConnection);   // ensure it runs in the GUI thread
+    /* ---------- step sweep: timed on the I/O thread ------ */
+    m_btnStepSweep   = new QPushButton(tr("Step Sweep"), signalGenGroup);
+    m_btnStopSweep   = new QPushButton(tr("Stop Sweep"), signalGenGroup);
+    m_btnSweepTiming = new QPushButton(tr("Sweep Timing..."), signalGenGroup);
+    m_btnStopSweep->setEnabled(false);
+    m_btnSweepTiming->setEnabled(false);
 
-    m_sweepWorker->moveToThread(m_sweepThread);
+    auto *sweepRow = new QHBoxLayout;
+    sweepRow->addWidget(m_btnStepSweep);
+    sweepRow->addWidget(m_btnStopSweep);
+    sweepRow->addWidget(m_btnSweepTiming);
+    sigLayout->addRow(sweepRow);
 
-    connect(m_sweepThread, &QThread::finished,
-            m_sweepWorker, &QObject::deleteLater);
-
-    connect(m_sweepWorker, &SGStepWorker::sweepFinished,
-            this,          &SGWidget::onSweepDone,
-            Qt::QueuedConnection);
-
-    m_sweepThread->start();
+    connect(m_btnStepSweep,   &QPushButton::clicked,
+            this, &SGWidget::onStepSweepClicked);
+    connect(m_btnStopSweep,   &QPushButton::clicked,
+            this, &SGWidget::onStopSweepClicked);
+    connect(m_btnSweepTiming, &QPushButton::clicked,
+            this, &SGWidget::onTimingReportClicked);
 
     signalGenGroup->setLayout(sigLayout);
     mainLayout->addWidget(signalGenGroup);
@@ -155,13 +143,23 @@ SGWidget::SGWidget(QWidget *parent)
     setLayout(mainLayout);
 }
 
-SGWidget::~SGWidget()
+// A running sweep ends with the I/O thread when the tool is destroyed
+SGWidget::~SGWidget() = default;
+
+void SGWidget::setTool(Rfmu2Tool *tool)
 {
-    if (m_sweepThread) {
-        m_sweepThread->quit();
-        m_sweepThread->wait();
-        m_sweepWorker = nullptr;
-    }
+    disconnect(m_stepConn);
+    disconnect(m_doneConn);
+    hardwareTool = tool;
+    if (!hardwareTool)
+        return;
+
+    // Emitted on the I/O thread, delivered queued
+    auto *scheduler = hardwareTool->sweepScheduler();
+    m_stepConn = connect(scheduler, &Rfmu2SweepScheduler::stepApplied,
+                         this, &SGWidget::onSweepStepApplied);
+    m_doneConn = connect(scheduler, &Rfmu2SweepScheduler::sweepFinished,
+                         this, &SGWidget::onSweepDone);
 }
 
 //----------------------------------------
@@ -181,8 +179,10 @@ void SGWidget::onSingleChannelClicked()
 
     logger::log(mLogArea, QString("[SignalGen] Configure single freq=%1 kHz, level=%2 dBm, path=%3").arg(freqKHz).arg(level).arg(path));
 
-    bool ok = hardwareTool->signalGenerator()
-                  ->configureSingleChannel(freqKHz, level, path);
+    auto sg = hardwareTool->signalGenerator();
+    bool ok = hardwareTool->call([sg, freqKHz, level, path] {
+        return sg->configureSingleChannel(freqKHz, level, path);
+    });
     if (!ok) {
         logger::log(mLogArea, QStringLiteral("Failed to configure single channel."));
     } else {
@@ -211,8 +211,10 @@ void SGWidget::onTwoChannelsClicked()
             .arg(f1KHz).arg(l1).arg(f2KHz).arg(l2).arg(path)
         );
 
-    bool ok = hardwareTool->signalGenerator()
-                  ->configureTwoChannels(f1KHz, l1, f2KHz, l2, path);
+    auto sg = hardwareTool->signalGenerator();
+    bool ok = hardwareTool->call([sg, f1KHz, l1, f2KHz, l2, path] {
+        return sg->configureTwoChannels(f1KHz, l1, f2KHz, l2, path);
+    });
     if (!ok) {
         logger::log(mLogArea, QStringLiteral("Failed to configure two channels."));
     } else {
@@ -232,7 +234,8 @@ void SGWidget::onStopAllOutputsClicked()
 
     logger::log(mLogArea, QStringLiteral("[SignalGen] Stopping ALL outputs."));
 
-    bool ok = hardwareTool->signalGenerator()->stopAllOutputs();
+    auto sg = hardwareTool->signalGenerator();
+    bool ok = hardwareTool->call([sg] { return sg->stopAllOutputs(); });
     if (!ok) {
         logger::log(mLogArea, QStringLiteral("Failed to stop all outputs."));
     } else {
@@ -252,7 +255,8 @@ void SGWidget::onStopSingleOutputClicked()
 
     logger::log(mLogArea, QStringLiteral("[SignalGen] Stopping SINGLE output."));
 
-    bool ok = hardwareTool->signalGenerator()->stopSingleOutput();
+    auto sg = hardwareTool->signalGenerator();
+    bool ok = hardwareTool->call([sg] { return sg->stopSingleOutput(); });
     if (!ok) {
         logger::log(mLogArea, QStringLiteral("Failed to stop single output."));
     } else {
@@ -262,24 +266,92 @@ void SGWidget::onStopSingleOutputClicked()
 
 void SGWidget::onStepSweepClicked()
 {
+    if (!hardwareTool) {
+        logger::log(mLogArea, QStringLiteral("SignalGenerator is null!"));
+        return;
+    }
+
     StepSweepDialog dlg(this);
     if (dlg.exec() != QDialog::Accepted)
         return;
 
-    /* hand the job to the worker -- one simple queued call ----------- */
-    QMetaObject::invokeMethod(m_sweepWorker, "runSweep",
-                              Qt::QueuedConnection,
-                              Q_ARG(double, dlg.startFreqGHz()),
-                              Q_ARG(double, dlg.stopFreqGHz()),
-                              Q_ARG(double, dlg.startLvlDbm()),
-                              Q_ARG(double, dlg.stopLvlDbm()),
-                              Q_ARG(int,    dlg.points()),
-                              Q_ARG(int,    dlg.intervalMs()),
-                              Q_ARG(QString,dlg.rfPath()));
+    /* frames are encoded and timed on the I/O thread ------------------ */
+    m_lastPlan = dlg.plan();
+    logger::log(mLogArea, tr("[SignalGen] Step-sweep: %1 steps (%2), path=%3")
+                              .arg(m_lastPlan.steps.size())
+                              .arg(dlg.isListMode() ? tr("list") : tr("linear"))
+                              .arg(m_lastPlan.rfPort));
+
+    m_btnStepSweep->setEnabled(false);
+    m_btnStopSweep->setEnabled(true);
+    hardwareTool->sweepScheduler()->start(m_lastPlan);
+}
+
+void SGWidget::onStopSweepClicked()
+{
+    if (hardwareTool)
+        hardwareTool->sweepScheduler()->stop();
+}
+
+void SGWidget::onSweepStepApplied(int index, int count, qint64 lateUs)
+{
+    m_btnStopSweep->setText(tr("Stop Sweep (%1/%2)").arg(index + 1).arg(count));
+    if (lateUs > 1000)
+        logger::log(mLogArea, tr("Step %1 sent %2 ms late.").arg(index).arg(lateUs / 1000.0, 0, 'f', 1));
+}
+
+void SGWidget::onSweepDone(const Rfmu2SweepReport &report)
+{
+    m_lastReport = report;
+    m_btnStepSweep->setEnabled(true);
+    m_btnStopSweep->setEnabled(false);
+    m_btnStopSweep->setText(tr("Stop Sweep"));
+    m_btnSweepTiming->setEnabled(!report.steps.isEmpty());
+
+    const QString timing = tr("%1/%2 steps, max late %3 ms, mean |error| %4 ms")
+                               .arg(report.steps.size()).arg(report.plannedSteps)
+                               .arg(report.maxLateUs() / 1000.0, 0, 'f', 2)
+                               .arg(report.meanAbsErrorUs() / 1000.0, 0, 'f', 2);
+    if (report.completed)
+        logger::log(mLogArea, tr("Step-sweep finished: %1.").arg(timing));
+    else
+        logger::log(mLogArea, tr("Step-sweep ended early (%1): %2.").arg(report.error, timing));
 }
 
-void SGWidget::onSweepDone()
+void SGWidget::onTimingReportClicked()
 {
-    logger::log(mLogArea, tr("Step-sweep finished."));
+    QDialog dlg(this);
+    dlg.setWindowTitle(tr("Step-Sweep Timing"));
+
+    auto *table = new QTableWidget(m_lastReport.steps.size(), 6, &dlg);
+    table->setHorizontalHeaderLabels({tr("Freq [kHz]"), tr("Level [dBm]"),
+                                      tr("Requested [ms]"), tr("Achieved [ms]"),
+                                      tr("Error [ms]"), tr("Echo")});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    for (int i = 0; i < m_lastReport.steps.size(); ++i) {
+        const Rfmu2SweepReport::Step &t = m_lastReport.steps[i];
+        const Rfmu2SweepPlan::Step s = m_lastPlan.steps.value(i);
+        const QStringList cells = {
+            QString::number(s.freqKHz),
+            QString::number(s.levelDbm, 'f', 1),
+            QString::number(t.requestedUs / 1000.0, 'f', 3),
+            QString::number(t.achievedUs / 1000.0, 'f', 3),
+            QString::number((t.achievedUs - t.requestedUs) / 1000.0, 'f', 3),
+            t.ok ? tr("ok") : tr("none")
+        };
+        for (int c = 0; c < cells.size(); ++c)
+            table->setItem(i, c, new QTableWidgetItem(cells[c]));
+    }
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dlg);
+    connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+
+    auto *lay = new QVBoxLayout(&dlg);
+    lay->addWidget(table);
+    lay->addWidget(buttons);
+    dlg.resize(640, 400);
+    dlg.exec();
 }
 
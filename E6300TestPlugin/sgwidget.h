@@ -4,12 +4,11 @@
 #include <QWidget>
 #include <QLineEdit>
 #include <QPushButton>
-#include <QTextBrowser>
 #include <QDoubleSpinBox>
 #include "include/rfmu2/rfmu2tool.h"
 #include "include/frequencyspinbox.h"
 #include "stepsweepdialog.h"
-#include "sgstepworker.h"
+#include "logview.h"
 
 class SGWidget : public QWidget
 {
@@ -18,9 +17,7 @@ public:
     explicit SGWidget(QWidget *parent = nullptr);
     ~SGWidget();
 
-    void setTool(Rfmu2Tool *tool) {
-        hardwareTool = tool;
-    }
+    void setTool(Rfmu2Tool *tool);
 
 private slots:
     void onSingleChannelClicked();
@@ -29,7 +26,10 @@ private slots:
     void onStopSingleOutputClicked();
 
     void onStepSweepClicked();
-    void onSweepDone();
+    void onStopSweepClicked();
+    void onSweepStepApplied(int index, int count, qint64 lateUs);
+    void onSweepDone(const Rfmu2SweepReport &report);
+    void onTimingReportClicked();
 
 private:
     Rfmu2Tool *hardwareTool;
@@ -47,12 +47,16 @@ private:
     QComboBox *mGenTwoPath;
 
     // Local log area for debugging feedback
-    QTextBrowser     *mLogArea;
+    LogView          *mLogArea;
 
     /* ---------- step-sweep infrastructure --------------- */
-    QPushButton *m_btnStepSweep {nullptr};
-    QThread     *m_sweepThread  {nullptr};
-    SGStepWorker*m_sweepWorker  {nullptr};
+    QPushButton *m_btnStepSweep   {nullptr};
+    QPushButton *m_btnStopSweep   {nullptr};
+    QPushButton *m_btnSweepTiming {nullptr};
+    QMetaObject::Connection m_stepConn;
+    QMetaObject::Connection m_doneConn;
+    Rfmu2SweepPlan   m_lastPlan;      // for the timing report
+    Rfmu2SweepReport m_lastReport;
 };
 
 #endif // SGWIDGET_H
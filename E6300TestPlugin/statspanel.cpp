@@ -0,0 +1,148 @@
+#include "statspanel.h"
+#include "renderscheduler.h"
+#include "include/rfmu2/rfmu2tool.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+static constexpr int RefreshIntervalMs = 1000;
+
+static QString formatUs(qint64 us)
+{
+    if (us >= 10000)
+        return QStringLiteral("%1 ms").arg(us / 1000.0, 0, 'f', 1);
+    return QStringLiteral("%1 us").arg(us);
+}
+
+static QString formatBytes(quint64 bytes)
+{
+    if (bytes >= 10ull * 1024 * 1024)
+        return QStringLiteral("%1 MiB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    if (bytes >= 10ull * 1024)
+        return QStringLiteral("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    return QStringLiteral("%1 B").arg(bytes);
+}
+
+static QTableWidget *makeTable(const QStringList &headers, QWidget *parent)
+{
+    auto *table = new QTableWidget(0, headers.size(), parent);
+    table->setHorizontalHeaderLabels(headers);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    return table;
+}
+
+static void setRow(QTableWidget *table, int row, const QStringList &cells)
+{
+    for (int col = 0; col < cells.size(); ++col) {
+        QTableWidgetItem *item = table->item(row, col);
+        if (!item) {
+            item = new QTableWidgetItem;
+            item->setTextAlignment(col == 0 ? int(Qt::AlignLeft | Qt::AlignVCenter)
+                                            : int(Qt::AlignRight | Qt::AlignVCenter));
+            table->setItem(row, col, item);
+        }
+        item->setText(cells[col]);
+    }
+}
+
+StatsPanel::StatsPanel(Rfmu2Tool *tool, QWidget *parent)
+    : QWidget(parent),
+    m_tool(tool),
+    m_timer(new QTimer(this))
+{
+    auto *layout = new QVBoxLayout(this);
+
+    m_rates = new QLabel(this);
+    m_totals = new QLabel(this);
+    m_totals->setWordWrap(true);
+    layout->addWidget(m_rates);
+    layout->addWidget(m_totals);
+
+    layout->addWidget(new QLabel(tr("Round trip per command"), this));
+    m_commandTable = makeTable({ tr("Command"), tr("Count"), tr("Mean"), tr("p50"),
+                                 tr("p90"), tr("p99"), tr("Max") }, this);
+    layout->addWidget(m_commandTable, 2);
+
+    layout->addWidget(new QLabel(tr("Plots"), this));
+    m_plotTable = makeTable({ tr("Plot"), tr("Sweeps"), tr("Superseded"), tr("Discarded"),
+                              tr("Replot p50 / p99"), tr("Sweep to screen p50 / p99") }, this);
+    layout->addWidget(m_plotTable, 1);
+
+    m_timer->setInterval(RefreshIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &StatsPanel::refresh);
+}
+
+void StatsPanel::addPlot(const QString &name, const RenderScheduler *plot)
+{
+    if (plot)
+        m_plots.append({ name, plot });
+}
+
+void StatsPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_timer->start();
+}
+
+void StatsPanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer->stop();
+}
+
+void StatsPanel::refresh()
+{
+    if (!m_tool)
+        return;
+
+    const Rfmu2Metrics &metrics = m_tool->metrics();
+    const Rfmu2Metrics::Counters now = metrics.counters();
+
+    // Rates over the last refresh; the first one covers the whole uptime
+    const double seconds = qMax<qint64>(1, now.uptimeMs - m_previous.uptimeMs) / 1000.0;
+    m_rates->setText(tr("%1 commands/s   in %2/s   out %3/s")
+                         .arg((now.commands - m_previous.commands) / seconds, 0, 'f', 1)
+                         .arg(formatBytes(quint64((now.bytesIn - m_previous.bytesIn) / seconds)))
+                         .arg(formatBytes(quint64((now.bytesOut - m_previous.bytesOut) / seconds))));
+    m_previous = now;
+
+    m_totals->setText(tr("Commands %1, frames %2, in %3, out %4 | resyncs %5 (%6 skipped), "
+                         "stale %7, timeouts %8, retries %9")
+                          .arg(now.commands)
+                          .arg(now.framesParsed)
+                          .arg(formatBytes(now.bytesIn))
+                          .arg(formatBytes(now.bytesOut))
+                          .arg(now.resyncs)
+                          .arg(formatBytes(now.resyncBytes))
+                          .arg(formatBytes(now.staleBytes))
+                          .arg(now.timeouts)
+                          .arg(now.retries));
+
+    const QVector<Rfmu2Metrics::CommandStats> commands = metrics.commandStats();
+    m_commandTable->setRowCount(commands.size());
+    for (int row = 0; row < commands.size(); ++row) {
+        const Rfmu2Histogram::Summary &rtt = commands[row].rtt;
+        setRow(m_commandTable, row, { commands[row].name, QString::number(rtt.count),
+                                      formatUs(qint64(rtt.meanUs)), formatUs(rtt.p50Us),
+                                      formatUs(rtt.p90Us), formatUs(rtt.p99Us),
+                                      formatUs(rtt.maxUs) });
+    }
+
+    m_plotTable->setRowCount(m_plots.size());
+    for (int row = 0; row < m_plots.size(); ++row) {
+        const RenderScheduler::Stats s = m_plots[row].second->stats();
+        setRow(m_plotTable, row, { m_plots[row].first, QString::number(s.sweeps),
+                                   QString::number(s.superseded), QString::number(s.discarded),
+                                   formatUs(s.replot.p50Us) + QStringLiteral(" / ") + formatUs(s.replot.p99Us),
+                                   formatUs(s.sweepToScreen.p50Us) + QStringLiteral(" / ")
+                                       + formatUs(s.sweepToScreen.p99Us) });
+    }
+}
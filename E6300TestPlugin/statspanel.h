@@ -0,0 +1,46 @@
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QPointer>
+#include <QVector>
+#include <QWidget>
+#include "include/rfmu2/rfmu2metrics.h"
+
+class QLabel;
+class QTableWidget;
+class QTimer;
+class RenderScheduler;
+class Rfmu2Tool;
+
+// Live view of the transport metrics and the plot pipelines: rates over the
+// last refresh, totals, per-command round trips and per-plot replot and
+// sweep-to-screen times. It only refreshes while it is visible.
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit StatsPanel(Rfmu2Tool *tool, QWidget *parent = nullptr);
+
+    void addPlot(const QString &name, const RenderScheduler *plot);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QPointer<Rfmu2Tool> m_tool;
+    QVector<QPair<QString, const RenderScheduler *>> m_plots;
+
+    QTimer       *m_timer;
+    QLabel       *m_rates;
+    QLabel       *m_totals;
+    QTableWidget *m_commandTable;
+    QTableWidget *m_plotTable;
+
+    Rfmu2Metrics::Counters m_previous;   // for the rates
+};
+
+#endif // STATSPANEL_H
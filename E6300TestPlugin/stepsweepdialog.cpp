@@ -6,6 +6,14 @@
 #include <QDialogButtonBox>
 #include <QPushButton>
 #include <QMessageBox>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QRegularExpression>
 
 StepSweepDialog::StepSweepDialog(QWidget *parent)
     : QDialog(parent)
@@ -51,19 +59,64 @@ StepSweepDialog::StepSweepDialog(QWidget *parent)
     }
     m_rfPath->addItems(paths);
 
+    m_mode = new QComboBox(this);
+    m_mode->addItem(tr("Linear"));
+    m_mode->addItem(tr("List"));
+
+    /* linear ramp ------------------------------------------------------- */
+    m_linearPage = new QWidget(this);
+    auto *linLay = new QFormLayout(m_linearPage);
+    linLay->setContentsMargins(0, 0, 0, 0);
+    linLay->addRow(tr("Start Freq [GHz]:"),  m_startFreq);
+    linLay->addRow(tr("Stop Freq [GHz]:"),   m_stopFreq);
+    linLay->addRow(tr("Start Level [dBm]:"), m_startLvl);
+    linLay->addRow(tr("Stop Level [dBm]:"),  m_stopLvl);
+    linLay->addRow(tr("Points:"),            m_points);
+
+    /* list: one row per step; an empty dwell uses the send interval ----- */
+    m_listPage = new QWidget(this);
+    auto *listLay = new QVBoxLayout(m_listPage);
+    listLay->setContentsMargins(0, 0, 0, 0);
+    m_list = new QTableWidget(0, 3, m_listPage);
+    m_list->setHorizontalHeaderLabels({tr("Freq [GHz]"), tr("Level [dBm]"), tr("Dwell [ms]")});
+    m_list->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_list->setMinimumHeight(200);
+    listLay->addWidget(m_list);
+
+    auto *listBtns  = new QHBoxLayout;
+    auto *btnAdd    = new QPushButton(tr("Add Row"), m_listPage);
+    auto *btnRemove = new QPushButton(tr("Remove Row"), m_listPage);
+    auto *btnLoad   = new QPushButton(tr("Load CSV..."), m_listPage);
+    listBtns->addWidget(btnAdd);
+    listBtns->addWidget(btnRemove);
+    listBtns->addStretch(1);
+    listBtns->addWidget(btnLoad);
+    listLay->addLayout(listBtns);
+
+    connect(btnAdd, &QPushButton::clicked, this, [this] {
+        m_list->insertRow(m_list->rowCount());
+    });
+    connect(btnRemove, &QPushButton::clicked, this, [this] {
+        const int row = m_list->currentRow();
+        m_list->removeRow(row >= 0 ? row : m_list->rowCount() - 1);
+    });
+    connect(btnLoad, &QPushButton::clicked, this, &StepSweepDialog::onLoadListClicked);
+
     auto *lay  = new QFormLayout(this);
-    lay->addRow(tr("Start Freq [GHz]:"),  m_startFreq);
-    lay->addRow(tr("Stop Freq [GHz]:"),   m_stopFreq);
-    lay->addRow(tr("Start Level [dBm]:"), m_startLvl);
-    lay->addRow(tr("Stop Level [dBm]:"),  m_stopLvl);
-    lay->addRow(tr("Points:"),                      m_points);
+    lay->addRow(tr("Mode:"),              m_mode);
+    lay->addRow(m_linearPage);
+    lay->addRow(m_listPage);
     lay->addRow(tr("Send Interval [ms]:"),m_interval);
-    lay->addRow(tr("RF Path:"),                m_rfPath);
+    lay->addRow(tr("RF Path:"),           m_rfPath);
 
     m_buttons = new QDialogButtonBox(QDialogButtonBox::Ok
                                          | QDialogButtonBox::Cancel, this);
     lay->addWidget(m_buttons);
 
+    connect(m_mode, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &StepSweepDialog::onModeChanged);
+    onModeChanged(m_mode->currentIndex());
+
     connect(m_buttons, &QDialogButtonBox::accepted,
             this, &StepSweepDialog::validateInputs);
     connect(m_buttons, &QDialogButtonBox::rejected,
@@ -73,6 +126,26 @@ StepSweepDialog::StepSweepDialog(QWidget *parent)
 /* ---------- live validation & final acceptance ------------------------ */
 void StepSweepDialog::validateInputs()
 {
+    if (isListMode()) {
+        if (m_list->rowCount() == 0) {
+            QMessageBox::warning(this, tr("Empty list"),
+                                 tr("Add at least one step to the list."));
+            return;
+        }
+        for (int row = 0; row < m_list->rowCount(); ++row) {
+            Rfmu2SweepPlan::Step step;
+            if (!readListRow(row, step)) {
+                QMessageBox::warning(this, tr("Invalid step"),
+                                     tr("Row %1: frequency must be 0.1-6 GHz, level -100-10 dBm "
+                                        "and dwell a non-negative number of ms.").arg(row + 1));
+                m_list->setCurrentCell(row, 0);
+                return;
+            }
+        }
+        accept();
+        return;
+    }
+
     const bool freqDiff = qFuzzyCompare(startFreqGHz(), stopFreqGHz()) == false;
     const bool lvlDiff  = qFuzzyCompare(startLvlDbm(),  stopLvlDbm())  == false;
 
@@ -127,3 +200,85 @@ double StepSweepDialog::stopLvlDbm()   const { return m_stopLvl->value();   }
 int    StepSweepDialog::points()       const { return m_points->value();    }
 int    StepSweepDialog::intervalMs()   const { return m_interval->value();  }
 QString StepSweepDialog::rfPath()      const { return m_rfPath->currentText();     }
+bool   StepSweepDialog::isListMode()   const { return m_mode->currentIndex() == 1; }
+
+/* ---------- list mode ------------------------------------------------- */
+void StepSweepDialog::onModeChanged(int index)
+{
+    m_linearPage->setVisible(index == 0);
+    m_listPage->setVisible(index == 1);
+    adjustSize();
+}
+
+void StepSweepDialog::onLoadListClicked()
+{
+    const QString path = QFileDialog::getOpenFileName(this, tr("Load Step List"), QString(),
+                                                      tr("CSV Files (*.csv);;All Files (*)"));
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, tr("Load failed"), file.errorString());
+        return;
+    }
+
+    // freq [GHz], level [dBm] [, dwell ms] per line; '#' comments and a header are skipped
+    m_list->setRowCount(0);
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+        const QStringList cols = line.split(QRegularExpression("[,;\\t]"));
+        bool numeric = false;
+        cols.value(0).trimmed().toDouble(&numeric);
+        if (!numeric || cols.size() < 2)
+            continue;
+
+        const int row = m_list->rowCount();
+        m_list->insertRow(row);
+        for (int c = 0; c < 3 && c < cols.size(); ++c)
+            m_list->setItem(row, c, new QTableWidgetItem(cols[c].trimmed()));
+    }
+}
+
+bool StepSweepDialog::readListRow(int row, Rfmu2SweepPlan::Step &step) const
+{
+    auto text = [this, row](int col) {
+        const QTableWidgetItem *item = m_list->item(row, col);
+        return item ? item->text().trimmed() : QString();
+    };
+
+    bool okF = false, okL = false, okD = true;
+    const double freqGHz = text(0).toDouble(&okF);
+    const double lvlDbm  = text(1).toDouble(&okL);
+    const QString dwell  = text(2);
+    const int dwellMs    = dwell.isEmpty() ? intervalMs() : dwell.toInt(&okD);
+
+    if (!okF || !okL || !okD || freqGHz < 0.1 || freqGHz > 6.0
+        || lvlDbm < -100.0 || lvlDbm > 10.0 || dwellMs < 0)
+        return false;
+
+    step.freqKHz  = static_cast<int>(qRound64(freqGHz * 1e6));
+    step.levelDbm = lvlDbm;
+    step.dwellMs  = dwellMs;
+    return true;
+}
+
+Rfmu2SweepPlan StepSweepDialog::plan() const
+{
+    if (!isListMode())
+        return Rfmu2SweepPlan::linear(startFreqGHz() * 1e9, stopFreqGHz() * 1e9,
+                                      startLvlDbm(), stopLvlDbm(),
+                                      points(), intervalMs(), rfPath());
+
+    Rfmu2SweepPlan p;
+    p.rfPort = rfPath();
+    for (int row = 0; row < m_list->rowCount(); ++row) {
+        Rfmu2SweepPlan::Step step;
+        if (readListRow(row, step))
+            p.steps.append(step);
+    }
+    return p;
+}
@@ -1,11 +1,14 @@
 #pragma once
 #include <QDialog>
 #include <QComboBox>
+#include "include/rfmu2/rfmu2sweepscheduler.h"
 
 class QDoubleSpinBox;
 class QSpinBox;
 class QLineEdit;
 class QDialogButtonBox;
+class QTableWidget;
+class QWidget;
 
 class StepSweepDialog : public QDialog
 {
@@ -20,15 +23,28 @@ public:
     int    points()       const;
     int    intervalMs()   const;
     QString rfPath()      const;
+    bool   isListMode()   const;
+
+    // Linear ramp or the list table, ready for Rfmu2SweepScheduler
+    Rfmu2SweepPlan plan() const;
 
 private slots:
     void validateInputs();           // live validation
+    void onModeChanged(int index);
+    void onLoadListClicked();
 
 private:
+    bool readListRow(int row, Rfmu2SweepPlan::Step &step) const;
+
+    QComboBox      *m_mode;
+    QWidget        *m_linearPage;
+    QWidget        *m_listPage;
+    QTableWidget   *m_list;
+
     QDoubleSpinBox *m_startFreq, *m_stopFreq;
     QDoubleSpinBox *m_startLvl,  *m_stopLvl;
     QSpinBox       *m_points;
-    QSpinBox       *m_interval;
+    QSpinBox       *m_interval;     // linear step interval, default dwell in list mode
     QComboBox      *m_rfPath;
     QDialogButtonBox *m_buttons;
 };
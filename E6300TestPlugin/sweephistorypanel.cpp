@@ -0,0 +1,171 @@
+#include "sweephistorypanel.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSlider>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QVBoxLayout>
+
+SweepHistoryPanel::SweepHistoryPanel(const QString &fileName, int capacity, int maxChannels, int maxPoints,
+                                     QWidget *parent)
+    : QWidget(parent),
+    m_replayTimer(new QTimer(this))
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    QHBoxLayout *controls = new QHBoxLayout;
+    // Off until asked for: recording writes every sweep to disk
+    m_recordBox = new QCheckBox(tr("Record"), this);
+    controls->addWidget(m_recordBox);
+
+    m_playButton = new QPushButton(tr("Replay"), this);
+    m_playButton->setCheckable(true);
+    connect(m_playButton, &QPushButton::toggled, this, &SweepHistoryPanel::onPlayToggled);
+    controls->addWidget(m_playButton);
+
+    m_speedBox = new QComboBox(this);
+    m_speedBox->addItem("0.5x", 0.5);
+    m_speedBox->addItem("1x", 1.0);
+    m_speedBox->addItem("2x", 2.0);
+    m_speedBox->addItem("4x", 4.0);
+    m_speedBox->addItem("16x", 16.0);
+    m_speedBox->setCurrentIndex(1);
+    controls->addWidget(m_speedBox);
+
+    QPushButton *clearButton = new QPushButton(tr("Clear"), this);
+    connect(clearButton, &QPushButton::clicked, this, &SweepHistoryPanel::onClearClicked);
+    controls->addWidget(clearButton);
+    controls->addStretch();
+    layout->addLayout(controls);
+
+    m_slider = new QSlider(Qt::Horizontal, this);
+    connect(m_slider, &QSlider::valueChanged, this, &SweepHistoryPanel::onPositionChanged);
+    layout->addWidget(m_slider);
+
+    m_positionLabel = new QLabel(this);
+    layout->addWidget(m_positionLabel);
+    layout->addStretch();
+
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &SweepHistoryPanel::onReplayTick);
+
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                         + QStringLiteral("/history/") + fileName;
+    if (!m_history.open(path, capacity, maxChannels, maxPoints)) {
+        m_recordBox->setChecked(false);
+        m_recordBox->setEnabled(false);
+        m_positionLabel->setText(tr("History unavailable: %1").arg(m_history.errorString()));
+    }
+    updateRange(true);
+}
+
+bool SweepHistoryPanel::isRecording() const
+{
+    return m_history.isOpen() && m_recordBox->isChecked();
+}
+
+void SweepHistoryPanel::record(const QByteArray &config, const QVector<double> &keys,
+                               const QVector<QVector<double>> &channels)
+{
+    const bool followLatest = m_slider->value() == m_slider->maximum();
+    if (!m_history.append(QDateTime::currentMSecsSinceEpoch(), config, keys, channels)) {
+        m_positionLabel->setText(tr("Recording failed: %1").arg(m_history.errorString()));
+        return;
+    }
+    updateRange(followLatest && !m_replayTimer->isActive());
+}
+
+void SweepHistoryPanel::updateRange(bool followLatest)
+{
+    const int count = m_history.size();
+
+    // Index 0 is always the oldest retained sweep, so once the ring wraps the
+    // sweep under the slider moves one step back per new recording.
+    const bool wasBlocked = m_slider->blockSignals(true);
+    m_slider->setRange(0, qMax(0, count - 1));
+    if (followLatest)
+        m_slider->setValue(m_slider->maximum());
+    m_slider->blockSignals(wasBlocked);
+
+    if (count == 0) {
+        if (m_history.isOpen())
+            m_positionLabel->setText(tr("No sweeps recorded"));
+    } else if (followLatest) {
+        m_positionLabel->setText(tr("Live - %1 sweeps recorded").arg(count));
+    }
+}
+
+void SweepHistoryPanel::updatePositionLabel(const Rfmu2SweepHistory::Sweep &sweep)
+{
+    m_positionLabel->setText(tr("Sweep %1 of %2  |  %3  |  %4")
+                                 .arg(m_slider->value() + 1)
+                                 .arg(m_history.size())
+                                 .arg(QDateTime::fromMSecsSinceEpoch(sweep.timestampMs)
+                                          .toString("yyyy-MM-dd HH:mm:ss.zzz"))
+                                 .arg(QString::fromUtf8(sweep.config)));
+}
+
+void SweepHistoryPanel::onPositionChanged(int index)
+{
+    Rfmu2SweepHistory::Sweep sweep;
+    if (!m_history.sweepAt(index, sweep))
+        return;
+    updatePositionLabel(sweep);
+    emit sweepSelected(sweep);
+}
+
+void SweepHistoryPanel::onPlayToggled(bool playing)
+{
+    if (!playing) {
+        m_replayTimer->stop();
+        m_playButton->setText(tr("Replay"));
+        return;
+    }
+
+    if (m_history.size() == 0) {
+        m_playButton->setChecked(false);
+        return;
+    }
+
+    // Replaying from the live end makes no sense; start from the oldest sweep.
+    m_playButton->setText(tr("Pause"));
+    if (m_slider->value() >= m_slider->maximum())
+        m_slider->setValue(0);
+    else
+        onPositionChanged(m_slider->value());
+    m_replayTimer->start(0);
+}
+
+void SweepHistoryPanel::onReplayTick()
+{
+    const int current = m_slider->value();
+    const int next = current + 1;
+    if (next >= m_history.size()) {
+        m_playButton->setChecked(false);
+        return;
+    }
+
+    m_slider->setValue(next);
+
+    // Wait as long as the sweeps were apart when recorded, scaled by speed.
+    const int following = next + 1;
+    if (following < m_history.size()) {
+        const qint64 gapMs = m_history.steadyAt(following) - m_history.steadyAt(next);
+        const double speed = m_speedBox->currentData().toDouble();
+        m_replayTimer->start(int(qBound<qint64>(1, qint64(gapMs / speed), 5000)));
+    } else {
+        m_playButton->setChecked(false);
+    }
+}
+
+void SweepHistoryPanel::onClearClicked()
+{
+    m_playButton->setChecked(false);
+    m_history.clear();
+    updateRange(true);
+}
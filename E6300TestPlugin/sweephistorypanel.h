@@ -0,0 +1,50 @@
+#ifndef SWEEPHISTORYPANEL_H
+#define SWEEPHISTORYPANEL_H
+
+#include <QWidget>
+#include "include/rfmu2/rfmu2sweephistory.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QPushButton;
+class QSlider;
+class QTimer;
+
+// Tab page that, once Record is ticked, records every acquired sweep into a
+// memory-mapped ring and lets the user scrub back through it or replay it
+// at the recorded pace.
+class SweepHistoryPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    SweepHistoryPanel(const QString &fileName, int capacity, int maxChannels, int maxPoints,
+                      QWidget *parent = nullptr);
+
+    bool isRecording() const;
+    void record(const QByteArray &config, const QVector<double> &keys,
+                const QVector<QVector<double>> &channels);
+
+signals:
+    void sweepSelected(const Rfmu2SweepHistory::Sweep &sweep);
+
+private slots:
+    void onPositionChanged(int index);
+    void onPlayToggled(bool playing);
+    void onReplayTick();
+    void onClearClicked();
+
+private:
+    void updateRange(bool followLatest);
+    void updatePositionLabel(const Rfmu2SweepHistory::Sweep &sweep);
+
+    Rfmu2SweepHistory m_history;
+    QCheckBox   *m_recordBox {};
+    QSlider     *m_slider {};
+    QLabel      *m_positionLabel {};
+    QPushButton *m_playButton {};
+    QComboBox   *m_speedBox {};
+    QTimer      *m_replayTimer {};
+};
+
+#endif // SWEEPHISTORYPANEL_H
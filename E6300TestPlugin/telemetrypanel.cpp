@@ -0,0 +1,148 @@
+#include "telemetrypanel.h"
+#include "include/qcustomplot.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QSpinBox>
+#include <QTime>
+#include <QVBoxLayout>
+
+static constexpr int VoltageChannels = 8;
+static constexpr int TemperatureChannel = 8;
+
+TelemetryPanel::TelemetryPanel(Rfmu2TelemetryPoller *poller, QWidget *parent)
+    : QWidget(parent),
+    m_poller(poller)
+{
+    auto *layout = new QVBoxLayout(this);
+
+    auto *controls = new QHBoxLayout;
+    m_pollBox = new QCheckBox(tr("Poll every"), this);
+    m_pollBox->setChecked(m_poller->isRunning());
+    controls->addWidget(m_pollBox);
+
+    m_intervalBox = new QSpinBox(this);
+    m_intervalBox->setRange(1, 3600);
+    m_intervalBox->setSuffix(tr(" s"));
+    m_intervalBox->setValue(qMax(1, m_poller->intervalMs() / 1000));
+    controls->addWidget(m_intervalBox);
+
+    controls->addSpacing(16);
+    controls->addWidget(new QLabel(tr("Show last"), this));
+    m_spanBox = new QComboBox(this);
+    const struct { const char *label; qint64 ms; } spans[] = {
+        { QT_TR_NOOP("10 minutes"), 10 * 60 * 1000ll },
+        { QT_TR_NOOP("1 hour"),     60 * 60 * 1000ll },
+        { QT_TR_NOOP("6 hours"),    6 * 60 * 60 * 1000ll },
+        { QT_TR_NOOP("24 hours"),   24 * 60 * 60 * 1000ll },
+        { QT_TR_NOOP("7 days"),     7 * 24 * 60 * 60 * 1000ll },
+        { QT_TR_NOOP("31 days"),    31 * 24 * 60 * 60 * 1000ll },
+    };
+    for (const auto &s : spans)
+        m_spanBox->addItem(tr(s.label), s.ms);
+    m_spanBox->setCurrentIndex(1);
+    controls->addWidget(m_spanBox);
+    controls->addStretch();
+    layout->addLayout(controls);
+
+    m_latestLabel = new QLabel(tr("No reading yet"), this);
+    m_latestLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_latestLabel);
+
+    m_plot = new QCustomPlot(this);
+    m_plot->setMinimumHeight(180);
+    QSharedPointer<QCPAxisTickerDateTime> ticker(new QCPAxisTickerDateTime);
+    ticker->setDateTimeFormat(QStringLiteral("MM-dd\nHH:mm:ss"));
+    m_plot->xAxis->setTicker(ticker);
+    m_plot->yAxis->setLabel(tr("Voltage (V)"));
+    m_plot->yAxis2->setLabel(tr("Temperature (C)"));
+    m_plot->yAxis2->setVisible(true);
+    m_plot->legend->setVisible(true);
+    m_plot->legend->setFont(QFont(font().family(), 8));
+    m_plot->axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignLeft);
+
+    for (int ch = 0; ch < VoltageChannels; ++ch) {
+        QCPGraph *g = m_plot->addGraph(m_plot->xAxis, m_plot->yAxis);
+        g->setName(QStringLiteral("V%1").arg(ch + 1));
+        g->setPen(QPen(QColor::fromHsv(ch * 300 / VoltageChannels, 200, 200)));
+    }
+    QCPGraph *temp = m_plot->addGraph(m_plot->xAxis, m_plot->yAxis2);
+    temp->setName(tr("Temp"));
+    temp->setPen(QPen(Qt::red, 2));
+    layout->addWidget(m_plot, 1);
+
+    connect(m_pollBox, &QCheckBox::toggled, this, [this](bool on) {
+        if (on)
+            m_poller->start();
+        else
+            m_poller->stop();
+    });
+    connect(m_intervalBox, qOverload<int>(&QSpinBox::valueChanged), this, [this](int s) {
+        m_poller->setIntervalMs(s * 1000);
+    });
+    connect(m_spanBox, qOverload<int>(&QComboBox::currentIndexChanged), this, &TelemetryPanel::refreshPlot);
+    connect(m_poller, &Rfmu2TelemetryPoller::sampled, this, &TelemetryPanel::onSampled);
+    connect(m_poller, &Rfmu2TelemetryPoller::pollFailed, this, &TelemetryPanel::onPollFailed);
+
+    if (!m_poller->log().latest().isEmpty())
+        updateLatest(m_poller->log().latest());
+}
+
+void TelemetryPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refreshPlot();
+}
+
+void TelemetryPanel::onSampled(qint64, const QVector<double> &values)
+{
+    updateLatest(values);
+    if (isVisible())
+        refreshPlot();
+}
+
+void TelemetryPanel::onPollFailed()
+{
+    m_latestLabel->setText(tr("Telemetry read failed (%1 so far)").arg(m_poller->failures()));
+}
+
+void TelemetryPanel::updateLatest(const QVector<double> &values)
+{
+    if (values.size() <= TemperatureChannel)
+        return;
+    QStringList parts;
+    for (int ch = 0; ch < VoltageChannels; ++ch)
+        parts.append(QStringLiteral("V%1 %2").arg(ch + 1).arg(values[ch], 0, 'f', 3));
+    m_latestLabel->setText(tr("%1   |   %2 C   (%3)")
+                               .arg(parts.join(QStringLiteral("  ")))
+                               .arg(values[TemperatureChannel], 0, 'f', 2)
+                               .arg(QTime::currentTime().toString(QStringLiteral("HH:mm:ss"))));
+}
+
+void TelemetryPanel::refreshPlot()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 from = now - m_spanBox->currentData().toLongLong();
+    const Rfmu2TelemetryLog &log = m_poller->log();
+
+    for (int ch = 0; ch <= TemperatureChannel; ++ch) {
+        const QVector<Rfmu2TelemetryLog::Point> points = log.series(ch, from, now);
+        QVector<double> keys, values;
+        keys.reserve(points.size());
+        values.reserve(points.size());
+        for (const auto &p : points) {
+            keys.append(p.ms / 1000.0);
+            values.append(p.mean);
+        }
+        m_plot->graph(ch)->setData(keys, values, true);
+    }
+
+    m_plot->xAxis->setRange(from / 1000.0, now / 1000.0);
+    for (int ch = 0; ch < VoltageChannels; ++ch)
+        m_plot->graph(ch)->rescaleValueAxis(ch > 0, true);
+    m_plot->graph(TemperatureChannel)->rescaleValueAxis(false, true);
+    m_plot->replot(QCustomPlot::rpQueuedReplot);
+}
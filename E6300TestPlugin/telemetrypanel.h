@@ -0,0 +1,42 @@
+#ifndef TELEMETRYPANEL_H
+#define TELEMETRYPANEL_H
+
+#include <QWidget>
+#include "include/rfmu2/rfmu2telemetrypoller.h"
+
+class QCheckBox;
+class QComboBox;
+class QCustomPlot;
+class QLabel;
+class QSpinBox;
+
+// Supply voltages and temperature over time, from the background poller's
+// log: the span picks how far back to look, and the log answers from the
+// matching resolution (raw samples, minute or quarter-hour means).
+class TelemetryPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit TelemetryPanel(Rfmu2TelemetryPoller *poller, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void onSampled(qint64 ms, const QVector<double> &values);
+    void onPollFailed();
+    void refreshPlot();
+
+private:
+    void updateLatest(const QVector<double> &values);
+
+    Rfmu2TelemetryPoller *m_poller;
+
+    QCheckBox   *m_pollBox;
+    QSpinBox    *m_intervalBox;
+    QComboBox   *m_spanBox;
+    QLabel      *m_latestLabel;
+    QCustomPlot *m_plot;
+};
+
+#endif // TELEMETRYPANEL_H
@@ -0,0 +1,161 @@
+#include "tracedecimator.h"
+#include <algorithm>
+
+TraceDecimator::TraceDecimator(QCustomPlot *plot, QObject *parent)
+    : QObject(parent),
+    m_plot(plot)
+{
+    // afterLayout fires inside replot(), once axis rects know their final
+    // pixel size and before anything is drawn.
+    connect(m_plot, &QCustomPlot::afterLayout, this, &TraceDecimator::onAfterLayout);
+}
+
+void TraceDecimator::setGraphData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values)
+{
+    if (!graph)
+        return;
+
+    if (!m_sources.contains(graph)) {
+        connect(graph, &QObject::destroyed, this, [this, graph]() {
+            m_sources.remove(graph);
+        });
+    }
+
+    Source &src = m_sources[graph];
+    src.keys = keys;
+    src.values = values;
+    push(graph, src);
+}
+
+void TraceDecimator::clearGraphData(QCPGraph *graph)
+{
+    setGraphData(graph, QVector<double>(), QVector<double>());
+}
+
+void TraceDecimator::decimateMinMax(const QVector<double> &keys, const QVector<double> &values,
+                                    double lower, double upper, int columns,
+                                    QVector<double> &outKeys, QVector<double> &outValues)
+{
+    outKeys.clear();
+    outValues.clear();
+
+    const int n = qMin(keys.size(), values.size());
+    if (n == 0)
+        return;
+
+    const auto keysBegin = keys.constBegin();
+    const int first = int(std::lower_bound(keysBegin, keysBegin + n, lower) - keysBegin);
+    const int last  = int(std::upper_bound(keysBegin, keysBegin + n, upper) - keysBegin); // exclusive
+    const int begin = qMax(0, first - 1);
+    const int end   = qMin(n, last + 1);
+
+    auto emitPoint = [&](int idx) {
+        outKeys.append(keys[idx]);
+        outValues.append(values[idx]);
+    };
+
+    // Nothing to gain below two points per column: hand over the visible slice as is.
+    if (columns <= 0 || upper <= lower || end - begin <= 2 * columns) {
+        for (int i = begin; i < end; ++i)
+            emitPoint(i);
+        return;
+    }
+
+    outKeys.reserve(2 * columns + 2);
+    outValues.reserve(2 * columns + 2);
+
+    if (first > 0)
+        emitPoint(first - 1);
+
+    const double columnWidth = (upper - lower) / columns;
+    int i = first;
+    while (i < last) {
+        const int column = qBound(0, int((keys[i] - lower) / columnWidth), columns - 1);
+        const double columnEnd = (column == columns - 1) ? upper : lower + (column + 1) * columnWidth;
+
+        int minIdx = i;
+        int maxIdx = i;
+        int j = i + 1;
+        for (; j < last && keys[j] < columnEnd; ++j) {
+            if (values[j] < values[minIdx]) minIdx = j;
+            if (values[j] > values[maxIdx]) maxIdx = j;
+        }
+        if (column == columns - 1)
+            j = last; // the rightmost column also takes the point sitting exactly on upper
+
+        // Emit in key order so the connecting line stays monotonic.
+        if (minIdx == maxIdx) {
+            emitPoint(minIdx);
+        } else {
+            emitPoint(qMin(minIdx, maxIdx));
+            emitPoint(qMax(minIdx, maxIdx));
+        }
+        i = j;
+    }
+
+    if (last < n)
+        emitPoint(last);
+}
+
+void TraceDecimator::push(QCPGraph *graph, Source &src)
+{
+    QCPAxis *keyAxis = graph->keyAxis();
+    if (!keyAxis || !keyAxis->axisRect()) {
+        graph->setData(src.keys, src.values);
+        return;
+    }
+
+    src.range = keyAxis->range();
+    src.columns = (keyAxis->orientation() == Qt::Horizontal) ? keyAxis->axisRect()->width()
+                                                             : keyAxis->axisRect()->height();
+
+    // Level sweeps may run high-to-low; leave those to QCustomPlot's own sort.
+    if (!std::is_sorted(src.keys.constBegin(), src.keys.constEnd())) {
+        graph->setData(src.keys, src.values);
+        return;
+    }
+
+    decimateMinMax(src.keys, src.values, src.range.lower, src.range.upper, src.columns,
+                   src.plotKeys, src.plotValues);
+    assignSorted(graph->data().data(), src.plotKeys, src.plotValues);
+}
+
+void TraceDecimator::assignSorted(QCPGraphDataContainer *container,
+                                  const QVector<double> &keys, const QVector<double> &values)
+{
+    const int n = qMin(keys.size(), values.size());
+
+    // Same point count as last time (the common case for a running sweep):
+    // rewrite the existing points where they are. Keys are ascending, so the
+    // container stays sorted and QCustomPlot never re-sorts or reallocates.
+    if (container->size() == n) {
+        auto it = container->begin();
+        for (int i = 0; i < n; ++i, ++it) {
+            it->key = keys[i];
+            it->value = values[i];
+        }
+        return;
+    }
+
+    QVector<QCPGraphData> points(n);
+    for (int i = 0; i < n; ++i) {
+        points[i].key = keys[i];
+        points[i].value = values[i];
+    }
+    container->set(points, true);
+}
+
+void TraceDecimator::onAfterLayout()
+{
+    for (auto it = m_sources.begin(); it != m_sources.end(); ++it) {
+        QCPGraph *graph = it.key();
+        QCPAxis *keyAxis = graph->keyAxis();
+        if (!keyAxis || !keyAxis->axisRect())
+            continue;
+
+        const int columns = (keyAxis->orientation() == Qt::Horizontal) ? keyAxis->axisRect()->width()
+                                                                       : keyAxis->axisRect()->height();
+        if (keyAxis->range() != it->range || columns != it->columns)
+            push(graph, it.value());
+    }
+}
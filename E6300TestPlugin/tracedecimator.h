@@ -0,0 +1,60 @@
+#ifndef TRACEDECIMATOR_H
+#define TRACEDECIMATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include "include/qcustomplot.h"
+
+// Keeps the full-resolution data of every graph it is handed and gives
+// QCustomPlot only a min/max pair per pixel column of the visible key range.
+// Drawing cost then follows the plot width rather than the trace length,
+// while narrow spurs survive because each column keeps its extremes.
+//
+// Each graph's QCPGraphDataContainer is reused across updates: when the point
+// count is unchanged the points are overwritten in place, so a running sweep
+// neither reallocates nor re-sorts.
+//
+// Re-decimation is lazy: it happens during the next replot's layout pass,
+// and only for graphs whose key range or pixel width changed since the last
+// time they were reduced.
+class TraceDecimator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TraceDecimator(QCustomPlot *plot, QObject *parent = nullptr);
+
+    // Keys must be ascending for decimation to apply; anything else is
+    // passed through unchanged.
+    void setGraphData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values);
+    void clearGraphData(QCPGraph *graph);
+
+    // Reduce keys/values in [lower, upper] to at most two points per column.
+    // One point on each side of the range is kept so lines run off the edge
+    // of the plot instead of stopping short.
+    static void decimateMinMax(const QVector<double> &keys, const QVector<double> &values,
+                               double lower, double upper, int columns,
+                               QVector<double> &outKeys, QVector<double> &outValues);
+
+private slots:
+    void onAfterLayout();
+
+private:
+    struct Source {
+        QVector<double> keys;    // implicitly shared with the widget's trace store
+        QVector<double> values;
+        QVector<double> plotKeys;   // reduced output, capacity kept between updates
+        QVector<double> plotValues;
+        QCPRange range;          // key range the current graph data was reduced for
+        int columns = -1;        // pixel width the current graph data was reduced for
+    };
+
+    void push(QCPGraph *graph, Source &src);
+    static void assignSorted(QCPGraphDataContainer *container,
+                             const QVector<double> &keys, const QVector<double> &values);
+
+    QCustomPlot *m_plot;
+    QHash<QCPGraph*, Source> m_sources;
+};
+
+#endif // TRACEDECIMATOR_H
@@ -0,0 +1,380 @@
+/*---------------------------------------------------------------------------
+ * rfmu2cli – headless front end to the RFMU2 protocol layer.
+ *
+ *   rfmu2cli [--host H] [--port P] <command> [args] [-o file]
+ *
+ *   voltages                               8 supply voltages + temperature
+ *   clock internal|external                reference clock
+ *   sg <freqKHz> <dBm> <port>              single-channel output
+ *   sg-off                                 all outputs off
+ *   sa-peak <freqKHz> <dBm> <port>         peak measurement   [--receive N]
+ *   sa-raw  <freqKHz> <dBm> <port>         raw FFT bins       [--receive N]
+ *   na <startKHz> <stopKHz> <points> <port1> [port2]
+ *                                          configure + one sweep
+ *                                          [--type T] [--dual] [--level-db a:b]
+ *   run <plan.json>                        test plan, results as JSON lines
+ *
+ * Measurements go to stdout (one value per line), or with -o to a .csv or
+ * .rtr file. --trace file.json records the protocol spans of the command as
+ * a Chrome trace. Exit status: 0 ok / all passed, 1 instrument or plan failure,
+ * 2 usage error, 3 not connected.
+ *---------------------------------------------------------------------------*/
+#include "rfmu2tool.h"
+#include "rfmu2sequencer.h"
+#include "rfmu2trace.h"
+#include "rfmu2tracefile.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <cstdio>
+
+namespace {
+
+enum ExitCode { ExitOk = 0, ExitFailed = 1, ExitUsage = 2, ExitNoLink = 3 };
+
+void report(const QString &message)
+{
+    std::fprintf(stderr, "rfmu2cli: %s\n", qPrintable(message));
+}
+
+int usage(const QCommandLineParser &parser, const QString &message)
+{
+    report(message);
+    std::fprintf(stderr, "\n%s", qPrintable(parser.helpText()));
+    return ExitUsage;
+}
+
+bool toInt(const QString &text, int *value)
+{
+    bool ok = false;
+    *value = text.toInt(&ok);
+    return ok;
+}
+
+bool toDouble(const QString &text, double *value)
+{
+    bool ok = false;
+    *value = text.toDouble(&ok);
+    return ok;
+}
+
+// One column per trace; "x" is the point index unless an axis is given
+bool writeTraces(const QString &path, const QStringList &names,
+                 const QVector<QVector<double>> &traces, const QVector<double> &axis = {})
+{
+    if (path.endsWith(Rfmu2TraceFile::fileSuffix(), Qt::CaseInsensitive)) {
+        Rfmu2TraceFile::Contents contents;
+        contents.timestampMs = QDateTime::currentMSecsSinceEpoch();
+        contents.config = QCoreApplication::arguments().mid(1).join(' ').toUtf8();
+        if (!axis.isEmpty())
+            contents.columns.append({ QStringLiteral("freq"), QStringLiteral("kHz"),
+                                      Rfmu2TraceFile::SampleType::Float64, axis });
+        for (int i = 0; i < traces.size(); ++i)
+            contents.columns.append({ names.value(i), QString(),
+                                      Rfmu2TraceFile::SampleType::Float64, traces[i] });
+
+        QString error;
+        if (!Rfmu2TraceFile::write(path, contents, Rfmu2TraceFile::Encoding::DeltaPacked, &error)) {
+            report(error);
+            return false;
+        }
+        return true;
+    }
+
+    QFile file;
+    if (path.isEmpty() || path == QLatin1String("-")) {
+        file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    } else {
+        file.setFileName(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            report(path + QStringLiteral(": ") + file.errorString());
+            return false;
+        }
+    }
+
+    QTextStream out(&file);
+    const bool csv = !path.isEmpty() && path != QLatin1String("-");
+    if (csv) {
+        out << (axis.isEmpty() ? "point" : "freq_khz");
+        for (int i = 0; i < traces.size(); ++i)
+            out << ',' << names.value(i);
+        out << '\n';
+    }
+
+    int rows = 0;
+    for (const QVector<double> &t : traces)
+        rows = qMax(rows, int(t.size()));
+    for (int r = 0; r < rows; ++r) {
+        if (csv || !axis.isEmpty())
+            out << (axis.isEmpty() ? QString::number(r) : QString::number(axis.value(r), 'g', 12)) << ',';
+        for (int i = 0; i < traces.size(); ++i) {
+            if (i > 0) out << ',';
+            if (r < traces[i].size())
+                out << QString::number(traces[i][r], 'g', 10);
+        }
+        out << '\n';
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+Rfmu2NetworkAnalyzer::ResultType parseType(const QString &name, bool *ok)
+{
+    using RT = Rfmu2NetworkAnalyzer::ResultType;
+    *ok = true;
+    if (name.compare(QLatin1String("Complex"), Qt::CaseInsensitive) == 0)     return RT::Complex;
+    if (name.compare(QLatin1String("LogAmp"), Qt::CaseInsensitive) == 0)      return RT::LogAmp;
+    if (name.compare(QLatin1String("Phase"), Qt::CaseInsensitive) == 0)       return RT::Phase;
+    if (name.compare(QLatin1String("LogAmpPhase"), Qt::CaseInsensitive) == 0) return RT::LogAmpPhase;
+    *ok = false;
+    return RT::LogAmp;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("rfmu2cli"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Headless RFMU2 measurement tool"));
+    parser.addHelpOption();
+
+    const QCommandLineOption hostOpt   ({ "H", "host" },  "Instrument address.", "address", "192.168.137.11");
+    const QCommandLineOption portOpt   ({ "p", "port" },  "TCP port.", "port", "7");
+    const QCommandLineOption outOpt    ({ "o", "output" }, "Output file (.csv, .rtr; .jsonl for run).", "file");
+    const QCommandLineOption recvOpt   ("receive", "SA receive channel (1-4).", "n", "1");
+    const QCommandLineOption typeOpt   ("type", "NA result: Complex, LogAmp, Phase, LogAmpPhase.", "type", "LogAmp");
+    const QCommandLineOption dualOpt   ("dual", "Dual-port NA measurement.");
+    const QCommandLineOption levelOpt  ("level-db", "NA power sweep start:stop in dB.", "a:b", "0:0");
+    const QCommandLineOption timeoutOpt("timeout", "Receive timeout ceiling in ms.", "ms");
+    const QCommandLineOption traceOpt  ("trace", "Write a Chrome trace of the command.", "file");
+    parser.addOptions({ hostOpt, portOpt, outOpt, recvOpt, typeOpt, dualOpt, levelOpt, timeoutOpt, traceOpt });
+    parser.addPositionalArgument("command", "voltages | clock | sg | sg-off | sa-peak | sa-raw | na | run");
+    parser.addPositionalArgument("args", "Command arguments.", "[args...]");
+    parser.process(app);
+
+    const QStringList pos = parser.positionalArguments();
+    if (pos.isEmpty())
+        return usage(parser, QStringLiteral("no command given"));
+    const QString cmd = pos.first();
+    const QStringList args = pos.mid(1);
+    const QString output = parser.value(outOpt);
+
+    int tcpPort = 0;
+    if (!toInt(parser.value(portOpt), &tcpPort))
+        return usage(parser, QStringLiteral("invalid --port"));
+
+    // ---------------- validate the whole command line ----------------
+    // Before connecting: a typo must not wait out the connect timeout.
+    const QStringList commands = { "voltages", "clock", "sg", "sg-off", "sa-peak", "sa-raw", "na", "run" };
+    if (!commands.contains(cmd))
+        return usage(parser, QStringLiteral("unknown command '%1'").arg(cmd));
+
+    int timeoutMs = 0;
+    if (parser.isSet(timeoutOpt) && (!toInt(parser.value(timeoutOpt), &timeoutMs) || timeoutMs <= 0))
+        return usage(parser, QStringLiteral("invalid --timeout"));
+
+    bool internalClock = false;                         // clock
+    int freqKHz = 0, receive = 1;                       // sg, sa-*
+    double level = 0.0;
+    QString rfPort;
+    Rfmu2NetworkAnalyzer::SweepConfig naConfig;         // na
+    auto naType = Rfmu2NetworkAnalyzer::ResultType::LogAmp;
+    const bool dual = parser.isSet(dualOpt);
+    Rfmu2TestPlan plan;                                 // run
+
+    if (cmd == QLatin1String("voltages") || cmd == QLatin1String("sg-off")) {
+        if (!args.isEmpty())
+            return usage(parser, QStringLiteral("%1 takes no arguments").arg(cmd));
+    } else if (cmd == QLatin1String("clock")) {
+        if (args.size() != 1 || (args[0] != QLatin1String("internal") && args[0] != QLatin1String("external")))
+            return usage(parser, QStringLiteral("clock internal|external"));
+        internalClock = args[0] == QLatin1String("internal");
+    } else if (cmd == QLatin1String("sg") || cmd == QLatin1String("sa-peak") || cmd == QLatin1String("sa-raw")) {
+        if (args.size() != 3 || !toInt(args[0], &freqKHz) || !toDouble(args[1], &level))
+            return usage(parser, cmd + QStringLiteral(" <freqKHz> <dBm> <port>"));
+        rfPort = args[2];
+        if (cmd != QLatin1String("sg") && !toInt(parser.value(recvOpt), &receive))
+            return usage(parser, QStringLiteral("invalid --receive"));
+    } else if (cmd == QLatin1String("na")) {
+        if (args.size() < 4 || args.size() > 5
+            || !toInt(args[0], &naConfig.startKHz) || !toInt(args[1], &naConfig.stopKHz)
+            || !toInt(args[2], &naConfig.points) || naConfig.points < 1)
+            return usage(parser, QStringLiteral("na <startKHz> <stopKHz> <points> <port1> [port2]"));
+        naConfig.port1 = args[3];
+        naConfig.port2 = args.value(4, naConfig.port1);
+
+        const QStringList levels = parser.value(levelOpt).split(':');
+        if (levels.size() != 2 || !toDouble(levels[0], &naConfig.startDb) || !toDouble(levels[1], &naConfig.stopDb))
+            return usage(parser, QStringLiteral("invalid --level-db"));
+
+        bool typeOk = false;
+        naType = parseType(parser.value(typeOpt), &typeOk);
+        if (!typeOk)
+            return usage(parser, QStringLiteral("invalid --type"));
+    } else if (cmd == QLatin1String("run")) {
+        if (args.size() != 1)
+            return usage(parser, QStringLiteral("run <plan.json> [-o results.jsonl]"));
+        QString error;
+        plan = Rfmu2TestPlan::fromFile(args[0], &error);
+        if (plan.steps.isEmpty()) {
+            report(args[0] + QStringLiteral(": ") + error);
+            return ExitUsage;
+        }
+    }
+
+    // ---------------- connect ----------------
+    Rfmu2Tool tool;
+    QObject::connect(&tool, &Rfmu2Tool::errorOccurred, [](const Rfmu2Error &e) {
+        report(e.text);
+    });
+    if (!tool.connectToHost(parser.value(hostOpt), tcpPort)) {
+        report(QStringLiteral("cannot connect to %1:%2").arg(parser.value(hostOpt)).arg(tcpPort));
+        return ExitNoLink;
+    }
+
+    if (timeoutMs > 0) {
+        tool.call([&tool, ms = timeoutMs]() {
+            tool.signalGenerator()->setTimeoutMs(ms);
+            tool.spectrumAnalyzer()->setTimeoutMs(ms);
+            tool.networkAnalyzer()->setTimeoutMs(ms);
+            tool.systemControl()->setTimeoutMs(ms);
+        });
+    }
+
+    const QString tracePath = parser.value(traceOpt);
+    if (!tracePath.isEmpty())
+        Rfmu2Trace::start();
+
+    auto finishWith = [&tool, &tracePath](int code) {
+        tool.disconnectFromHost();
+        if (!tracePath.isEmpty()) {
+            Rfmu2Trace::stop();
+            QString error;
+            if (!Rfmu2Trace::exportChromeJson(tracePath, &error))
+                report(QStringLiteral("cannot write %1: %2").arg(tracePath, error));
+        }
+        return code;
+    };
+
+    // ---------------- simple commands ----------------
+    if (cmd == QLatin1String("voltages")) {
+        const QVector<double> v = tool.call([sys = tool.systemControl()]() {
+            return sys->readVoltagesAndTemperature();
+        });
+        if (v.isEmpty())
+            return finishWith(ExitFailed);
+        QStringList names;
+        for (int i = 1; i < v.size(); ++i)
+            names.append(QStringLiteral("V%1").arg(i));
+        names.append(QStringLiteral("T"));
+        QVector<QVector<double>> cols;
+        for (double d : v) cols.append({ d });
+        return finishWith(writeTraces(output, names, cols) ? ExitOk : ExitFailed);
+    }
+
+    if (cmd == QLatin1String("clock")) {
+        const bool ok = tool.call([sys = tool.systemControl(), internalClock]() {
+            return sys->setReferenceClockMode(internalClock);
+        });
+        return finishWith(ok ? ExitOk : ExitFailed);
+    }
+
+    if (cmd == QLatin1String("sg-off")) {
+        const bool ok = tool.call([sg = tool.signalGenerator()]() { return sg->stopAllOutputs(); });
+        return finishWith(ok ? ExitOk : ExitFailed);
+    }
+
+    if (cmd == QLatin1String("sg")) {
+        const bool ok = tool.call([sg = tool.signalGenerator(), freqKHz, level, rfPort]() {
+            return sg->configureSingleChannel(freqKHz, level, rfPort);
+        });
+        return finishWith(ok ? ExitOk : ExitFailed);
+    }
+
+    if (cmd == QLatin1String("sa-peak") || cmd == QLatin1String("sa-raw")) {
+        const bool raw = cmd == QLatin1String("sa-raw");
+        const QVector<double> v = tool.call([sa = tool.spectrumAnalyzer(), raw, freqKHz, level, receive, rfPort]() {
+            return raw ? sa->measureRawData(freqKHz, level, receive, rfPort)
+                       : sa->measurePeakData(freqKHz, level, receive, rfPort);
+        });
+        if (v.isEmpty())
+            return finishWith(ExitFailed);
+        return finishWith(writeTraces(output, { rfPort }, { v }) ? ExitOk : ExitFailed);
+    }
+
+    // ---------------- network analyzer sweep ----------------
+    if (cmd == QLatin1String("na")) {
+        const Rfmu2NetworkAnalyzer::SweepConfig c = naConfig;
+        const auto type = naType;
+        const QVector<double> raw = tool.call([na = tool.networkAnalyzer(), c, type, dual]() {
+            if (!na->configureSweep(c))
+                return QVector<double>();
+            return dual ? na->measureDualPort(type) : na->measureSinglePort(type);
+        });
+        if (raw.isEmpty())
+            return finishWith(ExitFailed);
+
+        // The payload is point-major: every point carries the same number
+        // of words (1 or 2 per S-parameter); split it into one column each.
+        const int words = raw.size() / c.points;
+        if (words * c.points != raw.size()) {
+            report(QStringLiteral("%1 values do not divide into %2 points").arg(raw.size()).arg(c.points));
+            return finishWith(ExitFailed);
+        }
+        using RT = Rfmu2NetworkAnalyzer::ResultType;
+        const QStringList params = dual ? QStringList{ "S11", "S21", "S12", "S22" } : QStringList{ "S11" };
+        const QStringList parts  = type == RT::Complex     ? QStringList{ "re", "im" }
+                                 : type == RT::LogAmpPhase ? QStringList{ "db", "rad" }
+                                 : type == RT::Phase       ? QStringList{ "rad" }
+                                                           : QStringList{ "db" };
+        QVector<QVector<double>> cols(words, QVector<double>(c.points));
+        QStringList names;
+        for (int w = 0; w < words; ++w) {
+            names.append(words == params.size() * parts.size()
+                             ? params[w / parts.size()] + '.' + parts[w % parts.size()]
+                             : QStringLiteral("w%1").arg(w));
+            for (int i = 0; i < c.points; ++i)
+                cols[w][i] = raw[i * words + w];
+        }
+        QVector<double> axis(c.points);
+        const double step = c.points > 1 ? double(c.stopKHz - c.startKHz) / (c.points - 1) : 0.0;
+        for (int i = 0; i < c.points; ++i)
+            axis[i] = c.startKHz + i * step;
+
+        return finishWith(writeTraces(output, names, cols, axis) ? ExitOk : ExitFailed);
+    }
+
+    // ---------------- test plan (the only command left) ----------------
+    const QFileInfo info(args[0]);
+    const QString results = output.isEmpty()
+        ? info.path() + '/' + info.completeBaseName() + QStringLiteral("-results.jsonl")
+        : output;
+
+    Rfmu2Sequencer sequencer(&tool);
+    int code = ExitFailed;
+    QObject::connect(&sequencer, &Rfmu2Sequencer::finished, &app,
+                     [&code, results](const Rfmu2SequenceSummary &s) {
+        QString line = QStringLiteral("%1: %2 steps, %3 passed, %4 failed, %5 errors, %6 ms")
+                           .arg(s.plan).arg(s.steps).arg(s.passed).arg(s.failed)
+                           .arg(s.errors).arg(s.elapsedMs);
+        if (!s.error.isEmpty())
+            line += QStringLiteral(" (%1)").arg(s.error);
+        std::fprintf(stderr, "%s\nresults: %s\n", qPrintable(line), qPrintable(results));
+        code = s.allPassed() ? ExitOk : ExitFailed;
+        QCoreApplication::quit();
+    });
+
+    if (!sequencer.start(plan, results)) {
+        report(sequencer.errorString());
+        return finishWith(ExitFailed);
+    }
+    app.exec();
+    return finishWith(code);
+}
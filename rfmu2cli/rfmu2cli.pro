@@ -0,0 +1,28 @@
+# Headless command-line front end: QtCore and QtNetwork only, no widgets,
+# no QCustomPlot.
+
+QT = core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = rfmu2cli
+
+SOURCES += main.cpp
+
+RFMU2_DIR = $$PWD/../E6300TestPlugin/include/rfmu2
+INCLUDEPATH += $$RFMU2_DIR
+DEPENDPATH  += $$RFMU2_DIR
+
+# Link the library from the sibling build directory
+win32:CONFIG(release, debug|release): RFMU2_LIB_DIR = $$OUT_PWD/../rfmu2lib/release
+else:win32:CONFIG(debug, debug|release): RFMU2_LIB_DIR = $$OUT_PWD/../rfmu2lib/debug
+else: RFMU2_LIB_DIR = $$OUT_PWD/../rfmu2lib
+
+LIBS += -L$$RFMU2_LIB_DIR -lrfmu2
+win32-g++|unix: PRE_TARGETDEPS += $$RFMU2_LIB_DIR/librfmu2.a
+else: win32: PRE_TARGETDEPS += $$RFMU2_LIB_DIR/rfmu2.lib
+
+unix:!android: target.path = /opt/rfmu2/bin
+!isEmpty(target.path): INSTALLS += target
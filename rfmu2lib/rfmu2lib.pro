@@ -0,0 +1,16 @@
+# The protocol layer as a static library, for hosts that do not need the
+# GUI. (The classes carry no export macros, so a shared build would export
+# nothing on Windows.)
+
+QT = core network
+
+CONFIG += c++17
+
+TEMPLATE = lib
+TARGET = rfmu2
+CONFIG += staticlib
+
+include(../E6300TestPlugin/include/rfmu2/rfmu2.pri)
+
+unix:!android: target.path = /opt/rfmu2/lib
+!isEmpty(target.path): INSTALLS += target